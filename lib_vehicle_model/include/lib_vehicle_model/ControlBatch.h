@@ -0,0 +1,39 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstddef>
+
+namespace lib_vehicle_model {
+
+  /**
+   * @struct ControlBatch
+   * @brief A structure of arrays view over a batch of equal length control sequences
+   * 
+   * Sequence i occupies elements [i * horizon, (i + 1) * horizon) of the target arrays.
+   * Storing each field contiguously lets the whole batch be validated in a single branch-free pass
+   * which the compiler can vectorise. The batch does not own the arrays it points to.
+   * 
+   */
+  struct ControlBatch
+  {
+    const double* target_velocities = nullptr;        // sequence_count * horizon target velocities in m/s
+    const double* target_steering_angles = nullptr;   // sequence_count * horizon target steering angles in rad
+    const double* initial_steering_angles = nullptr;  // One steering angle per sequence used to compute the steering rate of its first control
+    size_t sequence_count = 0;                        // The number of control sequences in the batch
+    size_t horizon = 0;                               // The number of controls in each sequence
+  };
+}
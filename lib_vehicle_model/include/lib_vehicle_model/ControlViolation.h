@@ -0,0 +1,83 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <iostream>
+
+namespace lib_vehicle_model {
+
+  /**
+   * @enum ControlViolation
+   * @brief Bit flags identifying the limits violated by a single control input
+   * 
+   * A control input may violate several limits at once so flags are combined with | and tested with hasViolation()
+   * 
+   */
+  enum class ControlViolation : uint8_t
+  {
+    NONE = 0,
+    VELOCITY_BELOW_MIN = 1 << 0,      // target_velocity is below the min_forward_speed parameter
+    VELOCITY_ABOVE_MAX = 1 << 1,      // target_velocity is above the max_forward_speed parameter
+    STEERING_BELOW_MIN = 1 << 2,      // target_steering_angle is below the min_steering_angle parameter
+    STEERING_ABOVE_MAX = 1 << 3,      // target_steering_angle is above the max_steering_angle parameter
+    STEERING_RATE_ABOVE_MAX = 1 << 4  // The change in steering angle from the previous input exceeds the max_steering_angle_rate parameter
+  };
+
+  inline ControlViolation operator|(ControlViolation lhs, ControlViolation rhs) {
+    return static_cast<ControlViolation>(static_cast<uint8_t>(lhs) | static_cast<uint8_t>(rhs));
+  }
+
+  inline ControlViolation operator&(ControlViolation lhs, ControlViolation rhs) {
+    return static_cast<ControlViolation>(static_cast<uint8_t>(lhs) & static_cast<uint8_t>(rhs));
+  }
+
+  inline ControlViolation& operator|=(ControlViolation& lhs, ControlViolation rhs) {
+    lhs = lhs | rhs;
+    return lhs;
+  }
+
+  /**
+   * @brief Returns true if any of the flags in violation are set in mask
+   */
+  inline bool hasViolation(ControlViolation mask, ControlViolation violation) {
+    return (mask & violation) != ControlViolation::NONE;
+  }
+
+  /**
+   * @struct ControlViolationReport
+   * @brief The result of checking a sequence of control inputs against the vehicle limits
+   * 
+   * The per control masks are only written when a violation is found so checking valid inputs does not allocate memory.
+   * Reusing a report between checks also avoids allocation for invalid inputs once its capacity is large enough.
+   * 
+   */
+  struct ControlViolationReport
+  {
+    std::vector<ControlViolation> violations;       // One mask per control input. Empty if every control input was valid
+    size_t violation_count = 0;                     // The number of control inputs which violated at least one limit
+    size_t first_violation = 0;                     // The index of the first invalid control input. Only set if violation_count > 0
+    ControlViolation combined = ControlViolation::NONE; // The union of all the per control masks
+  };
+
+  /**
+   * Overload of << operation so masks will output as | separated flag names in print functions
+   * 
+   */ 
+  std::ostream& operator<<( std::ostream& os, const ControlViolation& violation );
+}
@@ -0,0 +1,160 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <vector>
+#include <memory>
+#include <limits>
+#include <cstddef>
+#include <stdexcept>
+#include "VehicleState.h"
+#include "VehicleControlInput.h"
+#include "ParameterServer.h"
+
+namespace lib_vehicle_model {
+  /**
+   * @struct FeasibilityGoal
+   * @brief A requirement on the motion of the vehicle at a point in time
+   * 
+   * Distances are measured along the path travelled from the initial state.
+   * Unset fields default to values which do not constrain the motion.
+   */
+  struct FeasibilityGoal
+  {
+    double time = 0;                                                  // Time of the goal relative to the initial state in s
+    double min_distance = 0;                                          // Distance which must have been travelled by time in m
+    double max_distance = std::numeric_limits<double>::infinity();    // Distance which must not have been exceeded at time in m
+    double min_speed = -std::numeric_limits<double>::infinity();      // Lowest acceptable speed at time in m/s
+    double max_speed = std::numeric_limits<double>::infinity();       // Highest acceptable speed at time in m/s
+    double min_heading_change = 0;                                    // Magnitude of the change in heading required by time in rad
+  };
+
+  /**
+   * @struct FeasibilityBounds
+   * @brief Bounds on the motion of the vehicle under a control sequence
+   * 
+   * Each list holds one entry per control input boundary. Index 0 is the initial state and index i is the end of control input i - 1.
+   */
+  struct FeasibilityBounds
+  {
+    std::vector<double> min_speed;          // m/s
+    std::vector<double> max_speed;          // m/s
+    std::vector<double> min_distance;       // m
+    std::vector<double> max_distance;       // m
+    std::vector<double> max_heading_change; // Upper bound on the magnitude of the change in heading in rad
+  };
+
+  /**
+   * @class FeasibilityFilter
+   * @brief Rejects candidate control sequences which provably cannot meet a set of goals before they are integrated
+   * 
+   * The speed of the vehicle is assumed to move toward each velocity command without overshooting it
+   * and with an acceleration no greater than the acceleration_limit and deceleration_limit parameters.
+   * From this, upper and lower speed envelopes are propagated over the control sequence and the distance travelled under each
+   * is computed with the KinematicsSolver. If the length_to_f and length_to_r parameters are set the heading change is
+   * bounded using the kinematic bicycle relation yaw_rate <= speed * tan(|steering_angle|) / wheel_base.
+   * 
+   * A candidate is only rejected if a goal lies outside these bounds, so candidates which pass must still be integrated
+   * to confirm they meet their goals. Sequences with negative initial speeds or velocity commands are never rejected.
+   * 
+   * NOTE: The bounds are only sound for models whose speed response respects these assumptions, such as the passenger car
+   * kinematic model which limits its acceleration with the same parameters. Models which do not read the acceleration limits,
+   * such as the passenger car dynamic model, may reach speeds and distances outside the envelope, so the filter can reject
+   * candidates which they would satisfy.
+   * 
+   */
+  class FeasibilityFilter
+  {
+    private:
+      double acceleration_limit_;
+      double deceleration_limit_;
+      double wheel_base_ = std::numeric_limits<double>::infinity(); // Infinite if the heading can not be bounded
+
+    public:
+      /**
+       * @brief Constructor
+       * 
+       * @param parameter_server The parameter server to load the acceleration_limit, deceleration_limit and optional
+       *                         length_to_f and length_to_r parameters from
+       * 
+       * @throws std::invalid_argument If the acceleration limits could not be loaded or are not greater than 0
+       */
+      explicit FeasibilityFilter(std::shared_ptr<ParameterServer> parameter_server);
+
+      /**
+       * @brief Computes the bounds on the motion of the vehicle under a control sequence
+       * 
+       * @param initial_state The starting state of the vehicle
+       * @param control_inputs A list of control inputs seperated by the provided timestep
+       * @param timestep The time increment between control inputs. Unit: seconds
+       * @param bounds The bounds to populate
+       * 
+       * @return False if no bounds could be computed as the sequence includes negative speeds
+       * 
+       * @throws std::invalid_argument If timestep is not greater than 0
+       */
+      bool computeBounds(const VehicleState& initial_state, const std::vector<VehicleControlInput>& control_inputs,
+        double timestep, FeasibilityBounds& bounds) const;
+
+      /**
+       * @brief Returns false if a control sequence provably cannot meet every goal
+       * 
+       * @param initial_state The starting state of the vehicle
+       * @param control_inputs A list of control inputs seperated by the provided timestep
+       * @param timestep The time increment between control inputs. Unit: seconds
+       * @param goals The goals the motion must meet
+       * 
+       * @throws std::invalid_argument If timestep is not greater than 0 or a goal time is negative or beyond the end of the sequence
+       */
+      bool isFeasible(const VehicleState& initial_state, const std::vector<VehicleControlInput>& control_inputs,
+        double timestep, const std::vector<FeasibilityGoal>& goals) const;
+
+      /**
+       * @brief Returns the indices of the candidate control sequences which may meet every goal
+       * 
+       * @param initial_state The starting state of the vehicle
+       * @param candidates The candidate control sequences seperated by the provided timestep
+       * @param timestep The time increment between control inputs. Unit: seconds
+       * @param goals The goals the motion must meet
+       * 
+       * @throws std::invalid_argument If timestep is not greater than 0 or a goal time is negative or beyond the end of a candidate
+       */
+      std::vector<size_t> filter(const VehicleState& initial_state, const std::vector<std::vector<VehicleControlInput>>& candidates,
+        double timestep, const std::vector<FeasibilityGoal>& goals) const;
+
+      /**
+       * @brief Predicts the motion of a control sequence with lib_vehicle_model::predict() unless it is rejected by isFeasible()
+       * 
+       * @param initial_state The starting state of the vehicle
+       * @param control_inputs A list of control inputs seperated by the provided timestep
+       * @param timestep The time increment between control inputs. Unit: seconds
+       * @param goals The goals the motion must meet
+       * @param states Populated with the predicted states if the sequence was not rejected
+       * 
+       * @return False if the sequence was rejected without being integrated
+       * 
+       * @throws ModelAccessException If no model has been loaded with lib_vehicle_model::init()
+       * @throws std::invalid_argument If the inputs are invalid for isFeasible() or lib_vehicle_model::predict()
+       */
+      bool predictIfFeasible(const VehicleState& initial_state, const std::vector<VehicleControlInput>& control_inputs,
+        double timestep, const std::vector<FeasibilityGoal>& goals, std::vector<VehicleState>& states) const;
+
+      /**
+       * @brief Returns true if the length_to_f and length_to_r parameters were set so heading goals can be checked
+       */
+      bool boundsHeading() const;
+  };
+}
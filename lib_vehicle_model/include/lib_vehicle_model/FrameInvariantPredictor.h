@@ -0,0 +1,183 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <list>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include "VehicleState.h"
+#include "VehicleControlInput.h"
+#include "VehicleMotionModel.h"
+
+namespace lib_vehicle_model {
+  /**
+   * @struct SE2Transform
+   * @brief A rigid 2d transform used to move states between a vehicle's canonical local frame and the global frame
+   */
+  struct SE2Transform
+  {
+    /**
+     * The translation along the global x-axis in meters
+     */
+    double x = 0;
+
+    /**
+     * The translation along the global y-axis in meters
+     */
+    double y = 0;
+
+    /**
+     * The rotation in radians
+     */
+    double theta = 0;
+
+    /**
+     * @brief Returns the transform from the canonical frame of the provided state to the global frame
+     *
+     * The canonical frame has its origin at the state position and its x-axis along the state orientation.
+     */
+    static SE2Transform fromState(const VehicleState& state);
+
+    /**
+     * @brief Applies this transform in place to the pose of each provided state
+     *
+     * The rotation is evaluated once for the whole list. Body frame fields are unchanged.
+     *
+     * @param states The states to transform
+     * @param count The number of states
+     */
+    void apply(VehicleState* states, size_t count) const;
+  };
+
+  /**
+   * @class FrameInvariantPredictor
+   * @brief A stateful wrapper around a frame invariant VehicleMotionModel which integrates in the canonical local frame
+   *
+   * Each prediction moves the initial state to the canonical frame (origin, orientation 0), integrates it there
+   * and transforms the resulting states back to the global frame with a single SE2Transform.
+   * As the integration no longer depends on the global pose, results are stored in a least recently used cache keyed on the
+   * body frame state, the control inputs and the timestep. Vehicles or planning cycles with the same body frame state and
+   * controls share a single integration no matter where they are on the map.
+   *
+   * NOTE: Cache keys compare exactly. Body frame states which differ only by rounding error are integrated separately.
+   *
+   * NOTE: This class is not thread safe. Each planning thread should own its own instance.
+   */
+  class FrameInvariantPredictor
+  {
+    private:
+      /**
+       * Inputs of a single prediction in the canonical frame
+       */
+      struct CacheKey {
+        std::vector<double> values;
+
+        bool operator==(const CacheKey& other) const {
+          return values == other.values;
+        }
+      };
+
+      struct CacheKeyHash {
+        size_t operator()(const CacheKey& key) const;
+      };
+
+      struct CacheEntry {
+        CacheKey key;
+        std::vector<VehicleState> states;
+      };
+
+      std::shared_ptr<VehicleMotionModel> model_;
+      size_t cache_capacity_;
+
+      // Most recently used entries are at the front
+      std::list<CacheEntry> entries_;
+      std::unordered_map<CacheKey, std::list<CacheEntry>::iterator, CacheKeyHash> index_;
+
+      uint64_t cache_hits_ = 0;
+      uint64_t cache_misses_ = 0;
+
+      /**
+       * @brief Helper function which builds the cache key for a prediction from the canonical initial state
+       */
+      static CacheKey buildKey(double mode, const VehicleState& canonical_state, const VehicleControlInput* control_inputs,
+        size_t count, double timestep, double delta_t);
+
+      /**
+       * @brief Helper function which returns the canonical trajectory for the key, calling integrate on a cache miss
+       */
+      template<typename IntegrateFunction>
+      std::vector<VehicleState> canonicalPredict(CacheKey&& key, IntegrateFunction integrate);
+
+    public:
+
+      /**
+       * @brief Constructor
+       *
+       * @param model The vehicle model used to integrate in the canonical frame. Must return true from isFrameInvariant()
+       * @param cache_capacity The maximum number of canonical trajectories kept. A value of 0 disables caching
+       *
+       * @throws std::invalid_argument If the model is null or is not frame invariant
+       */
+      FrameInvariantPredictor(std::shared_ptr<VehicleMotionModel> model, size_t cache_capacity);
+
+      /**
+       * @brief Predict vehicle motion assuming no change in control input
+       *
+       * @param initial_state The starting state of the vehicle
+       * @param timestep The time increment between returned traversed states. Unit: seconds
+       * @param delta_t The time to project the motion forward for. Unit: seconds
+       *
+       * @return A list of traversed states seperated by the timestep excluding the initial state
+       */
+      std::vector<VehicleState> predict(const VehicleState& initial_state, double timestep, double delta_t);
+
+      /**
+       * @brief Predict vehicle motion given a starting state and list of control inputs
+       *
+       * @param initial_state The starting state of the vehicle
+       * @param control_inputs A list of control inputs seperated by the provided timestep
+       * @param timestep The time increment between returned traversed states and provided control inputs. Unit: seconds
+       *
+       * @return A list of traversed states seperated by the timestep excluding the initial state
+       */
+      std::vector<VehicleState> predict(const VehicleState& initial_state,
+        const std::vector<VehicleControlInput>& control_inputs, double timestep);
+
+      /**
+       * @brief Discard all cached trajectories. The hit and miss counts are kept
+       */
+      void clearCache();
+
+      /**
+       * @brief Returns the number of cached trajectories
+       */
+      size_t getCacheSize() const;
+
+      /**
+       * @brief Returns the number of predictions which were served from the cache
+       */
+      uint64_t getCacheHits() const;
+
+      /**
+       * @brief Returns the number of predictions which required an integration
+       */
+      uint64_t getCacheMisses() const;
+  };
+}
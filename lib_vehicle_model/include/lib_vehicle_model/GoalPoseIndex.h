@@ -0,0 +1,186 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include "VehicleState.h"
+#include "VehicleControlInput.h"
+#include "MotionPrimitiveLibrary.h"
+
+namespace lib_vehicle_model {
+  /**
+   * @struct GoalPoseMatch
+   * @brief A control sequence found by a GoalPoseIndex query
+   */
+  struct GoalPoseMatch
+  {
+    /**
+     * The grid indices of the matched motion primitive. See MotionPrimitiveGrid
+     */
+    size_t speed_index = 0;
+    size_t steering_index = 0;
+    size_t sequence_index = 0;
+
+    /**
+     * The state reached at the end of the control sequence in the global frame
+     */
+    VehicleState end_state;
+
+    /**
+     * The weighted distance between the end state and the goal
+     */
+    double distance = 0;
+  };
+
+  /**
+   * @class GoalPoseIndex
+   * @brief Spatial index answering which control sequence of a MotionPrimitiveLibrary brings the vehicle closest to a goal pose
+   *
+   * The end states of the primitives are stored in one k-d tree per initial speed and steering angle of the grid.
+   * Each tree is keyed on the body frame end position, end orientation and end speed so a query is answered in
+   * logarithmic time instead of rolling out every candidate.
+   *
+   * The distance between an end state and a goal is the euclidean distance of the points
+   * (x, y, orientation_weight * cos(theta), orientation_weight * sin(theta), speed_weight * v).
+   *
+   * Queries can optionally refine the result by rolling out the nearest candidates from the exact initial state with
+   * lib_vehicle_model::predict, which accounts for the initial state not lying exactly on the grid.
+   *
+   * NOTE: Concurrent queries are safe. Refined queries use the per thread model instances of lib_vehicle_model.
+   */
+  class GoalPoseIndex
+  {
+    private:
+      static const size_t DIMENSIONS = 5;
+      typedef std::array<double, DIMENSIONS> Point;
+
+      struct Entry {
+        Point point;
+        size_t sequence_index;
+        VehicleState end_state; // Canonical frame
+      };
+
+      // Entries of each initial condition ordered as an implicit balanced k-d tree
+      // The node of the range [lo, hi) is at (lo + hi) / 2 and splits on dimension depth % DIMENSIONS
+      std::vector<std::vector<Entry>> trees_;
+
+      MotionPrimitiveGrid grid_;
+      double orientation_weight_;
+      double speed_weight_;
+      uint64_t generation_ = 0;
+      bool built_ = false;
+
+      /**
+       * @brief Helper function which returns the index point of a state in the canonical frame
+       */
+      Point toPoint(const VehicleState& state) const;
+
+      /**
+       * @brief Helper function which orders the entries in the range [lo, hi) as a k-d tree
+       */
+      static void buildTree(std::vector<Entry>& entries, size_t lo, size_t hi, size_t depth);
+
+      /**
+       * @brief Helper function which collects the k nearest entries of a tree to the query point
+       *
+       * @param nearest A max heap of (squared distance, entry index) pairs holding at most k elements
+       */
+      static void searchTree(const std::vector<Entry>& entries, size_t lo, size_t hi, size_t depth, const Point& query,
+        size_t k, std::vector<std::pair<double, size_t>>& nearest);
+
+      /**
+       * @brief Helper function which returns the goal in the body frame of the initial state
+       */
+      static VehicleState toBodyFrame(const VehicleState& initial_state, const VehicleState& goal);
+
+      /**
+       * @brief Helper function which returns the weighted distance between two states in the same frame
+       */
+      double distance(const VehicleState& a, const VehicleState& b) const;
+
+    public:
+
+      /**
+       * @brief Constructor
+       *
+       * @param orientation_weight The distance in meters equivalent to 1 unit of chord length between orientations
+       * @param speed_weight The distance in meters equivalent to a speed difference of 1 m/s
+       *
+       * @throws std::invalid_argument If a weight is negative
+       */
+      GoalPoseIndex(double orientation_weight = 1.0, double speed_weight = 1.0);
+
+      /**
+       * @brief Builds the index from the end states of every primitive in the provided library
+       *
+       * @param library A built library which is not stale
+       *
+       * @throws std::invalid_argument If the library is not built or is stale
+       */
+      void build(const MotionPrimitiveLibrary& library);
+
+      /**
+       * @brief Returns the control sequences whose end states are nearest to the goal
+       *
+       * The primitives of the grid speed and steering angle nearest to the initial state are searched.
+       *
+       * @param initial_state The current state of the vehicle
+       * @param goal The target state in the global frame. The position, orientation and longitudinal velocity are used
+       * @param k The maximum number of matches to return
+       *
+       * @return Up to k matches sorted by increasing distance
+       *
+       * @throws std::invalid_argument If the index has not been built or is stale
+       */
+      std::vector<GoalPoseMatch> findNearest(const VehicleState& initial_state, const VehicleState& goal, size_t k) const;
+
+      /**
+       * @brief Returns the control sequence whose end state is nearest to the goal
+       *
+       * @param initial_state The current state of the vehicle
+       * @param goal The target state in the global frame. The position, orientation and longitudinal velocity are used
+       * @param refine_candidates If greater than 0 this many nearest candidates are rolled out from the initial state with
+       *        lib_vehicle_model::predict and the closest resulting end state is returned
+       *
+       * @return The closest match. If no refinement rollout returns a state the nearest unrefined match is returned
+       *
+       * @throws std::invalid_argument If the index has not been built, is stale or a refinement rollout is rejected
+       * @throws ModelAccessException If refinement is requested while no model is loaded
+       */
+      GoalPoseMatch findControls(const VehicleState& initial_state, const VehicleState& goal, size_t refine_candidates = 0) const;
+
+      /**
+       * @brief Returns the control sequence of a match
+       *
+       * @throws std::invalid_argument If the sequence index is out of range
+       */
+      const std::vector<VehicleControlInput>& getControls(const GoalPoseMatch& match) const;
+
+      /**
+       * @brief Returns true if the index holds primitives
+       */
+      bool isBuilt() const;
+
+      /**
+       * @brief Returns true if a different model or parameter set has been loaded since the index was built
+       */
+      bool isStale() const;
+  };
+}
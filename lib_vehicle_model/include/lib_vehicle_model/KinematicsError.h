@@ -0,0 +1,65 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <cstdint>
+#include <iostream>
+
+namespace lib_vehicle_model {
+
+  /**
+   * @enum KinematicsError
+   * @brief Bit flags identifying why the KinematicsSolver could not solve an equation
+   * 
+   * The inputs of a single equation may be invalid for several reasons at once so flags are combined with | and tested with hasError()
+   * 
+   */
+  enum class KinematicsError : uint8_t
+  {
+    NONE = 0,
+    NEGATIVE_INPUT = 1 << 0,         // An input other than ACCELERATION is negative
+    DISCONTINUITY = 1 << 1,          // The term under a square root is negative so no real solution exists
+    SIGN_MISMATCH = 1 << 2,          // The sign of ACCELERATION does not match the provided change in velocity
+    UNSUPPORTED_COMBINATION = 1 << 3 // The output and unavailable properties do not select an equation
+  };
+
+  inline KinematicsError operator|(KinematicsError lhs, KinematicsError rhs) {
+    return static_cast<KinematicsError>(static_cast<uint8_t>(lhs) | static_cast<uint8_t>(rhs));
+  }
+
+  inline KinematicsError operator&(KinematicsError lhs, KinematicsError rhs) {
+    return static_cast<KinematicsError>(static_cast<uint8_t>(lhs) & static_cast<uint8_t>(rhs));
+  }
+
+  inline KinematicsError& operator|=(KinematicsError& lhs, KinematicsError rhs) {
+    lhs = lhs | rhs;
+    return lhs;
+  }
+
+  /**
+   * @brief Returns true if any of the flags in error are set in mask
+   */
+  inline bool hasError(KinematicsError mask, KinematicsError error) {
+    return (mask & error) != KinematicsError::NONE;
+  }
+
+  /**
+   * Overload of << operation so masks will output as | separated flag names in print functions
+   * 
+   */ 
+  std::ostream& operator<<( std::ostream& os, const KinematicsError& error );
+}
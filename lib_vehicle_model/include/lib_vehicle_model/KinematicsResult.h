@@ -0,0 +1,41 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <limits>
+#include "KinematicsError.h"
+
+namespace lib_vehicle_model {
+
+  /**
+   * @struct KinematicsResult
+   * @brief The value or error returned by the non-throwing KinematicsSolver::trySolve functions
+   * 
+   */
+  struct KinematicsResult
+  {
+    double value = std::numeric_limits<double>::quiet_NaN(); // The solved property. NaN unless ok() is true
+    KinematicsError error = KinematicsError::NONE;            // The reasons the equation could not be solved
+
+    /**
+     * @brief Returns true if the equation was solved and value is valid
+     */
+    bool ok() const {
+      return error == KinematicsError::NONE;
+    }
+  };
+}
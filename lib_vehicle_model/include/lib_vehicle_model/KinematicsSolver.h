@@ -16,8 +16,12 @@
  */
 
 #include <stdexcept>
+#include <cstddef>
+#include <vector>
 #include <math.h>
 #include "KinematicsProperty.h"
+#include "KinematicsError.h"
+#include "KinematicsResult.h"
 
 namespace lib_vehicle_model {
   /**
@@ -58,5 +62,132 @@ namespace lib_vehicle_model {
       * 
       */ 
     double solve(const KinematicsProperty& output_prop, const KinematicsProperty& unavailable_prop, const double& prop1, const double& prop2, const double& prop3);
+
+    /**
+      * @brief Solves for the specified kinematics property with the equation selected at compile time
+      * 
+      * Equivalent to solve(Out, Unavailable, prop1, prop2, prop3) but compiles directly to the selected equation
+      * so it should be preferred when the properties are known in advance. Unsupported combinations fail to compile.
+      * 
+      * For example double distance = solve<KinematicsProperty::DISTANCE, KinematicsProperty::FINAL_VELOCITY>(initial_velocity, acceleration, time);
+      * 
+      * @tparam Out The property type which should be solved for
+      * @tparam Unavailable The property type which is not provided
+      * @tparam CheckRanges If false the inputs are not checked. Inputs outside the domain of the equation then produce
+      *                     meaningless results or NaN instead of an exception
+      * @param prop1 The first provided property
+      * @param prop2 The second provided property
+      * @param prop3 The third provided property
+      * 
+      * @throws std::domain_error if CheckRanges is true and any input other than ACCELERATION is negative
+      * @throws std::domain_error if CheckRanges is true and the sign of ACCELERATION does not match the provided change in velocity
+      * 
+      * @return The value of Out which was solved for
+      * 
+      */ 
+    template<KinematicsProperty Out, KinematicsProperty Unavailable, bool CheckRanges = true>
+    double solve(const double& prop1, const double& prop2, const double& prop3);
+
+    /**
+      * @brief Solves for the specified kinematics property without throwing
+      * 
+      * Behaves as solve(output_prop, unavailable_prop, prop1, prop2, prop3) except that domain errors and unsupported
+      * property combinations are returned as the error of the result instead of being thrown or asserted.
+      * This neither throws nor allocates so it is suited to callers where invalid inputs are routine.
+      * 
+      * @param output_prop The property type which should be solved for
+      * @param unavailable_prop The property type which is not provided
+      * @param prop1 The first provided property
+      * @param prop2 The second provided property
+      * @param prop3 The third provided property
+      * 
+      * @return The solved value or the KinematicsError flags describing why it could not be solved
+      * 
+      */ 
+    KinematicsResult trySolve(const KinematicsProperty& output_prop, const KinematicsProperty& unavailable_prop,
+      const double& prop1, const double& prop2, const double& prop3) noexcept;
+
+    /**
+      * @brief Solves for the specified kinematics property without throwing with the equation selected at compile time
+      * 
+      * @tparam Out The property type which should be solved for
+      * @tparam Unavailable The property type which is not provided
+      * @param prop1 The first provided property
+      * @param prop2 The second provided property
+      * @param prop3 The third provided property
+      * 
+      * @return The solved value or the KinematicsError flags describing why it could not be solved
+      * 
+      */ 
+    template<KinematicsProperty Out, KinematicsProperty Unavailable>
+    KinematicsResult trySolve(const double& prop1, const double& prop2, const double& prop3) noexcept;
+
+    /**
+      * @brief Solves for the specified kinematics property over arrays of inputs with the equation selected at compile time
+      * 
+      * Element i of results is solve<Out, Unavailable>(prop1[i], prop2[i], prop3[i]) except that domain errors are
+      * reported through errors[i] instead of an exception. Elements with an error have a NaN result.
+      * The loop has no branches so the compiler can vectorise it including the square roots and divisions.
+      * 
+      * NOTE: GCC only vectorises the square roots when the calling code is built with -fno-math-errno and -fno-trapping-math
+      * 
+      * @tparam Out The property type which should be solved for
+      * @tparam Unavailable The property type which is not provided
+      * @param prop1 Array of count values of the first provided property
+      * @param prop2 Array of count values of the second provided property
+      * @param prop3 Array of count values of the third provided property
+      * @param count The number of elements to solve
+      * @param results Array of count elements to write the results to. May be one of the input arrays
+      * @param errors Array of count elements to write the KinematicsError flags of each element to
+      * 
+      */ 
+    template<KinematicsProperty Out, KinematicsProperty Unavailable>
+    void solve(const double* prop1, const double* prop2, const double* prop3, size_t count,
+      double* results, KinematicsError* errors) noexcept;
+
+    /**
+      * @brief Solves for the specified kinematics property over arrays of inputs
+      * 
+      * Selects the equation once and then behaves as solve<Out, Unavailable>(prop1, prop2, prop3, count, results, errors).
+      * If output_prop and unavailable_prop do not select an equation every element has a NaN result and the
+      * UNSUPPORTED_COMBINATION error.
+      * 
+      * @param output_prop The property type which should be solved for
+      * @param unavailable_prop The property type which is not provided
+      * @param prop1 Array of count values of the first provided property
+      * @param prop2 Array of count values of the second provided property
+      * @param prop3 Array of count values of the third provided property
+      * @param count The number of elements to solve
+      * @param results Array of count elements to write the results to. May be one of the input arrays
+      * @param errors Array of count elements to write the KinematicsError flags of each element to
+      * 
+      */ 
+    void solve(const KinematicsProperty& output_prop, const KinematicsProperty& unavailable_prop,
+      const double* prop1, const double* prop2, const double* prop3, size_t count,
+      double* results, KinematicsError* errors) noexcept;
+
+    /**
+      * @brief Solves for the specified kinematics property over vectors of inputs
+      * 
+      * @param output_prop The property type which should be solved for
+      * @param unavailable_prop The property type which is not provided
+      * @param prop1 The values of the first provided property
+      * @param prop2 The values of the second provided property
+      * @param prop3 The values of the third provided property
+      * @param results Resized to the number of inputs and set to the result of each element
+      * @param errors Resized to the number of inputs and set to the KinematicsError flags of each element
+      * 
+      * @throws std::invalid_argument if the input vectors are not the same size
+      * 
+      * @return The number of elements solved without an error
+      * 
+      */ 
+    size_t solve(const KinematicsProperty& output_prop, const KinematicsProperty& unavailable_prop,
+      const std::vector<double>& prop1, const std::vector<double>& prop2, const std::vector<double>& prop3,
+      std::vector<double>& results, std::vector<KinematicsError>& errors);
   }
-}
\ No newline at end of file
+}
+
+// Template functions cannot be linked unless the implementation is provided
+// Therefore include implementation to allow for template functions
+#include "internal/KinematicsSolver.cpp"
@@ -20,8 +20,17 @@
 #include <ros/ros.h>
 #include "ModelAccessException.h"
 #include "VehicleState.h"
+#include "ReducedVehicleState.h"
 #include "VehicleMotionModel.h"
 #include "VehicleControlInput.h"
+#include "TimedControlInput.h"
+#include "TrajectoryRange.h"
+#include "PredictionStatistics.h"
+#include "PredictStatus.h"
+#include "ControlViolation.h"
+#include "ControlBatch.h"
+#include "ValidatedControls.h"
+#include "MemoryResource.h"
 #include "ParameterServer.h"
 #include "KinematicsSolver.h"
 #include "KinematicsProperty.h"
@@ -48,9 +57,19 @@ namespace lib_vehicle_model {
   /**
    * @brief Initialization function for class. Loads the library as specified by parameters 
    * 
+   * If the optional warm_up_horizons parameter (list of step counts) is set, synthetic predictions of each horizon
+   * are run through the loaded model before this function returns so the first real predictions do not pay for
+   * page faults, cold caches or lazy allocations. The optional warm_up_timestep (default 0.1 s) and
+   * warm_up_iterations (default 3) parameters control the synthetic predictions.
+   * 
+   * If the optional real_time_max_horizon parameter (number of steps) is set, predictRealTime() can be used for predictions
+   * of up to that many steps. If the optional real_time_lock_memory parameter is also true all current and future pages
+   * of the process are locked into memory with mlockall so real-time predictions cannot page fault.
+   * Memory is only locked once the model has loaded and warmed up, so a failed init leaves nothing locked.
+   * 
    * @param parameter_server A reference to the parameter server which vehicle models will use to load parameters
    * 
-   * @throws std::invalid_argument If the model could not be loaded or parameters could not be read
+   * @throws std::invalid_argument If the model could not be loaded, parameters could not be read or memory could not be locked
    * @throws ModelAccessException If this function is called more than once within the same process execution
    * 
    */ 
@@ -65,9 +84,113 @@ namespace lib_vehicle_model {
    */ 
   void unload();
 
+  /**
+   * @brief Returns the duration of the warm-up run by the last call to init() in seconds
+   * 
+   * @return The warm-up duration or 0 if warm-up was not enabled
+   * 
+   */ 
+  double getWarmUpDuration();
+
+  /**
+   * @brief Returns a counter which changes each time a model is loaded or unloaded
+   * 
+   * Results derived from the loaded model and its parameters, such as precomputed motion primitives, remain valid
+   * while this value is unchanged.
+   * 
+   */
+  uint64_t getParameterGeneration();
+
+  /**
+   * @brief Returns true if the loaded model is frame invariant. See VehicleMotionModel::isFrameInvariant()
+   * 
+   * @throws ModelAccessException If this function is called before the init() function
+   * 
+   */
+  bool isFrameInvariant();
+
+  /**
+   * @brief Checks control inputs against the limits of the loaded model without throwing on invalid inputs
+   * 
+   * Every control input is checked against the same constraints as predict() and the violated limits of each are
+   * recorded in the report. No memory is allocated if every control input is valid.
+   * The initial state itself is not checked. Only its steering angle is used to compute the steering rate of the first input.
+   * 
+   * @param initial_state The starting state of the vehicle
+   * @param control_inputs A list of control inputs seperated by the provided timestep
+   * @param timestep The time increment between control inputs. Unit: seconds
+   * @param report The report to populate. Reusing a report between calls avoids reallocating its per control masks
+   * 
+   * @return True if the control inputs are valid. False if any control input is invalid or control_inputs is empty
+   * 
+   * @throws ModelAccessException If this function is called before the init() function
+   * 
+   */
+  bool checkControlInputs(const VehicleState& initial_state,
+    const std::vector<VehicleControlInput>& control_inputs, double timestep, ControlViolationReport& report);
+
+  /**
+   * @brief Projects control inputs onto the limits of the loaded model so they can be predicted without being rejected
+   * 
+   * Target velocities and steering angles are clamped to their limits and each steering angle is moved toward the
+   * previous sanitized steering angle until the steering rate limit is met. A call to predict() with the initial state and
+   * the returned control inputs will therefore pass validation.
+   * 
+   * @param initial_state The starting state of the vehicle
+   * @param control_inputs A list of control inputs seperated by the provided timestep
+   * @param timestep The time increment between control inputs. Unit: seconds
+   * @param report The report to populate with the limits each control input was clamped to
+   * 
+   * @return The sanitized control inputs
+   * 
+   * @throws ModelAccessException If this function is called before the init() function
+   * @throws std::invalid_argument If the initial state is invalid, control_inputs is empty or timestep is not greater than 0
+   * 
+   */
+  std::vector<VehicleControlInput> sanitizeControlInputs(const VehicleState& initial_state,
+    const std::vector<VehicleControlInput>& control_inputs, double timestep, ControlViolationReport& report);
+
+  /**
+   * @brief Checks a structure of arrays batch of control sequences against the limits of the loaded model
+   * 
+   * Each sequence is checked against the same constraints as predict() in a single branch-free pass which the compiler
+   * can vectorise, so large batches are checked at close to memory bandwidth. Only the union of the violations of each
+   * sequence is reported. Use checkControlInputs() to find which controls of a rejected sequence are invalid.
+   * 
+   * @param batch The batch of control sequences to check
+   * @param timestep The time increment between control inputs. Unit: seconds
+   * @param results An array of at least batch.sequence_count masks which will hold the violations of each sequence
+   * 
+   * @return The number of sequences in the batch which are valid
+   * 
+   * @throws ModelAccessException If this function is called before the init() function
+   * @throws std::invalid_argument If the batch is not empty and its horizon is 0 or any of its arrays or results is null
+   * 
+   */
+  size_t checkControlBatch(const ControlBatch& batch, double timestep, ControlViolation* results);
+
+  /**
+   * @brief Returns the usage statistics of the prediction functions of this namespace since the last reset
+   * 
+   * Statistics are always recorded. Each thread records into its own counters so recording is lock free.
+   * Calls made before a model is loaded are not recorded.
+   * 
+   */ 
+  PredictionStatistics getPredictionStatistics();
+
+  /**
+   * @brief Clears the recorded prediction statistics. The in flight count is not affected
+   * 
+   */ 
+  void resetPredictionStatistics();
+
   //
   // Functions matching the VehicleMotionModel interface
   //
+  // Each calling thread is given its own clone of the loaded model (see VehicleMotionModel::clone()) so concurrent
+  // predictions never share model state. Models which are stateless or which do not support cloning are shared by all threads.
+  // The clones are released by unload().
+  //
 
   /**
    * @brief Predict vehicle motion assuming no change in control input
@@ -104,4 +227,274 @@ namespace lib_vehicle_model {
    */
   std::vector<VehicleState> predict(const VehicleState& initial_state,
     const std::vector<VehicleControlInput>& control_inputs, double timestep);
-}
\ No newline at end of file
+
+  /**
+   * @brief Predict vehicle motion assuming no change in control input keeping only every output_stride state
+   * 
+   * @param initial_state The starting state of the vehicle
+   * @param timestep The integration time increment. Unit: seconds
+   * @param delta_t The time to project the motion forward for. Unit: seconds
+   * @param output_stride The number of integration steps between returned states. The final state is always returned
+   * 
+   * @return A list of traversed states seperated by output_stride * timestep excluding the initial state
+   * 
+   * @throws ModelAccessException If this function is called before the init() function
+   * @throws std::invalid_argument If the initial vehicle state is found to be invalid or output_stride is 0
+   * 
+   * NOTE: This function header must match a predict function found in the VehicleMotionModel interface
+   * 
+   */
+  std::vector<VehicleState> predict(const VehicleState& initial_state,
+    double timestep, double delta_t, size_t output_stride);
+
+  /**
+   * @brief Predict vehicle motion given a starting state and list of control inputs keeping only every output_stride state
+   * 
+   * @param initial_state The starting state of the vehicle
+   * @param control_inputs A list of control inputs seperated by the provided timestep 
+   * @param timestep The integration time increment and the spacing of the provided control inputs. Unit: seconds
+   * @param output_stride The number of integration steps between returned states. The final state is always returned
+   * 
+   * @return A list of traversed states seperated by output_stride * timestep excluding the initial state
+   * 
+   * @throws ModelAccessException If this function is called before the init() function
+   * @throws std::invalid_argument If the initial vehicle state or control inputs are found to be invalid or output_stride is 0
+   * 
+   * NOTE: This function header must match a predict function found in the VehicleMotionModel interface
+   * 
+   */
+  std::vector<VehicleState> predict(const VehicleState& initial_state,
+    const std::vector<VehicleControlInput>& control_inputs, double timestep, size_t output_stride);
+
+  /**
+   * @brief Predict vehicle motion given a starting state and a list of control change points
+   * 
+   * Each control input remains active from its time until the next change point, so sparse controller output such as
+   * 5 distinct commands over 8 s can be passed directly instead of being expanded to one control input per timestep.
+   * A change point takes effect at the first step starting at or after its time.
+   * Steps before the first change point use the previous commands stored in the initial state.
+   * Validation cost scales with the number of change points.
+   * 
+   * @param initial_state The starting state of the vehicle
+   * @param control_changes A list of control change points sorted by time. Times are relative to the initial state. Unit: seconds
+   * @param timestep The time increment between returned traversed states. Unit: seconds
+   * @param delta_t The time to project the motion forward for. Unit: seconds
+   * 
+   * @return A list of traversed states seperated by the timestep excluding the initial state
+   * 
+   * @throws ModelAccessException If this function is called before the init() function
+   * @throws std::invalid_argument If the initial vehicle state or change points are found to be invalid or timestep is larger than delta_t
+   * 
+   * NOTE: This function header must match a predict function found in the VehicleMotionModel interface
+   * 
+   */
+  std::vector<VehicleState> predict(const VehicleState& initial_state,
+    const std::vector<TimedControlInput>& control_changes, double timestep, double delta_t);
+
+  /**
+   * @brief Predict vehicle motion given a starting state and a list of control change points keeping only every output_stride state
+   * 
+   * Behaves like the change point predict function above but only every output_stride-th state and the final state are
+   * stored, so 5 commands over 8 s at a 0.1 s timestep and an output_stride of 10 return 8 states spaced 1 s apart.
+   * 
+   * @param initial_state The starting state of the vehicle
+   * @param control_changes A list of control change points sorted by time. Times are relative to the initial state. Unit: seconds
+   * @param timestep The integration time increment. Unit: seconds
+   * @param delta_t The time to project the motion forward for. Unit: seconds
+   * @param output_stride The number of integration steps between returned states. The final state is always returned
+   * 
+   * @return A list of traversed states seperated by output_stride * timestep excluding the initial state
+   * 
+   * @throws ModelAccessException If this function is called before the init() function
+   * @throws std::invalid_argument If the initial vehicle state or change points are found to be invalid, timestep is larger than delta_t or output_stride is 0
+   * 
+   * NOTE: This function header must match a predict function found in the VehicleMotionModel interface
+   * 
+   */
+  std::vector<VehicleState> predict(const VehicleState& initial_state,
+    const std::vector<TimedControlInput>& control_changes, double timestep, double delta_t, size_t output_stride);
+
+  /**
+   * @brief Validates a control sequence once so it can be predicted from several initial states without revalidation
+   * 
+   * Every check which does not depend on the initial state is applied. The steering rate of the first control input
+   * is checked against each initial state when the returned token is passed to predict().
+   * 
+   * @param control_inputs A list of control inputs seperated by the provided timestep
+   * @param timestep The time increment between traversed states and provided control inputs. Unit: seconds
+   * 
+   * @return A token holding a copy of the control inputs which remains valid until a model is loaded or unloaded
+   * 
+   * @throws ModelAccessException If this function is called before the init() function
+   * @throws std::invalid_argument If the control inputs are empty or found to be invalid
+   * 
+   */
+  ValidatedControls validateControls(const std::vector<VehicleControlInput>& control_inputs, double timestep);
+
+  /**
+   * @brief Predict vehicle motion given a starting state and a control sequence validated with validateControls()
+   * 
+   * Only the initial state and the steering rate between it and the first control input are validated.
+   * 
+   * @param initial_state The starting state of the vehicle
+   * @param controls The validated control inputs and their timestep
+   * 
+   * @return A list of traversed states seperated by the timestep excluding the initial state
+   * 
+   * @throws ModelAccessException If this function is called before the init() function
+   * @throws std::invalid_argument If the token is empty or stale, the initial vehicle state is invalid or
+   *         the steering rate of the first control input relative to the initial state is exceeded
+   * 
+   */
+  std::vector<VehicleState> predict(const VehicleState& initial_state, const ValidatedControls& controls);
+
+  /**
+   * @brief Predict vehicle motion assuming no change in control input allocating from the provided memory resource
+   * 
+   * The returned trajectory and the expanded control inputs are allocated from the resource.
+   * Models which are real-time safe integrate into the returned trajectory without any other per call allocation.
+   * Passing a MonotonicBufferResource per planning cycle allows all trajectories of the cycle to be freed in one step.
+   * 
+   * @param initial_state The starting state of the vehicle
+   * @param timestep The time increment between returned traversed states. Unit: seconds
+   * @param delta_t The time to project the motion forward for. Unit: seconds
+   * @param resource The resource to allocate from. Must outlive the returned trajectory
+   * 
+   * @return A list of traversed states seperated by the timestep excluding the initial state
+   * 
+   * @throws ModelAccessException If this function is called before the init() function
+   * @throws std::invalid_argument If the initial vehicle state is found to be invalid
+   * 
+   */
+  ResourceVector<VehicleState> predict(const VehicleState& initial_state,
+    double timestep, double delta_t, MemoryResource& resource);
+
+  /**
+   * @brief Predict vehicle motion given a starting state and list of control inputs allocating from the provided memory resource
+   * 
+   * The returned trajectory is allocated from the resource and the control inputs are not copied.
+   * Models which are real-time safe integrate into the returned trajectory without any other per call allocation.
+   * 
+   * @param initial_state The starting state of the vehicle
+   * @param control_inputs A list of control inputs seperated by the provided timestep 
+   * @param timestep The time increment between returned traversed states and provided control inputs. Unit: seconds
+   * @param resource The resource to allocate from. Must outlive the returned trajectory
+   * 
+   * @return A list of traversed states seperated by the timestep excluding the initial state
+   * 
+   * @throws ModelAccessException If this function is called before the init() function
+   * @throws std::invalid_argument If the initial vehicle state or control inputs are found to be invalid
+   * 
+   */
+  ResourceVector<VehicleState> predict(const VehicleState& initial_state,
+    const std::vector<VehicleControlInput>& control_inputs, double timestep, MemoryResource& resource);
+
+  /**
+   * @brief Predict vehicle motion assuming no change in control input returning only the reduced state
+   * 
+   * @param initial_state The starting state of the vehicle
+   * @param timestep The time increment between returned traversed states. Unit: seconds
+   * @param delta_t The time to project the motion forward for. Unit: seconds
+   * 
+   * @return A list of traversed reduced states seperated by the timestep excluding the initial state
+   * 
+   * @throws ModelAccessException If this function is called before the init() function
+   * @throws std::invalid_argument If the initial vehicle state is found to be invalid
+   * 
+   * NOTE: This function header must match a predictReduced function found in the VehicleMotionModel interface
+   * 
+   */
+  std::vector<ReducedVehicleState> predictReduced(const VehicleState& initial_state,
+    double timestep, double delta_t);
+
+  /**
+   * @brief Predict vehicle motion given a starting state and list of control inputs returning only the reduced state
+   * 
+   * @param initial_state The starting state of the vehicle
+   * @param control_inputs A list of control inputs seperated by the provided timestep 
+   * @param timestep The time increment between returned traversed states and provided control inputs. Unit: seconds
+   * 
+   * @return A list of traversed reduced states seperated by the timestep excluding the initial state
+   * 
+   * @throws ModelAccessException If this function is called before the init() function
+   * @throws std::invalid_argument If the initial vehicle state or control inputs are found to be invalid
+   * 
+   * NOTE: This function header must match a predictReduced function found in the VehicleMotionModel interface
+   * 
+   */
+  std::vector<ReducedVehicleState> predictReduced(const VehicleState& initial_state,
+    const std::vector<VehicleControlInput>& control_inputs, double timestep);
+
+  /**
+   * @brief Predict the vehicle state after a single timestep of the provided control input
+   * 
+   * @param initial_state The starting state of the vehicle
+   * @param control_input The control input applied over the timestep
+   * @param timestep The time increment to integrate over. Unit: seconds
+   * 
+   * @return The state of the vehicle after the timestep
+   * 
+   * @throws ModelAccessException If this function is called before the init() function
+   * @throws std::invalid_argument If the initial vehicle state or control input are found to be invalid
+   * 
+   * NOTE: This function header must match a predictStep function found in the VehicleMotionModel interface
+   * 
+   */
+  VehicleState predictStep(const VehicleState& initial_state,
+    const VehicleControlInput& control_input, double timestep);
+
+  /**
+   * @brief Lazily predict vehicle motion given a starting state and list of control inputs
+   * 
+   * The inputs are validated immediately but each traversed state is only computed by the loaded model
+   * when the returned range is iterated. Consumers which stop iterating early never integrate the rest of the horizon.
+   * 
+   * @param initial_state The starting state of the vehicle
+   * @param control_inputs A list of control inputs seperated by the provided timestep 
+   * @param timestep The time increment between traversed states and provided control inputs. Unit: seconds
+   * 
+   * @return A range over the traversed states seperated by the timestep excluding the initial state
+   * 
+   * @throws ModelAccessException If this function is called before the init() function.
+   *         Advancing the returned range also throws this exception if the model has since been unloaded
+   * @throws std::invalid_argument If the initial vehicle state or control inputs are found to be invalid
+   * 
+   */
+  TrajectoryRange predictLazy(const VehicleState& initial_state,
+    const std::vector<VehicleControlInput>& control_inputs, double timestep);
+
+  /**
+   * @brief Prepares the calling thread for calls to predictRealTime()
+   * 
+   * Creates this thread's instance of the loaded vehicle model, sizes its buffers for the configured real_time_max_horizon
+   * and registers the thread for statistics recording. Must be called by each thread before its first call to predictRealTime()
+   * and again after the model is reloaded. The thread which calls init() is prepared automatically.
+   * 
+   * @return True if the loaded vehicle model guarantees that its real-time predictions do not allocate memory, lock or throw.
+   *         If false, predictRealTime() still works but falls back to the model's regular prediction function
+   * 
+   * @throws ModelAccessException If this function is called before the init() function
+   * @throws std::invalid_argument If the real_time_max_horizon parameter was not set at init
+   * 
+   */
+  bool prepareRealTimeThread();
+
+  /**
+   * @brief Predict vehicle motion given a starting state and control inputs with bounded latency
+   * 
+   * Once the calling thread has been prepared with prepareRealTimeThread() this function does not allocate memory,
+   * take locks or throw, provided the loaded vehicle model is real-time safe. Errors are reported through the returned status.
+   * Inputs are validated against the same constraints as predict().
+   * 
+   * @param initial_state The starting state of the vehicle
+   * @param control_inputs An array of count control inputs seperated by the provided timestep
+   * @param count The number of control inputs. Must not exceed the real_time_max_horizon parameter
+   * @param timestep The time increment between traversed states and provided control inputs. Unit: seconds
+   * @param output An array of at least count states which will hold the traversed states excluding the initial state
+   * 
+   * @return PredictStatus::SUCCESS if output was populated. Otherwise the reason the prediction was not made
+   * 
+   */
+  PredictStatus predictRealTime(const VehicleState& initial_state,
+    const VehicleControlInput* control_inputs, size_t count, double timestep, VehicleState* output) noexcept;
+}
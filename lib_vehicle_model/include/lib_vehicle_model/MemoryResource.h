@@ -0,0 +1,237 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <vector>
+
+namespace lib_vehicle_model {
+
+  /**
+   * @class MemoryResource
+   * @brief Interface for a source of memory which can be shared by containers through a ResourceAllocator
+   * 
+   * This is a C++11 equivalent of std::pmr::memory_resource.
+   * It allows callers to control where the trajectories returned by the prediction functions are allocated.
+   */
+  class MemoryResource
+  {
+    public:
+      /**
+       * @brief Virtual destructor to ensure delete safety for pointers to implementing classes
+       */
+      virtual ~MemoryResource() {};
+
+      /**
+       * @brief Allocates memory from this resource
+       * 
+       * @param bytes The number of bytes to allocate
+       * @param alignment The required alignment of the returned memory. Must be a power of 2
+       * 
+       * @return A pointer to the allocated memory
+       * 
+       * @throws std::bad_alloc If the memory could not be allocated
+       */
+      void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        return doAllocate(bytes, alignment);
+      }
+
+      /**
+       * @brief Returns memory previously allocated from this resource
+       * 
+       * @param ptr The pointer returned by allocate
+       * @param bytes The number of bytes passed to allocate
+       * @param alignment The alignment passed to allocate
+       */
+      void deallocate(void* ptr, size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        doDeallocate(ptr, bytes, alignment);
+      }
+
+      /**
+       * @brief Returns true if memory allocated from this resource can be deallocated by other and vice versa
+       */
+      bool isEqual(const MemoryResource& other) const noexcept {
+        return doIsEqual(other);
+      }
+
+    protected:
+      virtual void* doAllocate(size_t bytes, size_t alignment) = 0; // Defined as pure virtual function
+      virtual void doDeallocate(void* ptr, size_t bytes, size_t alignment) = 0; // Defined as pure virtual function
+      virtual bool doIsEqual(const MemoryResource& other) const noexcept = 0; // Defined as pure virtual function
+  };
+
+  /**
+   * @brief Returns a process wide resource which uses the global operator new and delete
+   * 
+   * The resource supports alignments up to alignof(std::max_align_t). Larger alignments throw std::bad_alloc
+   */
+  MemoryResource* newDeleteResource() noexcept;
+
+  /**
+   * @class MonotonicBufferResource
+   * @brief A resource which hands out memory from a growing list of buffers and only frees it when released or destroyed
+   * 
+   * This is a C++11 equivalent of std::pmr::monotonic_buffer_resource intended to be used as a per planning cycle arena.
+   * Deallocation is a no-op so many short lived containers cost only a pointer increment each.
+   * When the current buffer is exhausted a new buffer at least twice the size of the previous one is requested from the upstream resource.
+   * 
+   * NOTE: This class is not thread safe. Each thread should use its own arena
+   */
+  class MonotonicBufferResource : public MemoryResource
+  {
+    private:
+      /**
+       * Header placed at the start of each buffer allocated from the upstream resource
+       */
+      struct Chunk {
+        Chunk* next;
+        size_t size;
+      };
+
+      MemoryResource* upstream_;
+      void* initial_buffer_; // Optional caller provided buffer used before any upstream allocation
+      size_t initial_size_;
+      size_t initial_chunk_size_; // Size of the first upstream buffer which release() restores
+      size_t next_chunk_size_;
+      Chunk* chunks_ = nullptr; // Most recently allocated upstream buffer
+      char* current_; // Next free byte of the active buffer
+      size_t space_; // Number of free bytes in the active buffer
+
+    public:
+      /**
+       * @brief Constructor which allocates buffers from the upstream resource as needed
+       * 
+       * @param initial_size The size in bytes of the first buffer requested from upstream
+       * @param upstream The resource buffers are allocated from
+       * 
+       * @throws std::invalid_argument If upstream is null
+       */
+      explicit MonotonicBufferResource(size_t initial_size = 1024, MemoryResource* upstream = newDeleteResource());
+
+      /**
+       * @brief Constructor which uses the provided buffer before allocating from the upstream resource
+       * 
+       * @param buffer A buffer which must outlive this resource
+       * @param size The size of the buffer in bytes
+       * @param upstream The resource additional buffers are allocated from
+       * 
+       * @throws std::invalid_argument If upstream is null
+       */
+      MonotonicBufferResource(void* buffer, size_t size, MemoryResource* upstream = newDeleteResource());
+
+      /**
+       * @brief Destructor which releases all buffers allocated from upstream
+       */
+      ~MonotonicBufferResource();
+
+      MonotonicBufferResource(const MonotonicBufferResource&) = delete;
+      MonotonicBufferResource& operator=(const MonotonicBufferResource&) = delete;
+
+      /**
+       * @brief Frees all memory allocated from this resource in one step
+       * 
+       * All buffers allocated from upstream are returned and the initial buffer is reused by later allocations.
+       * The next upstream buffer is requested with the size used after construction so repeated cycles do not grow.
+       * Containers using this resource must not be used after this call.
+       */
+      void release();
+
+      /**
+       * @brief Returns the upstream resource
+       */
+      MemoryResource* upstreamResource() const;
+
+    protected:
+      void* doAllocate(size_t bytes, size_t alignment) override;
+      void doDeallocate(void* ptr, size_t bytes, size_t alignment) override;
+      bool doIsEqual(const MemoryResource& other) const noexcept override;
+  };
+
+  /**
+   * @class ResourceAllocator
+   * @brief A C++11 allocator which allocates from a MemoryResource. Equivalent to std::pmr::polymorphic_allocator
+   * 
+   * As with std::pmr::polymorphic_allocator the resource does not propagate when a container is copied.
+   * Copies of a container are allocated from newDeleteResource() while moved containers keep their resource.
+   * 
+   * @tparam T The type of object to allocate
+   */
+  template<typename T>
+  class ResourceAllocator
+  {
+    private:
+      MemoryResource* resource_;
+
+    public:
+      using value_type = T;
+
+      /**
+       * @brief Constructor which uses newDeleteResource()
+       */
+      ResourceAllocator() noexcept : resource_(newDeleteResource()) {}
+
+      /**
+       * @brief Constructor
+       * 
+       * @param resource The resource to allocate from. Must outlive all containers using this allocator
+       */
+      ResourceAllocator(MemoryResource* resource) noexcept : resource_(resource) {}
+
+      template<typename U>
+      ResourceAllocator(const ResourceAllocator<U>& other) noexcept : resource_(other.resource()) {}
+
+      T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+          throw std::bad_alloc();
+        }
+        return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+      }
+
+      void deallocate(T* ptr, size_t n) {
+        resource_->deallocate(ptr, n * sizeof(T), alignof(T));
+      }
+
+      ResourceAllocator select_on_container_copy_construction() const {
+        return ResourceAllocator();
+      }
+
+      /**
+       * @brief Returns the resource this allocator allocates from
+       */
+      MemoryResource* resource() const noexcept {
+        return resource_;
+      }
+  };
+
+  template<typename T, typename U>
+  bool operator==(const ResourceAllocator<T>& lhs, const ResourceAllocator<U>& rhs) noexcept {
+    return lhs.resource() == rhs.resource() || lhs.resource()->isEqual(*rhs.resource());
+  }
+
+  template<typename T, typename U>
+  bool operator!=(const ResourceAllocator<T>& lhs, const ResourceAllocator<U>& rhs) noexcept {
+    return !(lhs == rhs);
+  }
+
+  /**
+   * @brief Type alias for a vector whose elements are allocated from a MemoryResource
+   */
+  template<typename T>
+  using ResourceVector = std::vector<T, ResourceAllocator<T>>;
+}
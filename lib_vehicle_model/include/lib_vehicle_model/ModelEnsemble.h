@@ -0,0 +1,179 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+#include "VehicleState.h"
+#include "VehicleControlInput.h"
+#include "VehicleMotionModel.h"
+#include "ParameterServer.h"
+
+namespace lib_vehicle_model {
+
+  class ConstraintChecker; // Forward declaration of the private validation helper
+
+  /**
+   * @struct EnsemblePrediction
+   * @brief The per model trajectories of an ensemble prediction and their element-wise spread
+   *
+   * The statistics cover the steps which every model returned.
+   */
+  struct EnsemblePrediction
+  {
+    /**
+     * The trajectory predicted by each model in ensemble order
+     */
+    std::vector<std::vector<VehicleState>> trajectories;
+
+    /**
+     * The mean of each state field at each step
+     */
+    std::vector<VehicleState> mean;
+
+    /**
+     * The population standard deviation of each state field at each step
+     */
+    std::vector<VehicleState> std_dev;
+
+    /**
+     * The largest distance in meters between the position of any model and the mean position at each step
+     */
+    std::vector<double> max_position_deviation;
+  };
+
+  /**
+   * @class ModelEnsemble
+   * @brief Runs several vehicle models on the same prediction request concurrently
+   *
+   * Each request is validated once with the constraints used by lib_vehicle_model and then passed to every model in parallel.
+   * The spread between the resulting trajectories, such as between a kinematic and a dynamic model, can be used as a confidence signal.
+   *
+   * The first model runs on the calling thread. Every other model has a worker thread which is started by the constructor
+   * and reused by every request, so no threads are created per prediction.
+   *
+   * Ensembles are independent of the model loaded by lib_vehicle_model::init and of each other.
+   *
+   * NOTE: Concurrent calls to the predict functions of one ensemble are serialized as the models are shared by all calls.
+   */
+  class ModelEnsemble
+  {
+    private:
+      std::vector<std::shared_ptr<VehicleMotionModel>> models_;
+      std::unique_ptr<ConstraintChecker> constraint_checker_;
+      std::mutex predict_mutex_;
+
+      // Worker thread i + 1 runs model i + 1 of each request
+      std::vector<std::thread> workers_;
+      std::mutex work_mutex_;
+      std::condition_variable work_cv_;
+      std::condition_variable done_cv_;
+      const std::function<void(size_t)>* task_ = nullptr; // Runs the current request on the model with the provided index
+      uint64_t task_generation_ = 0;
+      size_t pending_workers_ = 0;
+      bool stopping_ = false;
+
+      /**
+       * @brief Helper function which starts one worker thread for every model after the first
+       */
+      void startWorkers();
+
+      /**
+       * @brief Helper function which stops and joins the worker threads
+       */
+      void stopWorkers();
+
+      /**
+       * @brief Loop run by the worker thread of the model with the provided index
+       */
+      void workerLoop(size_t model_index);
+
+      /**
+       * @brief Helper function which runs the provided prediction on every model in parallel and computes the spread
+       */
+      template<typename PredictFunction>
+      EnsemblePrediction fanOut(PredictFunction predict);
+
+    public:
+
+      /**
+       * @brief Constructor which loads each model plugin listed by the ensemble_model_lib_paths parameter
+       *
+       * Each path is loaded in the same way as the vehicle_model_lib_path parameter of lib_vehicle_model::init.
+       * The parameter server is passed to every model and used to read the vehicle constraints.
+       *
+       * @param parameter_server The parameter server used by the ensemble and its models
+       *
+       * @throws std::invalid_argument If the parameter server is null, the parameter is missing or empty, a model could not be loaded
+       *                               or the constraints could not be read
+       */
+      explicit ModelEnsemble(std::shared_ptr<ParameterServer> parameter_server);
+
+      /**
+       * @brief Constructor which uses already constructed and configured models
+       *
+       * @param parameter_server The parameter server used to read the vehicle constraints
+       * @param models The models of the ensemble
+       *
+       * @throws std::invalid_argument If the parameter server is null, no models are provided, a model is null or the constraints could not be read
+       */
+      ModelEnsemble(std::shared_ptr<ParameterServer> parameter_server, const std::vector<std::shared_ptr<VehicleMotionModel>>& models);
+
+      ~ModelEnsemble();
+
+      /**
+       * @brief Predict vehicle motion with every model assuming no change in control input
+       *
+       * @param initial_state The starting state of the vehicle
+       * @param timestep The time increment between returned traversed states. Unit: seconds
+       * @param delta_t The time to project the motion forward for. Unit: seconds
+       *
+       * @return The trajectory of each model and their spread
+       *
+       * @throws std::invalid_argument If the initial vehicle state is found to be invalid or timestep is larger than delta_t
+       */
+      EnsemblePrediction predict(const VehicleState& initial_state, double timestep, double delta_t);
+
+      /**
+       * @brief Predict vehicle motion with every model given a starting state and list of control inputs
+       *
+       * @param initial_state The starting state of the vehicle
+       * @param control_inputs A list of control inputs seperated by the provided timestep
+       * @param timestep The time increment between returned traversed states and provided control inputs. Unit: seconds
+       *
+       * @return The trajectory of each model and their spread
+       *
+       * @throws std::invalid_argument If the initial vehicle state or control inputs are found to be invalid
+       */
+      EnsemblePrediction predict(const VehicleState& initial_state,
+        const std::vector<VehicleControlInput>& control_inputs, double timestep);
+
+      /**
+       * @brief Returns the number of models in the ensemble
+       */
+      size_t size() const;
+
+      ModelEnsemble(const ModelEnsemble&) = delete;
+      ModelEnsemble& operator=(const ModelEnsemble&) = delete;
+  };
+}
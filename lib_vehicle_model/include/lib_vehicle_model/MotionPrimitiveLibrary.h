@@ -0,0 +1,224 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include "VehicleState.h"
+#include "VehicleControlInput.h"
+
+namespace lib_vehicle_model {
+  /**
+   * @struct MotionPrimitiveGrid
+   * @brief The grid of initial conditions and control sequences which make up a motion primitive library
+   */
+  struct MotionPrimitiveGrid
+  {
+    /**
+     * The initial longitudinal velocities of the primitives in m/s
+     */
+    std::vector<double> initial_speeds;
+
+    /**
+     * The initial steering angles of the primitives in rad
+     */
+    std::vector<double> initial_steering_angles;
+
+    /**
+     * The control sequences applied from each combination of initial speed and steering angle
+     */
+    std::vector<std::vector<VehicleControlInput>> control_sequences;
+
+    /**
+     * The time between control inputs and stored states in seconds
+     */
+    double timestep = 0.1;
+
+    /**
+     * Body frame values used for the remaining fields of each initial state.
+     * The pose is ignored. The longitudinal velocity, steering angle and previous commands are replaced by the grid values
+     */
+    VehicleState base_state;
+  };
+
+  /**
+   * @class MotionPrimitiveLibrary
+   * @brief Precomputed motion primitives of the model loaded by lib_vehicle_model::init
+   *
+   * Every combination of initial speed, initial steering angle and control sequence in the grid is integrated once in
+   * the canonical frame (origin, orientation 0). Queries transform a stored primitive to the pose of the provided state
+   * instead of integrating it again. Libraries can also be built offline and saved to a file.
+   *
+   * The library records lib_vehicle_model::getParameterGeneration() when built. If a different model or parameter set has
+   * since been loaded the next query rebuilds the library from its grid.
+   *
+   * NOTE: The loaded model must be frame invariant. See VehicleMotionModel::isFrameInvariant()
+   *
+   * NOTE: This class is not thread safe. Each planning thread should own its own instance or share a built library read only
+   *       through the const getCanonicalPrimitive function.
+   */
+  class MotionPrimitiveLibrary
+  {
+    private:
+      MotionPrimitiveGrid grid_;
+      std::vector<VehicleState> states_; // States of all primitives stored back to back
+      std::vector<size_t> offsets_; // Index of the first state of each primitive. Has one extra element marking the end
+      uint64_t generation_ = 0;
+      uint64_t rebuild_count_ = 0;
+      bool built_ = false;
+      bool verify_pending_ = false; // True if the library was loaded from a file and not yet compared with the loaded model
+
+      /**
+       * @brief Helper function which integrates every primitive of grid_ with the loaded model
+       */
+      void integrateGrid();
+
+      /**
+       * @brief Helper function which rebuilds the library if the loaded model changed since it was built
+       */
+      void ensureCurrent();
+
+      /**
+       * @brief Helper function which integrates one primitive again and compares it with the stored one
+       */
+      bool primitiveMatchesLoadedModel(size_t speed_index, size_t steering_index, size_t sequence_index) const;
+
+      /**
+       * @brief Helper function which compares the first and last control sequence at each corner of the initial speed
+       *        and steering angle grid with the loaded model
+       */
+      bool matchesLoadedModel() const;
+
+      /**
+       * @brief Helper function which returns the index of the primitive for the provided grid indices
+       */
+      size_t primitiveIndex(size_t speed_index, size_t steering_index, size_t sequence_index) const;
+
+    public:
+
+      /**
+       * @brief Integrates every primitive of the provided grid with the loaded model
+       *
+       * @param grid The initial conditions and control sequences of the primitives
+       *
+       * @throws ModelAccessException If no model has been loaded with lib_vehicle_model::init
+       * @throws std::invalid_argument If the grid is empty, the timestep is not positive, the loaded model is not frame invariant
+       *         or a primitive fails validation by lib_vehicle_model::predict
+       */
+      void build(const MotionPrimitiveGrid& grid);
+
+      /**
+       * @brief Writes the grid and primitives to a file which can be read with load
+       *
+       * @param file_path The path of the file to write. An existing file is overwritten
+       *
+       * @throws std::invalid_argument If the library has not been built or the file could not be written
+       */
+      void save(const std::string& file_path) const;
+
+      /**
+       * @brief Reads a library written by save
+       *
+       * If a model is loaded the first and last control sequence at each corner of the initial speed and steering angle grid
+       * are integrated again and compared with the stored primitives.
+       * If they differ the file was generated with different vehicle parameters and the library is rebuilt from the stored grid.
+       * If an exception is thrown this library is left unchanged.
+       *
+       * @param file_path The path of the file to read
+       *
+       * @throws std::invalid_argument If the file could not be read or is not a motion primitive library,
+       *                               or the loaded model is not frame invariant
+       */
+      void load(const std::string& file_path);
+
+      /**
+       * @brief Returns the stored primitive closest to the provided state transformed to the pose of that state
+       *
+       * The primitive with the grid speed and steering angle nearest to the longitudinal velocity and steering angle of the state is used.
+       *
+       * @param initial_state The state the primitive starts from
+       * @param sequence_index The index of the control sequence in the grid
+       *
+       * @return The traversed states of the primitive excluding the initial state
+       *
+       * @throws std::invalid_argument If the library has not been built or the index is out of range
+       */
+      std::vector<VehicleState> query(const VehicleState& initial_state, size_t sequence_index);
+
+      /**
+       * @brief Returns the stored primitive for the provided grid indices transformed to the provided pose
+       *
+       * @param pose The state whose position and orientation the primitive starts from
+       * @param speed_index The index of the initial speed in the grid
+       * @param steering_index The index of the initial steering angle in the grid
+       * @param sequence_index The index of the control sequence in the grid
+       *
+       * @return The traversed states of the primitive excluding the initial state
+       *
+       * @throws std::invalid_argument If the library has not been built or an index is out of range
+       */
+      std::vector<VehicleState> query(const VehicleState& pose, size_t speed_index, size_t steering_index, size_t sequence_index);
+
+      /**
+       * @brief Returns the stored primitive for the provided grid indices in the canonical frame without checking for parameter changes
+       *
+       * @param speed_index The index of the initial speed in the grid
+       * @param steering_index The index of the initial steering angle in the grid
+       * @param sequence_index The index of the control sequence in the grid
+       * @param count Output parameter set to the number of states in the primitive
+       *
+       * @return A pointer to the first state of the primitive
+       *
+       * @throws std::invalid_argument If the library has not been built or an index is out of range
+       */
+      const VehicleState* getCanonicalPrimitive(size_t speed_index, size_t steering_index, size_t sequence_index, size_t& count) const;
+
+      /**
+       * @brief Returns true if the library holds primitives
+       */
+      bool isBuilt() const;
+
+      /**
+       * @brief Returns true if a different model or parameter set has been loaded since the library was built
+       */
+      bool isStale() const;
+
+      /**
+       * @brief Returns the grid the library was built from
+       */
+      const MotionPrimitiveGrid& getGrid() const;
+
+      /**
+       * @brief Returns the number of times the library was rebuilt because the loaded model or its parameters changed
+       */
+      uint64_t getRebuildCount() const;
+
+      /**
+       * @brief Returns the index of the grid value closest to the target
+       *
+       * Used to select the primitives for an initial speed or steering angle. Returns 0 if values is empty
+       *
+       * @param values The grid values to search
+       * @param target The value to match
+       *
+       * @return The index of the nearest value
+       */
+      static size_t nearestIndex(const std::vector<double>& values, double target);
+  };
+}
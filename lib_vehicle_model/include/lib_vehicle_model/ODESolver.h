@@ -76,17 +76,70 @@ namespace lib_vehicle_model {
      * @param tracker An object that will be preserved during integration steps and can be used to track integration variables such as elapsed time. If not needed, point at a variable whose scope is at least as long as this call
      * @param output A list of output states seperated by step_size with an added length equal to num_steps. Elements of the list are tuples of (independant variable, state)
      * @param post_step_fun A function which will be called after each integration step. This function can be used to set state variables which are not being considered during integration
+     * @param output_stride Only every output_stride-th post step state and the final state are added to the output. The post step function is still called after every step. A value of 0 is treated as 1
      */
 
     template<typename C, typename T>
     void rk4(const ODEFunction<C,T>& ode_func,
       double num_steps,
       double step_size,
-      const State& initial_state,
+      State& initial_state,
       std::vector<C>& controls,
       std::vector<std::tuple<double, State>>& output,
       const PostStepFunction<C,T>& post_step_func,
-      T& tracker
+      T& tracker,
+      size_t output_stride = 1
+    );
+
+    /**
+     * @struct RK4Workspace
+     * @brief Preallocated intermediate vectors used by rk4Step so a step does not allocate memory
+     */
+    struct RK4Workspace {
+      StateDot k1;
+      StateDot k2;
+      StateDot k3;
+      StateDot k4;
+      State tmp;
+
+      /**
+       * @brief Sizes all intermediate vectors for states with the provided number of elements
+       * 
+       * @param state_size The number of elements in the integrated state
+       */
+      void resize(size_t state_size) {
+        k1.resize(state_size, 0);
+        k2.resize(state_size, 0);
+        k3.resize(state_size, 0);
+        k4.resize(state_size, 0);
+        tmp.resize(state_size, 0);
+      }
+    };
+
+    /**
+     * @brief Advance a state by a single step of Runge-Kutta 4th Order Integration
+     * 
+     * Uses the same coefficients as rk4 so repeatedly calling this function reproduces the states integrated by rk4.
+     * No memory is allocated provided the workspace was sized for the state and the ODE function does not grow state_dot.
+     * 
+     * @tparam C The data type of the control variable
+     * 
+     * @param ode_func The function describing the ODEs
+     * @param control The control which will be applied as a constant during the step
+     * @param tracker An object which is passed to the ode function
+     * @param state The state at time t which will be replaced with the state at time t + step_size
+     * @param t The value of the independent variable at the start of the step
+     * @param step_size The step size of the independent variable
+     * @param workspace Intermediate vectors sized for the state
+     */
+    template<typename C, typename T>
+    void rk4Step(const ODEFunction<C,T>& ode_func,
+      const C& control,
+      T& tracker,
+      State& state,
+      double t,
+      double step_size,
+      RK4Workspace& workspace
     );
   }
 }
@@ -0,0 +1,45 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <iostream>
+
+namespace lib_vehicle_model {
+
+  /**
+   * @enum PredictStatus
+   * @brief An enumeration of the possible results of a real-time prediction
+   * 
+   * The real-time prediction path reports errors with this status instead of throwing exceptions
+   * 
+   */
+  enum class PredictStatus 
+  {
+    SUCCESS,
+    MODEL_NOT_LOADED,    // init() has not been called or the model was unloaded
+    REAL_TIME_DISABLED,  // The real_time_max_horizon parameter was not set
+    THREAD_NOT_PREPARED, // prepareRealTimeThread() has not been called by the current thread since the model was loaded
+    HORIZON_TOO_LONG,    // More control inputs were provided than the configured real_time_max_horizon
+    INVALID_INPUT,       // The initial state or control inputs failed validation
+    MODEL_FAILURE        // The vehicle model could not complete the prediction
+  };
+
+  /**
+   * Overload of << operation so enum objects will output as strings in print functions
+   * 
+   */ 
+  std::ostream& operator<<( std::ostream& os, const PredictStatus& status );
+}
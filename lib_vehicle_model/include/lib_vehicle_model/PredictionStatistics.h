@@ -0,0 +1,114 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+
+namespace lib_vehicle_model {
+
+  /**
+   * @enum PredictCallType
+   * @brief An enumeration of the prediction functions of the lib_vehicle_model namespace which are tracked by PredictionStatistics
+   */
+  enum class PredictCallType
+  {
+    PREDICT_NO_CONTROL,
+    PREDICT_WITH_CONTROL,
+    PREDICT_NO_CONTROL_STRIDE,
+    PREDICT_WITH_CONTROL_STRIDE,
+    PREDICT_REDUCED_NO_CONTROL,
+    PREDICT_REDUCED_WITH_CONTROL,
+    PREDICT_STEP,
+    PREDICT_LAZY,
+    PREDICT_REAL_TIME,
+    PREDICT_NO_CONTROL_RESOURCE,
+    PREDICT_WITH_CONTROL_RESOURCE,
+    PREDICT_CONTROL_CHANGES,
+    PREDICT_VALIDATED_CONTROLS,
+    PREDICT_CONTROL_CHANGES_STRIDE,
+    COUNT // Number of call types. Not a valid call type
+  };
+
+  /**
+   * Overload of << operation so enum objects will output as strings in print functions
+   *
+   */
+  std::ostream& operator<<( std::ostream& os, const PredictCallType& type );
+
+  /**
+   * @struct PredictionStatistics
+   * @brief A snapshot of the usage statistics of the lib_vehicle_model prediction functions
+   *
+   * Latencies are recorded in a histogram for each horizon length bucket.
+   * Horizon bucket 0 holds predictions of at most 1 step and bucket i > 0 holds horizons of [2^i, 2^(i+1)) steps.
+   * Latency bucket 0 holds calls which took less than 1 microsecond and bucket i > 0 holds calls of [2^(i-1), 2^i) microseconds.
+   * The last bucket of each dimension also holds all larger values.
+   */
+  struct PredictionStatistics
+  {
+    static const size_t HORIZON_BUCKET_COUNT = 12;
+    static const size_t LATENCY_BUCKET_COUNT = 24;
+    static const size_t CALL_TYPE_COUNT = static_cast<size_t>(PredictCallType::COUNT);
+
+    /**
+     * Number of successfully validated calls indexed by horizon bucket then latency bucket
+     */
+    uint64_t latency_histogram[HORIZON_BUCKET_COUNT][LATENCY_BUCKET_COUNT] = {};
+    /**
+     * Number of calls made to each prediction function indexed by PredictCallType. Includes calls which failed validation
+     */
+    uint64_t call_counts[CALL_TYPE_COUNT] = {};
+    /**
+     * Number of calls rejected due to invalid inputs
+     */
+    uint64_t validation_failures = 0;
+    /**
+     * Number of prediction calls currently executing. This value is not affected by a reset
+     */
+    int64_t in_flight = 0;
+
+    /**
+     * @brief Returns the total number of calls to all prediction functions
+     */
+    uint64_t totalCalls() const;
+
+    /**
+     * @brief Returns the number of calls made to the provided prediction function
+     */
+    uint64_t callCount(PredictCallType type) const;
+
+    /**
+     * @brief Returns the horizon bucket which a prediction of the provided number of steps is recorded in
+     */
+    static size_t horizonBucket(uint64_t steps);
+
+    /**
+     * @brief Returns the latency bucket which a call of the provided duration is recorded in
+     *
+     * @param nanoseconds The call duration in nanoseconds
+     */
+    static size_t latencyBucket(uint64_t nanoseconds);
+
+    /**
+     * Overload of << operation so struct will output as strings in print functions
+     * Only non-empty buckets are printed
+     *
+     */
+    friend std::ostream& operator<<( std::ostream& os, const PredictionStatistics& stats );
+  };
+}
@@ -0,0 +1,91 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include "VehicleState.h"
+#include "VehicleControlInput.h"
+#include "VehicleMotionModel.h"
+
+namespace lib_vehicle_model {
+  /**
+   * @class RecedingHorizonPredictor
+   * @brief A stateful wrapper around a VehicleMotionModel which reuses the previous prediction between planning cycles
+   *
+   * Each call stores the resulting trajectory and the control inputs used to generate it.
+   * When the next call starts from a state which lies within the configured tolerance of one of the stored states
+   * the stored states which follow it are reused for as long as the new control inputs match the stored ones.
+   * Only the remaining tail of the horizon is integrated with the wrapped model.
+   *
+   * NOTE: The state comparison covers the physical state fields only. The prev_vel_cmd and prev_steering_cmd fields are ignored
+   *       as they are not used when predicting with control inputs.
+   *
+   * NOTE: This class is not thread safe. Each planning thread should own its own instance.
+   */
+  class RecedingHorizonPredictor
+  {
+    private:
+      std::shared_ptr<VehicleMotionModel> model_;
+      double state_tolerance_;
+
+      // Data from the previous call to predict
+      double timestep_ = 0.0;
+      std::vector<VehicleControlInput> control_inputs_;
+      std::vector<VehicleState> trajectory_;
+      size_t reused_steps_ = 0;
+
+      /**
+       * @brief Helper function to check if two states are within state_tolerance_ of each other in every physical field
+       */
+      bool isWithinTolerance(const VehicleState& a, const VehicleState& b) const;
+
+    public:
+
+      /**
+       * @brief Constructor
+       *
+       * @param model The vehicle model used to integrate any part of the horizon which cannot be reused
+       * @param state_tolerance The maximum absolute difference allowed in each state field for a stored state to be considered a match
+       *
+       * @throws std::invalid_argument If the model is null or the tolerance is negative
+       */
+      RecedingHorizonPredictor(std::shared_ptr<VehicleMotionModel> model, double state_tolerance);
+
+      /**
+       * @brief Predict vehicle motion given a starting state and list of control inputs reusing the previous prediction where possible
+       *
+       * @param initial_state The starting state of the vehicle
+       * @param control_inputs A list of control inputs seperated by the provided timestep
+       * @param timestep The time increment between returned traversed states and provided control inputs. Unit: seconds
+       *
+       * @return A list of traversed states seperated by the timestep excluding the initial state
+       */
+      std::vector<VehicleState> predict(const VehicleState& initial_state,
+        const std::vector<VehicleControlInput>& control_inputs, double timestep);
+
+      /**
+       * @brief Discard the stored trajectory so the next call to predict integrates the full horizon
+       */
+      void reset();
+
+      /**
+       * @brief Returns the number of states which were reused from the stored trajectory during the last call to predict
+       */
+      size_t getReusedStepCount() const;
+  };
+}
@@ -0,0 +1,79 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <sstream>
+#include "VehicleState.h"
+
+namespace lib_vehicle_model {
+  /**
+   * @struct ReducedVehicleState
+   * @brief A struct containing the subset of VehicleState fields needed by most trajectory consumers
+   *
+   * Predictions which return this struct store one third of the data of a full VehicleState per step
+   * and allow vehicle models to skip computing the remaining fields.
+   * The members have the same meaning as the matching members of VehicleState
+   */
+  struct ReducedVehicleState
+  {
+    /**
+     * 2d x-axis position of the vehicle center of gravity in meters
+     * This position is in a fixed inertial frame which vehicle motion is described in
+     */
+    double X_pos_global = 0;
+    /**
+     * 2d y-axis position of the vehicle center of gravity in meters
+     * This position is in a fixed inertial frame which vehicle motion is described in
+     */
+    double Y_pos_global = 0;
+    /**
+     * The orientation of the vehicle's longitudinal axis in radians
+     * This orientation is in a fixed inertial frame which vehicle motion is described in
+     */
+    double orientation = 0;
+    /**
+     * longitudinal velocity of the vehicle center of gravity in m/s in its body frame
+     */
+    double longitudinal_vel = 0;
+
+    /**
+     * @brief Default constructor
+     */
+    ReducedVehicleState() = default;
+
+    /**
+     * @brief Constructor which copies the matching fields of a full VehicleState
+     */
+    explicit ReducedVehicleState(const VehicleState& state) :
+      X_pos_global(state.X_pos_global), Y_pos_global(state.Y_pos_global),
+      orientation(state.orientation), longitudinal_vel(state.longitudinal_vel) {}
+
+    /**
+     * Overload of << operation so struct will output as strings in print functions
+     *
+     */
+    friend std::ostream& operator<<( std::ostream& os, const ReducedVehicleState& v )
+    {
+      os << "ReducedVehicleState [ " <<
+        v.X_pos_global << ", " <<
+        v.Y_pos_global << ", " <<
+        v.orientation << ", " <<
+        v.longitudinal_vel << " ]";
+
+      return os;
+    }
+  };
+}
@@ -0,0 +1,90 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include "VehicleState.h"
+#include "VehicleControlInput.h"
+#include "VehicleMotionModel.h"
+
+namespace lib_vehicle_model {
+  /**
+   * @class ResumableTrajectory
+   * @brief A handle to a prediction which can be extended with additional control inputs without re-integrating the existing states
+   *
+   * The handle keeps the final state of the integration so each call to append only integrates the new segment.
+   * Growing a trajectory one segment at a time therefore costs O(n) in total instead of O(n^2).
+   *
+   * The wrapped model must be able to resume from one of its own output states. This holds for the passenger car models
+   * as their integrated state is fully contained in the VehicleState and their post step trackers (such as prev_time)
+   * are relative to the start of each segment.
+   *
+   * NOTE: This class is not thread safe
+   */
+  class ResumableTrajectory
+  {
+    private:
+      std::shared_ptr<VehicleMotionModel> model_;
+      VehicleState initial_state_;
+      double timestep_;
+      std::vector<VehicleControlInput> control_inputs_;
+      std::vector<VehicleState> states_;
+
+    public:
+
+      /**
+       * @brief Constructor
+       *
+       * @param model The vehicle model used to integrate each appended segment
+       * @param initial_state The starting state of the vehicle
+       * @param timestep The time increment between traversed states and control inputs. Unit: seconds
+       *
+       * @throws std::invalid_argument If the model is null or the timestep is not positive
+       */
+      ResumableTrajectory(std::shared_ptr<VehicleMotionModel> model, const VehicleState& initial_state, double timestep);
+
+      /**
+       * @brief Extend the trajectory by integrating the provided control inputs from the current final state
+       *
+       * @param control_inputs A list of control inputs seperated by the trajectory timestep
+       *
+       * @return The newly traversed states seperated by the timestep
+       */
+      std::vector<VehicleState> append(const std::vector<VehicleControlInput>& control_inputs);
+
+      /**
+       * @brief Returns all traversed states seperated by the timestep excluding the initial state
+       */
+      const std::vector<VehicleState>& getStates() const;
+
+      /**
+       * @brief Returns every control input appended so far
+       */
+      const std::vector<VehicleControlInput>& getControlInputs() const;
+
+      /**
+       * @brief Returns the last traversed state or the initial state if nothing has been appended
+       */
+      const VehicleState& getFinalState() const;
+
+      /**
+       * @brief Returns the time covered by the trajectory in seconds
+       */
+      double getElapsedTime() const;
+  };
+}
@@ -0,0 +1,123 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstddef>
+#include <sstream>
+#include "VehicleControlInput.h"
+
+namespace lib_vehicle_model {
+  /**
+   * @struct TimedControlInput
+   * @brief A control input which takes effect at a specified time and remains active until the next change
+   * 
+   * Used to describe sparse controller output as a list of change points instead of one control input per timestep
+   */
+  struct TimedControlInput 
+  {
+
+    /**
+     * The time in seconds, relative to the initial state of a prediction, at which this control input takes effect
+     */
+    double time = 0;
+
+    /**
+     * The control input applied from time until the next change point
+     */
+    VehicleControlInput control;
+
+    /**
+     * Overload of << operation so struct will output as strings in print functions
+     * 
+     */ 
+    friend std::ostream& operator<<( std::ostream& os, const TimedControlInput& c )
+    {
+      os << "TimedControlInput [ " << 
+        c.time << ", " <<
+        c.control << " ]";
+
+      return os;
+    }
+  };
+
+  /**
+   * @class ControlChangeCursor
+   * @brief Helper which returns the control input applied during each integration step of a list of change points
+   * 
+   * A change point takes effect at the first step which starts at or after its time.
+   * Steps before the first change point use the provided initial control.
+   * Advancing through a whole prediction costs O(number of steps + number of change points) and does not allocate memory.
+   * 
+   * NOTE: This class is header only as it is used by the default implementation in the VehicleMotionModel interface
+   */
+  class ControlChangeCursor
+  {
+    private:
+      const std::vector<TimedControlInput>* changes_;
+      double timestep_;
+      size_t next_change_ = 0;
+      VehicleControlInput current_;
+
+    public:
+      /**
+       * @brief Constructor
+       * 
+       * @param changes The control change points sorted by time. Must outlive this cursor
+       * @param initial_control The control input applied before the first change point
+       * @param timestep The integration time step in seconds
+       */
+      ControlChangeCursor(const std::vector<TimedControlInput>& changes, const VehicleControlInput& initial_control, double timestep) :
+        changes_(&changes), timestep_(timestep), current_(initial_control) {}
+
+      /**
+       * @brief Returns the control input applied during the provided step
+       * 
+       * @param step The index of the integration step. Must not be lower than the step of the previous call
+       * 
+       * @return The control input active at the start of the step
+       */
+      const VehicleControlInput& controlForStep(size_t step) {
+        while (next_change_ < changes_->size() && firstStep((*changes_)[next_change_].time, timestep_) <= step) {
+          current_ = (*changes_)[next_change_].control;
+          next_change_++;
+        }
+        return current_;
+      }
+
+      /**
+       * @brief Returns the index of the first integration step which a change point at the provided time applies to
+       * 
+       * @param time The time of the change point in seconds
+       * @param timestep The integration time step in seconds
+       */
+      static size_t firstStep(double time, double timestep) {
+        // Tolerance in steps used so change points which land on a step boundary are not shifted by floating point error
+        const double step_tolerance = 1e-9;
+
+        if (!(time > 0)) {
+          return 0;
+        }
+        const double step = std::ceil(time / timestep - step_tolerance);
+        if (!(step < static_cast<double>(std::numeric_limits<size_t>::max()))) {
+          return std::numeric_limits<size_t>::max(); // Never reached by a prediction
+        }
+        return static_cast<size_t>(step);
+      }
+  };
+}
@@ -0,0 +1,119 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <iostream>
+#include <stdexcept>
+
+/**
+ * Optional tracing of lib_vehicle_model calls
+ *
+ * When enabled, spans are recorded for init, the prediction functions, ConstraintChecker validation and,
+ * for vehicle models which use this facility, the integration and output conversion phases of a prediction.
+ * Spans are written to a fixed size lock-free ring buffer which keeps the most recent spans once full.
+ * The buffer can be flushed to a Chrome trace JSON file which can be opened in chrome://tracing or Perfetto.
+ *
+ * When tracing is disabled recording a span costs a single atomic load.
+ */
+namespace lib_vehicle_model {
+  namespace tracing {
+
+    /**
+     * Number of spans the ring buffer holds if no capacity is specified
+     */
+    const size_t DEFAULT_CAPACITY = 65536;
+
+    /**
+     * @brief Enables the recording of spans
+     *
+     * @param capacity The number of spans the ring buffer holds. If this differs from the current capacity a new buffer is allocated
+     *
+     * @throws std::invalid_argument If the capacity is 0
+     *
+     * NOTE: Previously allocated buffers are kept until the process exits so spans being recorded on other threads remain valid
+     */
+    void enable(size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief Stops the recording of new spans. Recorded spans are kept until cleared
+     */
+    void disable();
+
+    /**
+     * @brief Returns true if spans are being recorded
+     */
+    bool isEnabled();
+
+    /**
+     * @brief Discards all recorded spans
+     *
+     * NOTE: This function should not be called while other threads are recording spans
+     */
+    void clear();
+
+    /**
+     * @brief Writes the recorded spans as a Chrome trace JSON document
+     *
+     * @param os The stream to write to
+     *
+     * @return The number of spans written
+     */
+    size_t writeChromeTrace(std::ostream& os);
+
+    /**
+     * @brief Writes the recorded spans to a Chrome trace JSON file
+     *
+     * @param file_path The path of the file to write. An existing file is overwritten
+     *
+     * @return The number of spans written
+     *
+     * @throws std::invalid_argument If the file could not be opened for writing
+     */
+    size_t flush(const std::string& file_path);
+
+    /**
+     * @class ScopedSpan
+     * @brief Records a span covering the lifetime of this object if tracing was enabled at construction
+     *
+     * The name and category must be string literals or otherwise outlive any flush of the trace.
+     */
+    class ScopedSpan
+    {
+      private:
+        const char* name_;
+        const char* category_;
+        uint64_t start_ns_;
+        bool active_;
+
+      public:
+        /**
+         * @brief Constructor
+         *
+         * @param name The name of the span
+         * @param category The category of the span, typically the name of the package recording it
+         */
+        ScopedSpan(const char* name, const char* category);
+
+        ~ScopedSpan();
+
+        ScopedSpan(const ScopedSpan&) = delete;
+        ScopedSpan& operator=(const ScopedSpan&) = delete;
+    };
+  }
+}
@@ -0,0 +1,167 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include "VehicleState.h"
+#include "ParameterServer.h"
+
+namespace lib_vehicle_model {
+
+  /**
+   * @enum TrajectoryViolation
+   * @brief Bit flags identifying the limits violated by a predicted vehicle state
+   * 
+   * Flags are combined with | and tested with hasViolation()
+   * 
+   */
+  enum class TrajectoryViolation : uint8_t
+  {
+    NONE = 0,
+    SPEED_BELOW_MIN = 1 << 0,                 // longitudinal_vel is below the min_forward_speed parameter
+    SPEED_ABOVE_MAX = 1 << 1,                 // longitudinal_vel is above the max_forward_speed parameter
+    TRAILER_ANGLE_BELOW_MIN = 1 << 2,         // trailer_angle is below the min_trailer_angle parameter
+    TRAILER_ANGLE_ABOVE_MAX = 1 << 3,         // trailer_angle is above the max_trailer_angle parameter
+    LATERAL_ACCELERATION_ABOVE_MAX = 1 << 4,  // The magnitude of the lateral acceleration exceeds the max_lateral_acceleration parameter
+    YAW_RATE_ABOVE_MAX = 1 << 5               // The magnitude of yaw_rate exceeds the max_yaw_rate parameter
+  };
+
+  inline TrajectoryViolation operator|(TrajectoryViolation lhs, TrajectoryViolation rhs) {
+    return static_cast<TrajectoryViolation>(static_cast<uint8_t>(lhs) | static_cast<uint8_t>(rhs));
+  }
+
+  inline TrajectoryViolation operator&(TrajectoryViolation lhs, TrajectoryViolation rhs) {
+    return static_cast<TrajectoryViolation>(static_cast<uint8_t>(lhs) & static_cast<uint8_t>(rhs));
+  }
+
+  inline TrajectoryViolation& operator|=(TrajectoryViolation& lhs, TrajectoryViolation rhs) {
+    lhs = lhs | rhs;
+    return lhs;
+  }
+
+  /**
+   * @brief Returns true if any of the flags in violation are set in mask
+   */
+  inline bool hasViolation(TrajectoryViolation mask, TrajectoryViolation violation) {
+    return (mask & violation) != TrajectoryViolation::NONE;
+  }
+
+  /**
+   * Overload of << operation so masks will output as | separated flag names in print functions
+   * 
+   */ 
+  std::ostream& operator<<( std::ostream& os, const TrajectoryViolation& violation );
+
+  /**
+   * @class TrajectoryChecker
+   * @brief Checks predicted vehicle states against the limits of the vehicle so infeasible rollouts can be pruned
+   * 
+   * The speed and trailer angle limits are loaded from the same parameters used to validate control inputs.
+   * The max_lateral_acceleration (m/s^2) and max_yaw_rate (rad/s) parameters are optional. Their checks are disabled if not set.
+   * The lateral acceleration of a state is approximated by the steady state value longitudinal_vel * yaw_rate.
+   * 
+   * States are checked in fixed size blocks. Each block is evaluated without branches so the compiler can vectorise it,
+   * and a trajectory is abandoned after the first block which contains an infeasible state.
+   * 
+   */
+  class TrajectoryChecker
+  {
+    private:
+      double max_forward_speed_;
+      double min_forward_speed_;
+      double max_trailer_angle_;
+      double min_trailer_angle_;
+      double max_lateral_acceleration_;
+      double max_yaw_rate_;
+
+      // Helper function which returns the violations of a single state
+      TrajectoryViolation checkState(const VehicleState& state) const noexcept;
+
+    public:
+      /**
+       * The number of states evaluated between checks for an early exit
+       */
+      static const size_t BLOCK_SIZE = 8;
+
+      /**
+       * @brief Constructor
+       * 
+       * @param parameter_server The parameter server to load the vehicle limits from
+       * 
+       * @throws std::invalid_argument If one of the required speed or trailer angle parameters could not be loaded
+       */
+      explicit TrajectoryChecker(std::shared_ptr<ParameterServer> parameter_server);
+
+      /**
+       * @brief Checks a single predicted trajectory, stopping at its first infeasible state
+       * 
+       * @param states The predicted states
+       * @param count The number of states
+       * @param first_violation If not null, set to the index of the first infeasible state or count if every state is feasible
+       * 
+       * @return The violations of the first infeasible state. TrajectoryViolation::NONE if every state is feasible
+       */
+      TrajectoryViolation checkTrajectory(const VehicleState* states, size_t count, size_t* first_violation = nullptr) const noexcept;
+
+      /**
+       * @brief Checks a single predicted trajectory, stopping at its first infeasible state
+       * 
+       * @param states The predicted states
+       * 
+       * @return The violations of the first infeasible state. TrajectoryViolation::NONE if every state is feasible
+       */
+      TrajectoryViolation checkTrajectory(const std::vector<VehicleState>& states) const noexcept;
+
+      /**
+       * @brief Checks a batch of equal length trajectories stored contiguously
+       * 
+       * Trajectory i occupies states [i * horizon, (i + 1) * horizon)
+       * 
+       * @param states The predicted states of every trajectory
+       * @param trajectory_count The number of trajectories
+       * @param horizon The number of states in each trajectory
+       * @param results An array of at least trajectory_count masks which will hold the violations of each trajectory
+       * 
+       * @return The number of feasible trajectories
+       */
+      size_t checkTrajectories(const VehicleState* states, size_t trajectory_count, size_t horizon, TrajectoryViolation* results) const noexcept;
+
+      /**
+       * @brief Checks a batch of trajectories
+       * 
+       * @param trajectories The predicted trajectories
+       * @param results Resized to hold the violations of each trajectory
+       * 
+       * @return The number of feasible trajectories
+       */
+      size_t checkTrajectories(const std::vector<std::vector<VehicleState>>& trajectories, std::vector<TrajectoryViolation>& results) const;
+
+      /**
+       * @brief Returns true if the max_lateral_acceleration parameter was set
+       */
+      bool checksLateralAcceleration() const;
+
+      /**
+       * @brief Returns true if the max_yaw_rate parameter was set
+       */
+      bool checksYawRate() const;
+  };
+}
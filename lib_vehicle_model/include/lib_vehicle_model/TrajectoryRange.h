@@ -0,0 +1,140 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <functional>
+#include <stdexcept>
+#include "VehicleState.h"
+#include "VehicleControlInput.h"
+#include "VehicleMotionModel.h"
+
+namespace lib_vehicle_model {
+  /**
+   * @class TrajectoryRange
+   * @brief A lazily evaluated prediction which computes each traversed state only when the iterator is advanced
+   *
+   * Consumers which stop iterating early (such as on the first collision or constraint violation) never pay for
+   * the remainder of the horizon and no list of traversed states is ever stored.
+   *
+   * Example:
+   *   for (const VehicleState& state : TrajectoryRange(model, initial_state, control_inputs, timestep)) {
+   *     if (inCollision(state)) break;
+   *   }
+   *
+   * NOTE: The range must outlive its iterators. Each iterator advance integrates one step so iterating the
+   *       same range twice integrates the trajectory twice.
+   */
+  class TrajectoryRange
+  {
+    public:
+      /**
+       * Function used to compute the state after one timestep of a control input
+       */
+      typedef std::function<VehicleState(const VehicleState&, const VehicleControlInput&, double)> StepFunction;
+
+      /**
+       * @class const_iterator
+       * @brief Single pass input iterator over the traversed states of a TrajectoryRange
+       */
+      class const_iterator
+      {
+        private:
+          const TrajectoryRange* range_;
+          size_t index_;
+          VehicleState state_;
+
+        public:
+          typedef std::input_iterator_tag iterator_category;
+          typedef VehicleState value_type;
+          typedef std::ptrdiff_t difference_type;
+          typedef const VehicleState* pointer;
+          typedef const VehicleState& reference;
+
+          /**
+           * @brief Constructor
+           *
+           * @param range The range being iterated over
+           * @param index The index of the control input which produced the current state
+           * @param state The current state
+           */
+          const_iterator(const TrajectoryRange* range, size_t index, const VehicleState& state);
+
+          reference operator*() const;
+          pointer operator->() const;
+
+          /**
+           * @brief Integrates the next control input from the current state
+           */
+          const_iterator& operator++();
+          const_iterator operator++(int);
+
+          bool operator==(const const_iterator& other) const;
+          bool operator!=(const const_iterator& other) const;
+      };
+
+      /**
+       * @brief Constructor
+       *
+       * @param step_function The function used to compute each next state
+       * @param initial_state The starting state of the vehicle
+       * @param control_inputs A list of control inputs seperated by the provided timestep
+       * @param timestep The time increment between traversed states and provided control inputs. Unit: seconds
+       *
+       * @throws std::invalid_argument If the step function is empty
+       */
+      TrajectoryRange(StepFunction step_function, const VehicleState& initial_state,
+        const std::vector<VehicleControlInput>& control_inputs, double timestep);
+
+      /**
+       * @brief Constructor which steps the provided model using its predictStep function
+       *
+       * @param model The vehicle model used to compute each next state
+       * @param initial_state The starting state of the vehicle
+       * @param control_inputs A list of control inputs seperated by the provided timestep
+       * @param timestep The time increment between traversed states and provided control inputs. Unit: seconds
+       *
+       * @throws std::invalid_argument If the model is null
+       */
+      TrajectoryRange(std::shared_ptr<VehicleMotionModel> model, const VehicleState& initial_state,
+        const std::vector<VehicleControlInput>& control_inputs, double timestep);
+
+      /**
+       * @brief Returns an iterator to the first traversed state. This integrates the first control input
+       */
+      const_iterator begin() const;
+
+      /**
+       * @brief Returns the past the end iterator. No integration is performed
+       */
+      const_iterator end() const;
+
+      /**
+       * @brief Returns the number of states the range will produce if fully iterated
+       */
+      size_t size() const;
+
+    private:
+      StepFunction step_function_;
+      VehicleState initial_state_;
+      std::vector<VehicleControlInput> control_inputs_;
+      double timestep_;
+
+      static StepFunction modelStepFunction(std::shared_ptr<VehicleMotionModel> model);
+  };
+}
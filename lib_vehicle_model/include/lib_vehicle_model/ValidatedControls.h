@@ -0,0 +1,81 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "VehicleControlInput.h"
+
+namespace lib_vehicle_model {
+
+  class ValidatedControls;
+
+  /**
+   * Declared here so it can be named as a friend of ValidatedControls. See LibVehicleModel.h
+   */
+  ValidatedControls validateControls(const std::vector<VehicleControlInput>& control_inputs, double timestep);
+
+  /**
+   * @class ValidatedControls
+   * @brief A control sequence which has been checked against the limits of the loaded model
+   * 
+   * Produced by lib_vehicle_model::validateControls(). Every check of the sequence which does not depend on the initial state
+   * has passed, so predicting it from several initial states with lib_vehicle_model::predict() only rechecks the initial state
+   * and the steering rate of the first control relative to it.
+   * 
+   * The validation is tied to the parameter generation at which it was made. Once a model is loaded or unloaded the
+   * token is stale and predict() rejects it. Copies share the same immutable control sequence.
+   * 
+   */
+  class ValidatedControls
+  {
+    private:
+      std::shared_ptr<const std::vector<VehicleControlInput>> control_inputs_;
+      double timestep_ = 0;
+      uint64_t generation_ = 0;
+
+      ValidatedControls(const std::vector<VehicleControlInput>& control_inputs, double timestep, uint64_t generation);
+
+      friend ValidatedControls validateControls(const std::vector<VehicleControlInput>& control_inputs, double timestep);
+
+    public:
+      /**
+       * @brief Constructs an empty token which is not accepted by predict()
+       */
+      ValidatedControls() = default;
+
+      /**
+       * @brief Returns the validated control inputs. Empty if this token was default constructed
+       */
+      const std::vector<VehicleControlInput>& getControlInputs() const;
+
+      /**
+       * @brief Returns the timestep in seconds the control inputs were validated with
+       */
+      double getTimestep() const;
+
+      /**
+       * @brief Returns the value of lib_vehicle_model::getParameterGeneration() at the time of validation
+       */
+      uint64_t getParameterGeneration() const;
+
+      /**
+       * @brief Returns true if this token holds no control inputs
+       */
+      bool empty() const;
+  };
+}
@@ -15,9 +15,14 @@
  * the License.
  */
 
+#include <vector>
+#include <memory>
+#include <algorithm>
 #include "ParameterServer.h"
 #include "VehicleControlInput.h"
+#include "TimedControlInput.h"
 #include "VehicleState.h"
+#include "ReducedVehicleState.h"
 
 namespace lib_vehicle_model {
   /**
@@ -60,6 +65,254 @@ namespace lib_vehicle_model {
       virtual std::vector<VehicleState> predict(const VehicleState& initial_state,
         const std::vector<VehicleControlInput>& control_inputs, double timestep) = 0; // Defined as pure virtual function
 
+      /**
+       * @brief Predict vehicle motion assuming no change in control input returning only every output_stride-th state
+       * 
+       * The default implementation decimates the output of the full predict function.
+       * Models should override this function so only the returned states are stored and converted.
+       * 
+       * @param initial_state The starting state of the vehicle
+       * @param timestep The integration time increment
+       * @param delta_t The time to project the motion forward for
+       * @param output_stride The number of integration steps between returned states. The final state is always returned. A value of 0 is treated as 1
+       * 
+       * @return A list of traversed states seperated by output_stride * timestep excluding the initial state
+       * 
+       */
+      virtual std::vector<VehicleState> predict(const VehicleState& initial_state,
+        double timestep, double delta_t, size_t output_stride) {
+
+        return decimate(predict(initial_state, timestep, delta_t), output_stride);
+      }
+
+      /**
+       * @brief Predict vehicle motion given a starting state and list of control inputs returning only every output_stride-th state
+       * 
+       * The default implementation decimates the output of the full predict function.
+       * Models should override this function so only the returned states are stored and converted.
+       * 
+       * @param initial_state The starting state of the vehicle
+       * @param control_inputs A list of control inputs seperated by the provided timestep
+       * @param timestep The integration time increment and the time between provided control inputs
+       * @param output_stride The number of integration steps between returned states. The final state is always returned. A value of 0 is treated as 1
+       * 
+       * @return A list of traversed states seperated by output_stride * timestep excluding the initial state
+       * 
+       */
+      virtual std::vector<VehicleState> predict(const VehicleState& initial_state,
+        const std::vector<VehicleControlInput>& control_inputs, double timestep, size_t output_stride) {
+
+        return decimate(predict(initial_state, control_inputs, timestep), output_stride);
+      }
+
+      /**
+       * @brief Predict vehicle motion given a starting state and a list of control change points
+       * 
+       * Each control input remains active until the next change point so sparse controller output does not need to be
+       * expanded into one control input per timestep. Steps before the first change point use the previous commands of the initial state.
+       * The default implementation expands the change points and calls the list based predict function.
+       * Models should override this function so the cost of handling controls scales with the number of change points.
+       * 
+       * @param initial_state The starting state of the vehicle
+       * @param control_changes A list of control change points sorted by time
+       * @param timestep The time increment between returned traversed states
+       * @param delta_t The time to project the motion forward for
+       * 
+       * @return A list of traversed states seperated by the timestep excluding the initial state
+       * 
+       */
+      virtual std::vector<VehicleState> predict(const VehicleState& initial_state,
+        const std::vector<TimedControlInput>& control_changes, double timestep, double delta_t) {
+
+        VehicleControlInput initial_control;
+        initial_control.target_steering_angle = initial_state.prev_steering_cmd;
+        initial_control.target_velocity = initial_state.prev_vel_cmd;
+
+        // Ensure we run at least 1 step
+        const size_t num_steps = delta_t <= timestep ? 1 : static_cast<size_t>(delta_t / timestep);
+
+        ControlChangeCursor cursor(control_changes, initial_control, timestep);
+        std::vector<VehicleControlInput> control_inputs;
+        control_inputs.reserve(num_steps);
+        for (size_t i = 0; i < num_steps; i++) {
+          control_inputs.push_back(cursor.controlForStep(i));
+        }
+
+        return predict(initial_state, control_inputs, timestep);
+      }
+
+      /**
+       * @brief Predict vehicle motion given a starting state and a list of control change points returning only every output_stride-th state
+       * 
+       * The default implementation decimates the output of the full change point predict function.
+       * Models should override this function so only the returned states are stored and converted.
+       * 
+       * @param initial_state The starting state of the vehicle
+       * @param control_changes A list of control change points sorted by time
+       * @param timestep The integration time increment
+       * @param delta_t The time to project the motion forward for
+       * @param output_stride The number of integration steps between returned states. The final state is always returned. A value of 0 is treated as 1
+       * 
+       * @return A list of traversed states seperated by output_stride * timestep excluding the initial state
+       * 
+       */
+      virtual std::vector<VehicleState> predict(const VehicleState& initial_state,
+        const std::vector<TimedControlInput>& control_changes, double timestep, double delta_t, size_t output_stride) {
+
+        return decimate(predict(initial_state, control_changes, timestep, delta_t), output_stride);
+      }
+
+      /**
+       * @brief Predict vehicle motion assuming no change in control input returning only the reduced state
+       * 
+       * The default implementation converts the output of the full predict function.
+       * Models should override this function to skip computing and storing unused fields.
+       * 
+       * @param initial_state The starting state of the vehicle
+       * @param timestep The time increment between returned traversed states
+       * @param delta_t The time to project the motion forward for
+       * 
+       * @return A list of traversed reduced states seperated by the timestep excluding the initial state
+       * 
+       */
+      virtual std::vector<ReducedVehicleState> predictReduced(const VehicleState& initial_state,
+        double timestep, double delta_t) {
+
+        std::vector<VehicleState> states = predict(initial_state, timestep, delta_t);
+        return std::vector<ReducedVehicleState>(states.begin(), states.end());
+      }
+
+      /**
+       * @brief Predict vehicle motion given a starting state and list of control inputs returning only the reduced state
+       * 
+       * The default implementation converts the output of the full predict function.
+       * Models should override this function to skip computing and storing unused fields.
+       * 
+       * @param initial_state The starting state of the vehicle
+       * @param control_inputs A list of control inputs seperated by the provided timestep
+       * @param timestep The time increment between returned traversed states and provided control inputs
+       * 
+       * @return A list of traversed reduced states seperated by the timestep excluding the initial state
+       * 
+       */
+      virtual std::vector<ReducedVehicleState> predictReduced(const VehicleState& initial_state,
+        const std::vector<VehicleControlInput>& control_inputs, double timestep) {
+
+        std::vector<VehicleState> states = predict(initial_state, control_inputs, timestep);
+        return std::vector<ReducedVehicleState>(states.begin(), states.end());
+      }
+
+      /**
+       * @brief Predict the vehicle state after a single timestep of the provided control input
+       *
+       * Used by lazily evaluated trajectories which compute one state at a time.
+       * The default implementation calls the list based predict function with a single control input.
+       * This requires the model to be able to resume a prediction from one of its own output states.
+       * It creates a control and a result vector on every call so models should override it with a single integration step.
+       * The passenger car models do so and the default is kept for plugins which do not.
+       *
+       * @param initial_state The starting state of the vehicle
+       * @param control_input The control input applied over the timestep
+       * @param timestep The time increment to integrate over
+       *
+       * @return The state of the vehicle after the timestep
+       *
+       */
+      virtual VehicleState predictStep(const VehicleState& initial_state,
+        const VehicleControlInput& control_input, double timestep) {
+
+        return predict(initial_state, std::vector<VehicleControlInput>(1, control_input), timestep).back();
+      }
+
+      /**
+       * @brief Predict vehicle motion given a starting state and control inputs writing the traversed states into a caller provided buffer
+       *
+       * Used by the real-time prediction path of lib_vehicle_model.
+       * Models which return true from isRealTimeSafe() must not allocate memory, take locks or throw from this function
+       * once reserveRealTime() has been called on the same instance.
+       * The default implementation calls the list based predict function and is therefore not real-time safe.
+       *
+       * @param initial_state The starting state of the vehicle
+       * @param control_inputs An array of count control inputs seperated by the provided timestep
+       * @param count The number of control inputs and the number of states written to output
+       * @param timestep The time increment between traversed states and provided control inputs
+       * @param output An array of at least count states which will hold the traversed states excluding the initial state
+       *
+       * @return True if the prediction succeeded. If false the contents of output are unspecified
+       *
+       */
+      virtual bool predictInto(const VehicleState& initial_state,
+        const VehicleControlInput* control_inputs, size_t count, double timestep, VehicleState* output) noexcept {
+
+        try {
+          std::vector<VehicleState> states = predict(initial_state, std::vector<VehicleControlInput>(control_inputs, control_inputs + count), timestep);
+          if (states.size() != count) {
+            return false;
+          }
+          std::copy(states.begin(), states.end(), output);
+          return true;
+        } catch (...) {
+          return false;
+        }
+      }
+
+      /**
+       * @brief Allocates any buffers needed by predictInto so that later calls do not allocate memory
+       *
+       * Called on each thread's model instance before it is used for real-time predictions.
+       * The default implementation does nothing.
+       *
+       * @param max_horizon The largest number of control inputs which will be passed to predictInto
+       *
+       */
+      virtual void reserveRealTime(size_t max_horizon) {}
+
+      /**
+       * @brief Returns true if predictInto is free of memory allocation, locks and exceptions after reserveRealTime() has been called
+       *
+       */
+      virtual bool isRealTimeSafe() const {
+        return false;
+      }
+
+      /**
+       * @brief Creates an independent copy of this model with the same parameters
+       *
+       * The copy must not share any mutable state with this instance so that each copy can be used by a different thread.
+       * The default implementation returns nullptr indicating the model cannot be cloned, in which case callers fall back to sharing this instance.
+       *
+       * @return A new instance of this model or nullptr if cloning is not supported
+       *
+       */
+      virtual std::shared_ptr<VehicleMotionModel> clone() const {
+        return nullptr;
+      }
+
+      /**
+       * @brief Returns true if concurrent calls to the predict functions of a single instance are safe
+       *
+       * Stateless models are shared between threads instead of being cloned.
+       *
+       * @return True if this model holds no state which is modified during prediction
+       *
+       */
+      virtual bool isStateless() const {
+        return false;
+      }
+
+      /**
+       * @brief Returns true if predictions are unaffected by translating and rotating the global frame
+       *
+       * For such models a prediction from any pose equals the prediction from the same body frame state at the origin with
+       * orientation 0 followed by a rigid transform of the output. This allows results to be reused between poses.
+       *
+       * @return True if the model dynamics only depend on the global pose through the integration of position and orientation
+       *
+       */
+      virtual bool isFrameInvariant() const {
+        return false;
+      }
+
       /**
        * @brief Set the parameter server which will be used by vehicle models
        * 
@@ -67,5 +320,33 @@ namespace lib_vehicle_model {
        * 
        */
       virtual void setParameterServer(std::shared_ptr<ParameterServer> parameter_server) = 0; // Defined as pure virtual function
+
+    protected:
+      /**
+       * @brief Helper function which keeps every output_stride-th state and the final state of the provided list
+       * 
+       * @param states The full list of traversed states
+       * @param output_stride The number of states between kept states. A value of 0 is treated as 1
+       * 
+       * @return The decimated list of states
+       */
+      static std::vector<VehicleState> decimate(const std::vector<VehicleState>& states, size_t output_stride) {
+        if (output_stride <= 1) {
+          return states;
+        }
+
+        std::vector<VehicleState> decimated;
+        decimated.reserve(states.size() / output_stride + 1);
+        for (size_t i = output_stride - 1; i < states.size(); i += output_stride) {
+          decimated.push_back(states[i]);
+        }
+
+        // Always include the final state
+        if (!states.empty() && states.size() % output_stride != 0) {
+          decimated.push_back(states.back());
+        }
+
+        return decimated;
+      }
   };
 }
\ No newline at end of file
@@ -0,0 +1,502 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+
+#include <math.h>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include "lib_vehicle_model/KinematicsSolver.h"
+
+// CPP File containing the implementations of the template functions in the KinematicsSolver namespace
+namespace lib_vehicle_model {
+  namespace KinematicsSolver
+  {
+    // Private namespace
+    namespace {
+
+      /**
+       * @brief Helper function to check that the provided value is non-negative
+       * 
+       * This function should be used to check v_i,v_f,d,and t values are positive
+       * 
+       * @throws std::domain_error if the provided value is negative
+       */ 
+      inline void checkIsPositive(const double& val, const KinematicsProperty& prop) {
+        if (val < 0.0) {
+          std::ostringstream stream;
+          stream << "Invalid property value: " << prop << " cannot be negative";
+          throw std::domain_error(stream.str());
+        }
+      }
+
+      /**
+       * @brief Helper function to check if the change in velocity matches the direction of acceleration
+       * 
+       * @param v_i Initial velocity
+       * @param v_f Final velocity
+       * @param a Acceleration
+       * 
+       * @throws std::domain_error if the provided value is negative
+       */ 
+      inline void checkDeltaVAndAccelMatch(const double& v_i, const double& v_f, const double& a) {
+        if ((a > 0 && v_i > v_f)
+          || (a < 0 && v_i < v_f)
+          || (a == 0 && v_i != v_f)) {
+            std::ostringstream stream;
+            stream << "Impossible acceleration and velocity combination v_i = " << v_i << " v_f = " << v_f << " a = " << a;
+            throw std::domain_error(stream.str());
+        }
+      }
+
+      /**
+       * @brief Helper function to check that the term under a square root is non-negative
+       * 
+       * @param inner_term The term under the square root
+       * @param velocity_name The name of the velocity used in the error message
+       * @param v The provided velocity
+       * @param a Acceleration
+       * @param d Distance
+       * 
+       * @throws std::domain_error if the inner term is negative
+       */ 
+      inline void checkDiscontinuity(const double& inner_term, const char* velocity_name, const double& v, const double& a, const double& d) {
+        if (inner_term < 0) {
+          std::ostringstream stream;
+          stream << "Discontinuity in calculation with " << velocity_name << " = " << v << " a = " << a << " d = " << d;
+          throw std::domain_error(stream.str());
+        }
+      }
+
+      /**
+       * @brief Branch free forms of the checks above which return the matching KinematicsError flag as an unsigned int or 0
+       * 
+       * These are used by the batched solve functions so their loops can be vectorised
+       */ 
+      inline unsigned int negativeFlag(const double& val) {
+        return (val < 0.0) ? static_cast<unsigned int>(KinematicsError::NEGATIVE_INPUT) : 0u;
+      }
+
+      inline unsigned int discontinuityFlag(const double& inner_term) {
+        return (inner_term < 0.0) ? static_cast<unsigned int>(KinematicsError::DISCONTINUITY) : 0u;
+      }
+
+      inline unsigned int signMismatchFlag(const double& v_i, const double& v_f, const double& a) {
+        const bool mismatch = ((a > 0) & (v_i > v_f)) | ((a < 0) & (v_i < v_f)) | ((a == 0) & (v_i != v_f));
+        return mismatch ? static_cast<unsigned int>(KinematicsError::SIGN_MISMATCH) : 0u;
+      }
+
+      /**
+       * @brief The kinematic equation solving for Out without using Unavailable
+       * 
+       * Each specialization provides
+       *   check(prop1, prop2, prop3) which throws std::domain_error if the properties are outside the domain of the equation
+       *   status(prop1, prop2, prop3) which returns the KinematicsError flags of the same checks without branching
+       *   evaluate(prop1, prop2, prop3) which returns the result without any checks
+       * 
+       * The primary template is left undefined so unsupported combinations fail to compile
+       */
+      template<KinematicsProperty Out, KinematicsProperty Unavailable>
+      struct Equation;
+
+      //
+      // Solve for initial velocity
+      //
+      template<>
+      struct Equation<KinematicsProperty::INITIAL_VELOCITY, KinematicsProperty::FINAL_VELOCITY> {
+        // Prop Order: a,d,t
+        static void check(const double& /*a*/, const double& d, const double& t) {
+          checkIsPositive(d, KinematicsProperty::DISTANCE);
+          checkIsPositive(t, KinematicsProperty::TIME);
+        }
+        static unsigned int status(const double& /*a*/, const double& d, const double& t) {
+          return negativeFlag(d) | negativeFlag(t);
+        }
+        // v_i = (d/t) - (0.5*a*t)
+        static double evaluate(const double& a, const double& d, const double& t) {
+          return (d / t) - (0.5 * a * t);
+        }
+      };
+
+      template<>
+      struct Equation<KinematicsProperty::INITIAL_VELOCITY, KinematicsProperty::ACCELERATION> {
+        // Prop Order: v_f,d,t
+        static void check(const double& v_f, const double& d, const double& t) {
+          checkIsPositive(v_f, KinematicsProperty::FINAL_VELOCITY);
+          checkIsPositive(d, KinematicsProperty::DISTANCE);
+          checkIsPositive(t, KinematicsProperty::TIME);
+        }
+        static unsigned int status(const double& v_f, const double& d, const double& t) {
+          return negativeFlag(v_f) | negativeFlag(d) | negativeFlag(t);
+        }
+        // v_i = (2*d/t) - v_f
+        static double evaluate(const double& v_f, const double& d, const double& t) {
+          return (2 * d / t) - v_f;
+        }
+      };
+
+      template<>
+      struct Equation<KinematicsProperty::INITIAL_VELOCITY, KinematicsProperty::DISTANCE> {
+        // Prop Order: v_f,a,t
+        static void check(const double& v_f, const double& /*a*/, const double& t) {
+          checkIsPositive(v_f, KinematicsProperty::FINAL_VELOCITY);
+          checkIsPositive(t, KinematicsProperty::TIME);
+        }
+        static unsigned int status(const double& v_f, const double& /*a*/, const double& t) {
+          return negativeFlag(v_f) | negativeFlag(t);
+        }
+        // v_i = v_f - a * t
+        static double evaluate(const double& v_f, const double& a, const double& t) {
+          return v_f - (a * t);
+        }
+      };
+
+      template<>
+      struct Equation<KinematicsProperty::INITIAL_VELOCITY, KinematicsProperty::TIME> {
+        // Prop Order: v_f,a,d
+        static void check(const double& v_f, const double& a, const double& d) {
+          checkIsPositive(v_f, KinematicsProperty::FINAL_VELOCITY);
+          checkIsPositive(d, KinematicsProperty::DISTANCE);
+          checkDiscontinuity(v_f*v_f - 2*a*d, "v_f", v_f, a, d);
+        }
+        static unsigned int status(const double& v_f, const double& a, const double& d) {
+          return negativeFlag(v_f) | negativeFlag(d) | discontinuityFlag(v_f*v_f - 2*a*d);
+        }
+        // v_i = sqrt(v_f^2 - 2*a*d)
+        static double evaluate(const double& v_f, const double& a, const double& d) {
+          return sqrt(v_f*v_f - 2*a*d); // Take positive vi as that is a requirement of this function
+        }
+      };
+
+      //
+      // Solve for final velocity
+      //
+      template<>
+      struct Equation<KinematicsProperty::FINAL_VELOCITY, KinematicsProperty::INITIAL_VELOCITY> {
+        // Prop Order: a,d,t
+        static void check(const double& /*a*/, const double& d, const double& t) {
+          checkIsPositive(d, KinematicsProperty::DISTANCE);
+          checkIsPositive(t, KinematicsProperty::TIME);
+        }
+        static unsigned int status(const double& /*a*/, const double& d, const double& t) {
+          return negativeFlag(d) | negativeFlag(t);
+        }
+        // v_f = d/t + 0.5*a*t
+        static double evaluate(const double& a, const double& d, const double& t) {
+          return (d / t) + (0.5 * a * t);
+        }
+      };
+
+      template<>
+      struct Equation<KinematicsProperty::FINAL_VELOCITY, KinematicsProperty::ACCELERATION> {
+        // Prop Order: v_i,d,t
+        static void check(const double& v_i, const double& d, const double& t) {
+          checkIsPositive(v_i, KinematicsProperty::INITIAL_VELOCITY);
+          checkIsPositive(d, KinematicsProperty::DISTANCE);
+          checkIsPositive(t, KinematicsProperty::TIME);
+        }
+        static unsigned int status(const double& v_i, const double& d, const double& t) {
+          return negativeFlag(v_i) | negativeFlag(d) | negativeFlag(t);
+        }
+        // v_f = 2*d/t - v_i
+        static double evaluate(const double& v_i, const double& d, const double& t) {
+          return (2 * d / t) - v_i;
+        }
+      };
+
+      template<>
+      struct Equation<KinematicsProperty::FINAL_VELOCITY, KinematicsProperty::DISTANCE> {
+        // Prop Order: v_i,a,t
+        static void check(const double& v_i, const double& /*a*/, const double& t) {
+          checkIsPositive(v_i, KinematicsProperty::INITIAL_VELOCITY);
+          checkIsPositive(t, KinematicsProperty::TIME);
+        }
+        static unsigned int status(const double& v_i, const double& /*a*/, const double& t) {
+          return negativeFlag(v_i) | negativeFlag(t);
+        }
+        // v_f = v_i + a*t
+        static double evaluate(const double& v_i, const double& a, const double& t) {
+          return v_i + (a * t);
+        }
+      };
+
+      template<>
+      struct Equation<KinematicsProperty::FINAL_VELOCITY, KinematicsProperty::TIME> {
+        // Prop Order: v_i,a,d
+        static void check(const double& v_i, const double& a, const double& d) {
+          checkIsPositive(v_i, KinematicsProperty::INITIAL_VELOCITY);
+          checkIsPositive(d, KinematicsProperty::DISTANCE);
+          checkDiscontinuity(v_i*v_i + 2*a*d, "v_i", v_i, a, d);
+        }
+        static unsigned int status(const double& v_i, const double& a, const double& d) {
+          return negativeFlag(v_i) | negativeFlag(d) | discontinuityFlag(v_i*v_i + 2*a*d);
+        }
+        // v_f = sqrt(v_i^2 + 2*a*d)
+        static double evaluate(const double& v_i, const double& a, const double& d) {
+          return sqrt(v_i*v_i + 2*a*d); // Take positive v_f as that is a requirement of this function
+        }
+      };
+
+      //
+      // Solve for acceleration
+      //
+      template<>
+      struct Equation<KinematicsProperty::ACCELERATION, KinematicsProperty::INITIAL_VELOCITY> {
+        // Prop Order: v_f,d,t
+        static void check(const double& v_f, const double& d, const double& t) {
+          checkIsPositive(v_f, KinematicsProperty::FINAL_VELOCITY);
+          checkIsPositive(d, KinematicsProperty::DISTANCE);
+          checkIsPositive(t, KinematicsProperty::TIME);
+        }
+        static unsigned int status(const double& v_f, const double& d, const double& t) {
+          return negativeFlag(v_f) | negativeFlag(d) | negativeFlag(t);
+        }
+        // a = (2/t) * (v_f - (d/t))
+        static double evaluate(const double& v_f, const double& d, const double& t) {
+          return (2 / t) * (v_f - (d / t));
+        }
+      };
+
+      template<>
+      struct Equation<KinematicsProperty::ACCELERATION, KinematicsProperty::FINAL_VELOCITY> {
+        // Prop Order: v_i,d,t
+        static void check(const double& v_i, const double& d, const double& t) {
+          checkIsPositive(v_i, KinematicsProperty::INITIAL_VELOCITY);
+          checkIsPositive(d, KinematicsProperty::DISTANCE);
+          checkIsPositive(t, KinematicsProperty::TIME);
+        }
+        static unsigned int status(const double& v_i, const double& d, const double& t) {
+          return negativeFlag(v_i) | negativeFlag(d) | negativeFlag(t);
+        }
+        // a = (2/t) * (d/t - v_i)
+        static double evaluate(const double& v_i, const double& d, const double& t) {
+          return (2 / t) * ((d / t) - v_i);
+        }
+      };
+
+      template<>
+      struct Equation<KinematicsProperty::ACCELERATION, KinematicsProperty::DISTANCE> {
+        // Prop Order: v_i,v_f,t
+        static void check(const double& v_i, const double& v_f, const double& t) {
+          checkIsPositive(v_i, KinematicsProperty::INITIAL_VELOCITY);
+          checkIsPositive(v_f, KinematicsProperty::FINAL_VELOCITY);
+          checkIsPositive(t, KinematicsProperty::TIME);
+        }
+        static unsigned int status(const double& v_i, const double& v_f, const double& t) {
+          return negativeFlag(v_i) | negativeFlag(v_f) | negativeFlag(t);
+        }
+        // a = (v_f - v_i) / t
+        static double evaluate(const double& v_i, const double& v_f, const double& t) {
+          return (v_f - v_i) / t;
+        }
+      };
+
+      template<>
+      struct Equation<KinematicsProperty::ACCELERATION, KinematicsProperty::TIME> {
+        // Prop Order: v_i,v_f,d
+        static void check(const double& v_i, const double& v_f, const double& d) {
+          checkIsPositive(v_i, KinematicsProperty::INITIAL_VELOCITY);
+          checkIsPositive(v_f, KinematicsProperty::FINAL_VELOCITY);
+          checkIsPositive(d, KinematicsProperty::DISTANCE);
+        }
+        static unsigned int status(const double& v_i, const double& v_f, const double& d) {
+          return negativeFlag(v_i) | negativeFlag(v_f) | negativeFlag(d);
+        }
+        // a = (v_f^2 - v_i^2) / (2*d)
+        static double evaluate(const double& v_i, const double& v_f, const double& d) {
+          return (v_f*v_f - v_i*v_i) / (2 * d);
+        }
+      };
+
+      //
+      // Solve for distance
+      //
+      template<>
+      struct Equation<KinematicsProperty::DISTANCE, KinematicsProperty::INITIAL_VELOCITY> {
+        // Prop Order: v_f,a,t
+        static void check(const double& v_f, const double& /*a*/, const double& t) {
+          checkIsPositive(v_f, KinematicsProperty::FINAL_VELOCITY);
+          checkIsPositive(t, KinematicsProperty::TIME);
+        }
+        static unsigned int status(const double& v_f, const double& /*a*/, const double& t) {
+          return negativeFlag(v_f) | negativeFlag(t);
+        }
+        // d = v_f*t - 0.5*a*t^2
+        static double evaluate(const double& v_f, const double& a, const double& t) {
+          return (v_f * t) - (0.5 * a * t * t);
+        }
+      };
+
+      template<>
+      struct Equation<KinematicsProperty::DISTANCE, KinematicsProperty::FINAL_VELOCITY> {
+        // Prop Order: v_i,a,t
+        static void check(const double& v_i, const double& /*a*/, const double& t) {
+          checkIsPositive(v_i, KinematicsProperty::INITIAL_VELOCITY);
+          checkIsPositive(t, KinematicsProperty::TIME);
+        }
+        static unsigned int status(const double& v_i, const double& /*a*/, const double& t) {
+          return negativeFlag(v_i) | negativeFlag(t);
+        }
+        // d = v_i*t + 0.5*a*t^2
+        static double evaluate(const double& v_i, const double& a, const double& t) {
+          return (v_i * t) + (0.5 * a * t * t);
+        }
+      };
+
+      template<>
+      struct Equation<KinematicsProperty::DISTANCE, KinematicsProperty::ACCELERATION> {
+        // Prop Order: v_i,v_f,t
+        static void check(const double& v_i, const double& v_f, const double& t) {
+          checkIsPositive(v_i, KinematicsProperty::INITIAL_VELOCITY);
+          checkIsPositive(v_f, KinematicsProperty::FINAL_VELOCITY);
+          checkIsPositive(t, KinematicsProperty::TIME);
+        }
+        static unsigned int status(const double& v_i, const double& v_f, const double& t) {
+          return negativeFlag(v_i) | negativeFlag(v_f) | negativeFlag(t);
+        }
+        // d = (v_i + v_f)*t / 2
+        static double evaluate(const double& v_i, const double& v_f, const double& t) {
+          return (v_i + v_f) * t / 2;
+        }
+      };
+
+      template<>
+      struct Equation<KinematicsProperty::DISTANCE, KinematicsProperty::TIME> {
+        // Prop Order: v_i,v_f,a
+        static void check(const double& v_i, const double& v_f, const double& a) {
+          checkIsPositive(v_i, KinematicsProperty::INITIAL_VELOCITY);
+          checkIsPositive(v_f, KinematicsProperty::FINAL_VELOCITY);
+          checkDeltaVAndAccelMatch(v_i, v_f, a);
+        }
+        static unsigned int status(const double& v_i, const double& v_f, const double& a) {
+          return negativeFlag(v_i) | negativeFlag(v_f) | signMismatchFlag(v_i, v_f, a);
+        }
+        // d = (v_f^2 - v_i^2) / 2*a
+        static double evaluate(const double& v_i, const double& v_f, const double& a) {
+          return (v_f*v_f - v_i*v_i) / (2 * a);
+        }
+      };
+
+      //
+      // Solve for time
+      //
+      template<>
+      struct Equation<KinematicsProperty::TIME, KinematicsProperty::INITIAL_VELOCITY> {
+        // Prop Order: v_f,a,d
+        static void check(const double& v_f, const double& a, const double& d) {
+          checkIsPositive(v_f, KinematicsProperty::FINAL_VELOCITY);
+          checkIsPositive(d, KinematicsProperty::DISTANCE);
+          checkDiscontinuity(v_f*v_f - 2*a*d, "v_f", v_f, a, d);
+        }
+        static unsigned int status(const double& v_f, const double& a, const double& d) {
+          return negativeFlag(v_f) | negativeFlag(d) | discontinuityFlag(v_f*v_f - 2*a*d);
+        }
+        // t = (v_f - sqrt(v_f^2 - 2*a*d)) / a
+        static double evaluate(const double& v_f, const double& a, const double& d) {
+          const double pos_vi = sqrt(v_f*v_f - 2*a*d); // Take positive vi as that is a requirement of this function
+          return (v_f - pos_vi) / a;
+        }
+      };
+
+      template<>
+      struct Equation<KinematicsProperty::TIME, KinematicsProperty::FINAL_VELOCITY> {
+        // Prop Order: v_i,a,d
+        static void check(const double& v_i, const double& a, const double& d) {
+          checkIsPositive(v_i, KinematicsProperty::INITIAL_VELOCITY);
+          checkIsPositive(d, KinematicsProperty::DISTANCE);
+          checkDiscontinuity(v_i*v_i + 2*a*d, "v_f", v_i, a, d);
+        }
+        static unsigned int status(const double& v_i, const double& a, const double& d) {
+          return negativeFlag(v_i) | negativeFlag(d) | discontinuityFlag(v_i*v_i + 2*a*d);
+        }
+        // t = (sqrt(v_i^2 + 2*a*d) - v_i) / a
+        static double evaluate(const double& v_i, const double& a, const double& d) {
+          const double v_f_pos = sqrt(v_i*v_i + 2*a*d); // Take v_f as positive since that is a requirement of this function
+          return (v_f_pos - v_i) / a;
+        }
+      };
+
+      template<>
+      struct Equation<KinematicsProperty::TIME, KinematicsProperty::ACCELERATION> {
+        // Prop Order: v_i,v_f,d
+        static void check(const double& v_i, const double& v_f, const double& d) {
+          checkIsPositive(v_i, KinematicsProperty::INITIAL_VELOCITY);
+          checkIsPositive(v_f, KinematicsProperty::FINAL_VELOCITY);
+          checkIsPositive(d, KinematicsProperty::DISTANCE);
+        }
+        static unsigned int status(const double& v_i, const double& v_f, const double& d) {
+          return negativeFlag(v_i) | negativeFlag(v_f) | negativeFlag(d);
+        }
+        // t = (2*d) / (v_i+v_f)
+        static double evaluate(const double& v_i, const double& v_f, const double& d) {
+          return (2 * d) / (v_i + v_f);
+        }
+      };
+
+      template<>
+      struct Equation<KinematicsProperty::TIME, KinematicsProperty::DISTANCE> {
+        // Prop Order: v_i,v_f,a
+        static void check(const double& v_i, const double& v_f, const double& a) {
+          checkIsPositive(v_i, KinematicsProperty::INITIAL_VELOCITY);
+          checkIsPositive(v_f, KinematicsProperty::FINAL_VELOCITY);
+          checkDeltaVAndAccelMatch(v_i, v_f, a);
+        }
+        static unsigned int status(const double& v_i, const double& v_f, const double& a) {
+          return negativeFlag(v_i) | negativeFlag(v_f) | signMismatchFlag(v_i, v_f, a);
+        }
+        // t = (v_f - v_i) / a
+        static double evaluate(const double& v_i, const double& v_f, const double& a) {
+          return (v_f - v_i) / a;
+        }
+      };
+    }
+
+    template<KinematicsProperty Out, KinematicsProperty Unavailable, bool CheckRanges>
+    double solve(const double& prop1, const double& prop2, const double& prop3) {
+      if (CheckRanges) {
+        Equation<Out, Unavailable>::check(prop1, prop2, prop3);
+      }
+      return Equation<Out, Unavailable>::evaluate(prop1, prop2, prop3);
+    }
+
+    template<KinematicsProperty Out, KinematicsProperty Unavailable>
+    KinematicsResult trySolve(const double& prop1, const double& prop2, const double& prop3) noexcept {
+      KinematicsResult result;
+      result.error = static_cast<KinematicsError>(Equation<Out, Unavailable>::status(prop1, prop2, prop3));
+      if (result.ok()) {
+        result.value = Equation<Out, Unavailable>::evaluate(prop1, prop2, prop3);
+      }
+      return result;
+    }
+
+    template<KinematicsProperty Out, KinematicsProperty Unavailable>
+    void solve(const double* prop1, const double* prop2, const double* prop3, size_t count,
+      double* results, KinematicsError* errors) noexcept {
+
+      // Every element is both checked and evaluated and the result is selected without a branch so the loop can be vectorised
+      for (size_t i = 0; i < count; i++) {
+        const double p1 = prop1[i];
+        const double p2 = prop2[i];
+        const double p3 = prop3[i];
+        const unsigned int flags = Equation<Out, Unavailable>::status(p1, p2, p3);
+        const double value = Equation<Out, Unavailable>::evaluate(p1, p2, p3);
+
+        results[i] = flags ? std::numeric_limits<double>::quiet_NaN() : value;
+        errors[i] = static_cast<KinematicsError>(flags);
+      }
+    }
+  }
+}
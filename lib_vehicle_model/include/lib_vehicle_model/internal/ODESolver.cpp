@@ -68,9 +68,13 @@ namespace lib_vehicle_model {
         std::vector<std::tuple<double, State>>& outputs;
         ODEFunctor<C,T>& ode_functor_obj;
         ControlWrapper<C>& current_control_;
+        size_t num_steps_;
+        size_t output_stride_;
+        size_t step_count_ = 0;
 
-        PostStepFunctor(const PostStepFunction<C, T>& post_step_func, ODEFunctor<C,T>& ode_functor, std::vector<C>& controls, T& tracker, const State& prev_final_state, std::vector<std::tuple<double, State>>& output_vec, ControlWrapper<C>& control_wrapper) :  
-          post_step_function(std::move(post_step_func)), control_inputs(controls), prev_final_state(prev_final_state), outputs(output_vec), ode_functor_obj(ode_functor), current_control_(control_wrapper)
+        PostStepFunctor(const PostStepFunction<C, T>& post_step_func, ODEFunctor<C,T>& ode_functor, std::vector<C>& controls, T& tracker, const State& prev_final_state, std::vector<std::tuple<double, State>>& output_vec, ControlWrapper<C>& control_wrapper, size_t num_steps, size_t output_stride) :  
+          post_step_function(std::move(post_step_func)), control_inputs(controls), prev_final_state(prev_final_state), outputs(output_vec), ode_functor_obj(ode_functor), current_control_(control_wrapper),
+          num_steps_(num_steps), output_stride_(output_stride == 0 ? 1 : output_stride)
         {
           current_control_.control = controls[0]; // Set initial control input
           ode_functor_obj.setControlInputPtr(&current_control_); // Set control address
@@ -84,18 +88,22 @@ namespace lib_vehicle_model {
             return;
           }
 
-          // Call the post step function
+          step_count_++;
+
+          // Call the post step function with the control which was applied during this step
           State updated_state;
 
-          post_step_function(current, control_inputs[outputs.size()], ode_functor_obj.tracker_, t, prev_final_state, updated_state);
+          post_step_function(current, current_control_.control, ode_functor_obj.tracker_, t, prev_final_state, updated_state);
           prev_final_state = updated_state;
 
-          // Set the final output
-          outputs.push_back(std::tuple<double,State>(t, updated_state));
+          // Only record every output_stride_ step and the final step
+          if (step_count_ % output_stride_ == 0 || step_count_ == num_steps_) {
+            outputs.push_back(std::tuple<double,State>(t, updated_state));
+          }
 
           // Update the control value for the next step
-          if (control_inputs.size() > outputs.size()) {
-            current_control_.control = control_inputs[outputs.size()]; // Update the control input
+          if (control_inputs.size() > step_count_) {
+            current_control_.control = control_inputs[step_count_]; // Update the control input
           }
         }
       };
@@ -113,7 +121,8 @@ namespace lib_vehicle_model {
       std::vector<C>& controls,
       std::vector<std::tuple<double, State>>& output,
       const PostStepFunction<C,T>& post_step_func,
-      T& tracker
+      T& tracker,
+      size_t output_stride
     ) {
 
       boost::numeric::odeint::runge_kutta4<State> solver; // Get RK4 solver
@@ -124,7 +133,7 @@ namespace lib_vehicle_model {
       // Wrapper for the control variable
       ControlWrapper<C> control_wrapper;
 
-      PostStepFunctor<C,T> ps_func(post_step_func, ode, controls, tracker, initial_state, output, control_wrapper); // Build post step functor
+      PostStepFunctor<C,T> ps_func(post_step_func, ode, controls, tracker, initial_state, output, control_wrapper, num_steps, output_stride); // Build post step functor
 
       // Intrgrate the function
       boost::numeric::odeint::integrate_n_steps(
@@ -133,5 +142,44 @@ namespace lib_vehicle_model {
         ps_func
       );
     }
+
+    template<typename C, typename T>
+    void rk4Step(const ODEFunction<C,T>& ode_func,
+      const C& control,
+      T& tracker,
+      State& state,
+      double t,
+      double step_size,
+      RK4Workspace& workspace
+    ) {
+      // Coefficients of the classic Runge-Kutta tableau in the same form used by odeint
+      const double half_step = step_size * 0.5;
+      const double b1 = step_size * (1.0 / 6.0);
+      const double b2 = step_size * (1.0 / 3.0);
+      const double b3 = step_size * (1.0 / 3.0);
+      const double b4 = step_size * (1.0 / 6.0);
+      const size_t n = state.size();
+
+      ode_func(state, control, tracker, workspace.k1, t);
+
+      for (size_t i = 0; i < n; i++) {
+        workspace.tmp[i] = state[i] + half_step * workspace.k1[i];
+      }
+      ode_func(workspace.tmp, control, tracker, workspace.k2, t + half_step);
+
+      for (size_t i = 0; i < n; i++) {
+        workspace.tmp[i] = state[i] + half_step * workspace.k2[i];
+      }
+      ode_func(workspace.tmp, control, tracker, workspace.k3, t + half_step);
+
+      for (size_t i = 0; i < n; i++) {
+        workspace.tmp[i] = state[i] + step_size * workspace.k3[i];
+      }
+      ode_func(workspace.tmp, control, tracker, workspace.k4, t + step_size);
+
+      for (size_t i = 0; i < n; i++) {
+        state[i] = state[i] + b1 * workspace.k1[i] + b2 * workspace.k2[i] + b3 * workspace.k3[i] + b4 * workspace.k4[i];
+      }
+    }
   }
 }
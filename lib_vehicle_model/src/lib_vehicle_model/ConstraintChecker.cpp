@@ -15,7 +15,9 @@
  */
 
 #include <stdlib.h> 
+#include <cmath>
 #include "ConstraintChecker.h"
+#include "lib_vehicle_model/Tracing.h"
 
 
 
@@ -24,6 +26,32 @@
  */
 using namespace lib_vehicle_model;
 
+//
+// Private Namespace
+//
+namespace {
+
+  void clearReport(ControlViolationReport& report) {
+    report.violations.clear();
+    report.violation_count = 0;
+    report.first_violation = 0;
+    report.combined = ControlViolation::NONE;
+  }
+
+  /**
+   * Records the violation of one control input. The per control masks are only allocated once a violation is found
+   */
+  void recordViolation(ControlViolationReport& report, size_t index, size_t count, ControlViolation violation) {
+    if (report.violation_count == 0) {
+      report.violations.assign(count, ControlViolation::NONE);
+      report.first_violation = index;
+    }
+    report.violations[index] = violation;
+    report.violation_count++;
+    report.combined |= violation;
+  }
+}
+
 ConstraintChecker::ConstraintChecker(std::shared_ptr<ParameterServer> parameter_server) {
 
   // Load Parameters
@@ -51,27 +79,39 @@ ConstraintChecker::ConstraintChecker(std::shared_ptr<ParameterServer> parameter_
 
     throw std::invalid_argument(msg.str());
   }
+
+  // A negative rate limit can never be met so no control sequence could be valid or sanitized
+  if (!(max_steering_angle_rate_ >= 0)) {
+    std::ostringstream msg;
+    msg << "Invalid max_steering_angle_rate: " << max_steering_angle_rate_ << " must not be negative";
+    throw std::invalid_argument(msg.str());
+  }
 }
 
 void ConstraintChecker::validateInitialState(const VehicleState& initial_state) const {
-  std::ostringstream msg;
+  tracing::ScopedSpan span("ConstraintChecker::validateInitialState", "lib_vehicle_model");
 
+  // The message is only built once a violation is found so valid states do not allocate
   if (initial_state.steering_angle < min_steering_angle_) {
+    std::ostringstream msg;
     msg << "Invalid initial_state with steering angle: " << initial_state.steering_angle << " is below min of: " << min_steering_angle_;
     throw std::invalid_argument(msg.str());
   }
   
   if (initial_state.steering_angle > max_steering_angle_) {
+    std::ostringstream msg;
     msg << "Invalid initial_state with steering angle: " << initial_state.steering_angle << " is above max of: " << max_steering_angle_;
     throw std::invalid_argument(msg.str());
   }
 
   if (initial_state.trailer_angle < min_trailer_angle_) {
+    std::ostringstream msg;
     msg << "Invalid initial_state with trailer angle: " << initial_state.trailer_angle << " is below min of: " << min_trailer_angle_;
     throw std::invalid_argument(msg.str());
   }
 
   if (initial_state.trailer_angle > max_trailer_angle_) {
+    std::ostringstream msg;
     msg << "Invalid initial_state with trailer angle: " << initial_state.trailer_angle << " is above max of: " << max_trailer_angle_;
     throw std::invalid_argument(msg.str());
   }
@@ -80,49 +120,312 @@ void ConstraintChecker::validateInitialState(const VehicleState& initial_state)
 
 void ConstraintChecker::validateControlInputs(const VehicleState& initial_state, const std::vector<VehicleControlInput>& control_inputs, const double timestep) const {
 
-  std::ostringstream msg;
+  tracing::ScopedSpan span("ConstraintChecker::validateControlInputs", "lib_vehicle_model");
+
+  validateControlsFrom(initial_state.steering_angle, control_inputs, timestep);
+}
+
+void ConstraintChecker::validateControlSequence(const std::vector<VehicleControlInput>& control_inputs, const double timestep) const {
+
+  tracing::ScopedSpan span("ConstraintChecker::validateControlSequence", "lib_vehicle_model");
 
   // Check we were given some control inputs
   if (control_inputs.size() == 0) {
-     msg << "Invalid control_inputs: empty vector provided as control inputs";
-     throw std::invalid_argument(msg.str());
+     throw std::invalid_argument("Invalid control_inputs: empty vector provided as control inputs");
+  }
+
+  // Starting from the first steering angle gives the first control a steering rate of 0 as it depends on the initial state
+  validateControlsFrom(control_inputs.front().target_steering_angle, control_inputs, timestep);
+}
+
+void ConstraintChecker::validateInitialSteeringRate(const VehicleState& initial_state, const VehicleControlInput& first_control, const double timestep) const {
+
+  const ControlViolation violation = checkControlInput(first_control, initial_state.steering_angle, timestep) & ControlViolation::STEERING_RATE_ABOVE_MAX;
+  if (violation != ControlViolation::NONE) {
+    throwViolation("control_input", 0, first_control, initial_state.steering_angle, timestep, violation);
+  }
+}
+
+void ConstraintChecker::validateControlsFrom(double initial_steering_angle, const std::vector<VehicleControlInput>& control_inputs, const double timestep) const {
+
+  // Check we were given some control inputs
+  if (control_inputs.size() == 0) {
+     throw std::invalid_argument("Invalid control_inputs: empty vector provided as control inputs");
   }
 
   // Last steering angle used to compute rate of steering angle change between control inputs
-  double last_steer_angle = initial_state.steering_angle;
+  double last_steer_angle = initial_steering_angle;
 
-  size_t count = 0;
   // Validate each control input in sequence
-  for (const VehicleControlInput& control : control_inputs) {
+  for (size_t i = 0; i < control_inputs.size(); i++) {
+    const VehicleControlInput& control = control_inputs[i];
 
-    if (control.target_velocity < min_forward_speed_) {
-      msg << "Invalid control_input " << count << " with target_velocity: " << control.target_velocity << " is below min of: " << min_forward_speed_;
-      throw std::invalid_argument(msg.str());
+    const ControlViolation violation = checkControlInput(control, last_steer_angle, timestep);
+    if (violation != ControlViolation::NONE) {
+      throwViolation("control_input", i, control, last_steer_angle, timestep, violation);
     }
 
-    if (control.target_velocity > max_forward_speed_) {
-      msg << "Invalid control_input " << count << " with target_velocity: " << control.target_velocity << " is above max of: " << max_forward_speed_;
+    last_steer_angle = control.target_steering_angle;
+  }
+}
+
+void ConstraintChecker::validateControlChanges(const VehicleState& initial_state, const std::vector<TimedControlInput>& control_changes, const double timestep) const {
+
+  tracing::ScopedSpan span("ConstraintChecker::validateControlChanges", "lib_vehicle_model");
+
+  // Check we were given some control inputs
+  if (control_changes.size() == 0) {
+     throw std::invalid_argument("Invalid control_changes: empty vector provided as control changes");
+  }
+
+  // Last steering angle used to compute rate of steering angle change between change points
+  double last_steer_angle = initial_state.steering_angle;
+  double last_time = 0.0;
+
+  // Validate each change point in sequence
+  for (size_t i = 0; i < control_changes.size(); i++) {
+    const TimedControlInput& change = control_changes[i];
+
+    if (!(change.time >= last_time)) {
+      std::ostringstream msg;
+      msg << "Invalid control_change " << i << " with time: " << change.time << " is negative or before the previous change at: " << last_time;
       throw std::invalid_argument(msg.str());
     }
 
+    // A change point which a later one overrides in the same step is never applied, so it does not take part in the rate check
+    const bool overridden = i + 1 < control_changes.size()
+      && ControlChangeCursor::firstStep(control_changes[i + 1].time, timestep) == ControlChangeCursor::firstStep(change.time, timestep);
+    const double previous_steer_angle = overridden ? change.control.target_steering_angle : last_steer_angle;
+
+    const ControlViolation violation = checkControlInput(change.control, previous_steer_angle, timestep);
+    if (violation != ControlViolation::NONE) {
+      throwViolation("control_change", i, change.control, previous_steer_angle, timestep, violation);
+    }
+
+    if (!overridden) {
+      last_steer_angle = change.control.target_steering_angle;
+    }
+    last_time = change.time;
+  }
+}
+
+bool ConstraintChecker::isValidInitialState(const VehicleState& initial_state) const noexcept {
+  return initial_state.steering_angle >= min_steering_angle_
+    && initial_state.steering_angle <= max_steering_angle_
+    && initial_state.trailer_angle >= min_trailer_angle_
+    && initial_state.trailer_angle <= max_trailer_angle_;
+}
+
+bool ConstraintChecker::areValidControlInputs(const VehicleState& initial_state, const VehicleControlInput* control_inputs, size_t count, const double timestep) const noexcept {
+
+  if (count == 0 || !control_inputs) {
+    return false;
+  }
+
+  // Last steering angle used to compute rate of steering angle change between control inputs
+  double last_steer_angle = initial_state.steering_angle;
+
+  for (size_t i = 0; i < count; i++) {
+    if (checkControlInput(control_inputs[i], last_steer_angle, timestep) != ControlViolation::NONE) {
+      return false;
+    }
+
+    last_steer_angle = control_inputs[i].target_steering_angle;
+  }
+
+  return true;
+}
+
+bool ConstraintChecker::checkControlInputs(const VehicleState& initial_state, const VehicleControlInput* control_inputs, size_t count,
+  const double timestep, ControlViolationReport& report) const {
+
+  tracing::ScopedSpan span("ConstraintChecker::checkControlInputs", "lib_vehicle_model");
+
+  clearReport(report);
+
+  if (count == 0 || !control_inputs) {
+    return false;
+  }
+
+  // Last steering angle used to compute rate of steering angle change between control inputs
+  double last_steer_angle = initial_state.steering_angle;
+
+  for (size_t i = 0; i < count; i++) {
+    const ControlViolation violation = checkControlInput(control_inputs[i], last_steer_angle, timestep);
+
+    if (violation != ControlViolation::NONE) {
+      recordViolation(report, i, count, violation);
+    }
+
+    last_steer_angle = control_inputs[i].target_steering_angle;
+  }
+
+  return report.violation_count == 0;
+}
+
+bool ConstraintChecker::sanitizeControlInputs(const VehicleState& initial_state, VehicleControlInput* control_inputs, size_t count,
+  const double timestep, ControlViolationReport& report) const {
+
+  tracing::ScopedSpan span("ConstraintChecker::sanitizeControlInputs", "lib_vehicle_model");
+
+  clearReport(report);
+
+  if (count == 0) {
+    return true;
+  }
+
+  if (!control_inputs) {
+    return false;
+  }
+
+  // The largest steering change allowed between successive control inputs
+  const double max_steer_delta = max_steering_angle_rate_ * timestep;
+
+  // Steering rates are measured from the sanitized previous input as that is what will be predicted
+  double last_steer_angle = initial_state.steering_angle;
+
+  for (size_t i = 0; i < count; i++) {
+    VehicleControlInput& control = control_inputs[i];
+    ControlViolation clamped = ControlViolation::NONE;
+
+    if (control.target_velocity < min_forward_speed_) {
+      control.target_velocity = min_forward_speed_;
+      clamped |= ControlViolation::VELOCITY_BELOW_MIN;
+    } else if (control.target_velocity > max_forward_speed_) {
+      control.target_velocity = max_forward_speed_;
+      clamped |= ControlViolation::VELOCITY_ABOVE_MAX;
+    }
+
     if (control.target_steering_angle < min_steering_angle_) {
-      msg << "Invalid control_input " << count << " with target_steering_angle: " << control.target_steering_angle << " is below min of: " << min_steering_angle_;
-      throw std::invalid_argument(msg.str());
+      control.target_steering_angle = min_steering_angle_;
+      clamped |= ControlViolation::STEERING_BELOW_MIN;
+    } else if (control.target_steering_angle > max_steering_angle_) {
+      control.target_steering_angle = max_steering_angle_;
+      clamped |= ControlViolation::STEERING_ABOVE_MAX;
     }
 
-    if (control.target_steering_angle > max_steering_angle_) {
-      msg << "Invalid control_input " << count << " with target_steering_angle: " << control.target_steering_angle << " is above max of: " << max_steering_angle_;
-      throw std::invalid_argument(msg.str());
+    // Project onto the steering rate limit. The previous angle is within the steering limits so the result is as well
+    if (std::fabs((control.target_steering_angle - last_steer_angle) / timestep) > max_steering_angle_rate_) {
+      const double direction = control.target_steering_angle > last_steer_angle ? 1.0 : -1.0;
+      double steer = last_steer_angle + direction * max_steer_delta;
+
+      // Rounding in the rate computation may still put the limit itself out of range so step back until it is accepted
+      while (std::fabs((steer - last_steer_angle) / timestep) > max_steering_angle_rate_) {
+        steer = std::nextafter(steer, last_steer_angle);
+      }
+
+      control.target_steering_angle = steer;
+      clamped |= ControlViolation::STEERING_RATE_ABOVE_MAX;
     }
 
-    const double delta_steer = control.target_steering_angle - last_steer_angle;
-    const double steering_rate = abs(delta_steer / timestep);
-    if (steering_rate > max_steering_angle_rate_) {
-      msg << "Invalid control_input " << count << " with rate of steering change : " << steering_rate << " is above max of: " << max_steering_angle_rate_;
-      throw std::invalid_argument(msg.str());
+    if (clamped != ControlViolation::NONE) {
+      recordViolation(report, i, count, clamped);
     }
 
     last_steer_angle = control.target_steering_angle;
-    count++;
   }
+
+  return report.violation_count == 0;
+}
+
+ControlViolation ConstraintChecker::checkControlInput(const VehicleControlInput& control, double last_steer_angle, const double timestep) const noexcept {
+  ControlViolation violation = ControlViolation::NONE;
+
+  if (control.target_velocity < min_forward_speed_) {
+    violation |= ControlViolation::VELOCITY_BELOW_MIN;
+  }
+
+  if (control.target_velocity > max_forward_speed_) {
+    violation |= ControlViolation::VELOCITY_ABOVE_MAX;
+  }
+
+  if (control.target_steering_angle < min_steering_angle_) {
+    violation |= ControlViolation::STEERING_BELOW_MIN;
+  }
+
+  if (control.target_steering_angle > max_steering_angle_) {
+    violation |= ControlViolation::STEERING_ABOVE_MAX;
+  }
+
+  const double delta_steer = control.target_steering_angle - last_steer_angle;
+  const double steering_rate = std::fabs(delta_steer / timestep);
+  if (steering_rate > max_steering_angle_rate_) {
+    violation |= ControlViolation::STEERING_RATE_ABOVE_MAX;
+  }
+
+  return violation;
+}
+
+ControlViolation ConstraintChecker::checkControlArrays(double initial_steering_angle, const double* target_velocities,
+  const double* target_steering_angles, size_t count, const double timestep) const noexcept {
+
+  if (count == 0) {
+    return ControlViolation::NONE;
+  }
+
+  // Local copies of the limits let the compiler keep them in registers as they cannot alias the inputs
+  const double min_speed = min_forward_speed_;
+  const double max_speed = max_forward_speed_;
+  const double min_steer = min_steering_angle_;
+  const double max_steer = max_steering_angle_;
+  const double max_rate = max_steering_angle_rate_;
+
+  // The first control is rate checked against the initial steering angle
+  unsigned int below_speed = target_velocities[0] < min_speed;
+  unsigned int above_speed = target_velocities[0] > max_speed;
+  unsigned int below_steer = target_steering_angles[0] < min_steer;
+  unsigned int above_steer = target_steering_angles[0] > max_steer;
+  unsigned int above_rate = std::fabs((target_steering_angles[0] - initial_steering_angle) / timestep) > max_rate;
+
+  // Each flag is accumulated with | rather than returning early so the loop has no branches and can be vectorised
+  for (size_t i = 1; i < count; i++) {
+    const double velocity = target_velocities[i];
+    const double steer = target_steering_angles[i];
+
+    below_speed |= velocity < min_speed;
+    above_speed |= velocity > max_speed;
+    below_steer |= steer < min_steer;
+    above_steer |= steer > max_steer;
+    above_rate |= std::fabs((steer - target_steering_angles[i - 1]) / timestep) > max_rate;
+  }
+
+  return static_cast<ControlViolation>(
+    (below_speed ? static_cast<uint8_t>(ControlViolation::VELOCITY_BELOW_MIN) : 0)
+    | (above_speed ? static_cast<uint8_t>(ControlViolation::VELOCITY_ABOVE_MAX) : 0)
+    | (below_steer ? static_cast<uint8_t>(ControlViolation::STEERING_BELOW_MIN) : 0)
+    | (above_steer ? static_cast<uint8_t>(ControlViolation::STEERING_ABOVE_MAX) : 0)
+    | (above_rate ? static_cast<uint8_t>(ControlViolation::STEERING_RATE_ABOVE_MAX) : 0));
+}
+
+void ConstraintChecker::checkControlBatch(const ControlBatch& batch, const double timestep, ControlViolation* results) const noexcept {
+  tracing::ScopedSpan span("ConstraintChecker::checkControlBatch", "lib_vehicle_model");
+
+  for (size_t i = 0; i < batch.sequence_count; i++) {
+    const size_t offset = i * batch.horizon;
+    results[i] = checkControlArrays(batch.initial_steering_angles[i], batch.target_velocities + offset,
+      batch.target_steering_angles + offset, batch.horizon, timestep);
+  }
+}
+
+void ConstraintChecker::throwViolation(const char* input_name, size_t index, const VehicleControlInput& control,
+  double last_steer_angle, const double timestep, ControlViolation violation) const {
+
+  // Report the first violated limit in the order they are checked
+  std::ostringstream msg;
+  msg << "Invalid " << input_name << " " << index;
+
+  if (hasViolation(violation, ControlViolation::VELOCITY_BELOW_MIN)) {
+    msg << " with target_velocity: " << control.target_velocity << " is below min of: " << min_forward_speed_;
+  } else if (hasViolation(violation, ControlViolation::VELOCITY_ABOVE_MAX)) {
+    msg << " with target_velocity: " << control.target_velocity << " is above max of: " << max_forward_speed_;
+  } else if (hasViolation(violation, ControlViolation::STEERING_BELOW_MIN)) {
+    msg << " with target_steering_angle: " << control.target_steering_angle << " is below min of: " << min_steering_angle_;
+  } else if (hasViolation(violation, ControlViolation::STEERING_ABOVE_MAX)) {
+    msg << " with target_steering_angle: " << control.target_steering_angle << " is above max of: " << max_steering_angle_;
+  } else {
+    const double steering_rate = std::fabs((control.target_steering_angle - last_steer_angle) / timestep);
+    msg << " with rate of steering change : " << steering_rate << " is above max of: " << max_steering_angle_rate_;
+  }
+
+  throw std::invalid_argument(msg.str());
 }
@@ -23,6 +23,8 @@
 #include <stdlib.h>
 #include <sstream>
 #include "lib_vehicle_model/VehicleMotionModel.h"
+#include "lib_vehicle_model/ControlViolation.h"
+#include "lib_vehicle_model/ControlBatch.h"
 
 
 namespace lib_vehicle_model {
@@ -42,7 +44,32 @@ namespace lib_vehicle_model {
       double max_trailer_angle_;
       double min_trailer_angle_;
 
+      /**
+       * @brief Returns the mask of limits violated by a single control input
+       * 
+       * @param control The control input to check
+       * @param last_steer_angle The steering angle of the previous control input or initial state
+       * @param timestep The difference in time between successive control inputs in seconds
+       */
+      ControlViolation checkControlInput(const VehicleControlInput& control, double last_steer_angle, const double timestep) const noexcept;
+
+      /**
+       * @brief Validates control inputs with the steering rate of the first computed from the provided steering angle
+       */
+      void validateControlsFrom(double initial_steering_angle, const std::vector<VehicleControlInput>& control_inputs, const double timestep) const;
+
+      /**
+       * @brief Throws a std::invalid_argument describing the first violated limit of a control input
+       */
+      void throwViolation(const char* input_name, size_t index, const VehicleControlInput& control,
+        double last_steer_angle, const double timestep, ControlViolation violation) const;
+
     public:
+      /**
+       * @brief Constructor which reads the vehicle limits from the provided parameter server
+       * 
+       * @throws std::invalid_argument If a parameter could not be read or max_steering_angle_rate is negative
+       */
       explicit ConstraintChecker(std::shared_ptr<ParameterServer> parameter_server);
 
       /**
@@ -64,5 +91,132 @@ namespace lib_vehicle_model {
        * @throws std::invalid_argument If the initial control inputs are found to be invalid
        */
       void validateControlInputs(const VehicleState& initial_state, const std::vector<VehicleControlInput>& control_inputs, const double timestep) const; 
+
+      /**
+       * @brief Validates every check of validateControlInputs which does not depend on the initial state
+       * 
+       * Combined with validateInitialSteeringRate this applies the same constraints as validateControlInputs
+       * 
+       * @param control_inputs The control inputs to validate
+       * @param timestep The difference in time between successive control inputs in seconds
+       * 
+       * @throws std::invalid_argument If the control inputs are empty or found to be invalid
+       */
+      void validateControlSequence(const std::vector<VehicleControlInput>& control_inputs, const double timestep) const;
+
+      /**
+       * @brief Validates the steering rate between the initial state and the first control input
+       * 
+       * @param initial_state The starting state of the vehicle passed into the prediction function
+       * @param first_control The first control input passed into the prediction function
+       * @param timestep The difference in time between successive control inputs in seconds
+       * 
+       * @throws std::invalid_argument If the steering rate limit is exceeded
+       */
+      void validateInitialSteeringRate(const VehicleState& initial_state, const VehicleControlInput& first_control, const double timestep) const;
+
+      /**
+       * @brief Helper function to validate a list of control change points for a motion prediction
+       * 
+       * Each control input is checked against the same limits as validateControlInputs. As the change between successive
+       * change points is applied within a single step the steering rate is computed over the timestep.
+       * Change points which are overridden by a later change point in the same step are never applied, so they are
+       * checked against the limits but excluded from the steering rate check.
+       * The cost of this check scales with the number of change points rather than the prediction horizon.
+       * 
+       * @param initial_state The starting state of the vehicle passed into the prediction function
+       * @param control_changes The control change points passed into the prediction function
+       * @param timestep The integration timestep of the prediction in seconds
+       * 
+       * @throws std::invalid_argument If the change points are not sorted by non-negative time or a control input is invalid
+       */
+      void validateControlChanges(const VehicleState& initial_state, const std::vector<TimedControlInput>& control_changes, const double timestep) const;
+
+      /**
+       * @brief Non-throwing version of validateInitialState for use on the real-time prediction path
+       * 
+       * Applies the same constraints as validateInitialState without building an error message or allocating memory
+       * 
+       * @param initial_state The starting state of the vehicle passed into the prediction function
+       * 
+       * @return True if the initial vehicle state is valid
+       */
+      bool isValidInitialState(const VehicleState& initial_state) const noexcept;
+
+      /**
+       * @brief Non-throwing version of validateControlInputs for use on the real-time prediction path
+       * 
+       * Applies the same constraints as validateControlInputs without building an error message or allocating memory
+       * 
+       * @param initial_state The starting state of the vehicle passed into the prediction function
+       * @param control_inputs An array of control inputs passed into the prediction function
+       * @param count The number of elements in control_inputs
+       * @param timestep The difference in time between successive control inputs in seconds
+       * 
+       * @return True if the control inputs are valid
+       */
+      bool areValidControlInputs(const VehicleState& initial_state, const VehicleControlInput* control_inputs, size_t count, const double timestep) const noexcept;
+
+      /**
+       * @brief Non-throwing version of validateControlInputs which reports every violated limit of every control input
+       * 
+       * Unlike validateControlInputs, checking continues past the first invalid control input.
+       * No memory is allocated if every control input is valid.
+       * 
+       * @param initial_state The starting state of the vehicle passed into the prediction function
+       * @param control_inputs An array of control inputs passed into the prediction function
+       * @param count The number of elements in control_inputs
+       * @param timestep The difference in time between successive control inputs in seconds
+       * @param report The report to populate. Any previous contents are replaced
+       * 
+       * @return True if the control inputs are valid. False if any control input is invalid or no control inputs were provided
+       */
+      bool checkControlInputs(const VehicleState& initial_state, const VehicleControlInput* control_inputs, size_t count,
+        const double timestep, ControlViolationReport& report) const;
+
+      /**
+       * @brief Projects control inputs onto the vehicle limits in place instead of rejecting them
+       * 
+       * Each control input is processed in sequence. Its target velocity and steering angle are clamped to their limits
+       * and its steering angle is then moved toward the previous sanitized steering angle until the steering rate limit is met.
+       * Provided the initial state is valid the sanitized inputs always pass validateControlInputs.
+       * 
+       * @param initial_state The starting state of the vehicle passed into the prediction function
+       * @param control_inputs An array of control inputs which will be modified in place
+       * @param count The number of elements in control_inputs
+       * @param timestep The difference in time between successive control inputs in seconds. Must be greater than 0
+       * @param report The report to populate with the limits each control input was clamped to. Any previous contents are replaced
+       * 
+       * @return True if no control input was modified. False if control_inputs is null while count is not 0
+       */
+      bool sanitizeControlInputs(const VehicleState& initial_state, VehicleControlInput* control_inputs, size_t count,
+        const double timestep, ControlViolationReport& report) const;
+
+      /**
+       * @brief Branch-free check of a control sequence stored as separate velocity and steering arrays
+       * 
+       * Applies the same constraints as checkControlInputs but only reports the union of the violations of all controls.
+       * The check makes a single pass over both arrays without early exit which the compiler can vectorise,
+       * so it is suited to long sequences which are expected to be valid.
+       * 
+       * @param initial_steering_angle The steering angle of the vehicle before the first control
+       * @param target_velocities An array of count target velocities
+       * @param target_steering_angles An array of count target steering angles
+       * @param count The number of controls in the sequence
+       * @param timestep The difference in time between successive control inputs in seconds
+       * 
+       * @return The mask of violated limits. ControlViolation::NONE if every control is valid or count is 0
+       */
+      ControlViolation checkControlArrays(double initial_steering_angle, const double* target_velocities,
+        const double* target_steering_angles, size_t count, const double timestep) const noexcept;
+
+      /**
+       * @brief Checks every sequence of a structure of arrays batch with checkControlArrays
+       * 
+       * @param batch The batch of control sequences to check
+       * @param timestep The difference in time between successive control inputs in seconds
+       * @param results An array of at least batch.sequence_count masks which will hold the violations of each sequence
+       */
+      void checkControlBatch(const ControlBatch& batch, const double timestep, ControlViolation* results) const noexcept;
   };
 }
\ No newline at end of file
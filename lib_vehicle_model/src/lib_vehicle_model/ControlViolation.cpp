@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include "lib_vehicle_model/ControlViolation.h"
+
+namespace lib_vehicle_model {
+
+  /**
+   * Overload of << operation so masks will output as | separated flag names in print functions
+   * 
+   */ 
+  std::ostream& operator<<( std::ostream& os, const ControlViolation& violation )
+  {
+    if (violation == ControlViolation::NONE) {
+      os << "NONE";
+      return os;
+    }
+
+    static const ControlViolation flags[] = {
+      ControlViolation::VELOCITY_BELOW_MIN, ControlViolation::VELOCITY_ABOVE_MAX,
+      ControlViolation::STEERING_BELOW_MIN, ControlViolation::STEERING_ABOVE_MAX,
+      ControlViolation::STEERING_RATE_ABOVE_MAX
+    };
+    static const char* names[] = {
+      "VELOCITY_BELOW_MIN", "VELOCITY_ABOVE_MAX", "STEERING_BELOW_MIN", "STEERING_ABOVE_MAX", "STEERING_RATE_ABOVE_MAX"
+    };
+
+    bool first = true;
+    ControlViolation remaining = violation;
+    for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); i++) {
+      if (hasViolation(violation, flags[i])) {
+        os << (first ? "" : "|") << names[i];
+        first = false;
+        remaining = static_cast<ControlViolation>(static_cast<uint8_t>(remaining) & ~static_cast<uint8_t>(flags[i]));
+      }
+    }
+
+    if (remaining != ControlViolation::NONE) {
+      os << (first ? "" : "|") << "ERROR: UNKNOWN TYPE";
+    }
+
+    return os;
+  }
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cmath>
+#include <sstream>
+#include <algorithm>
+#include "lib_vehicle_model/FeasibilityFilter.h"
+#include "lib_vehicle_model/KinematicsSolver.h"
+#include "lib_vehicle_model/LibVehicleModel.h"
+#include "lib_vehicle_model/Tracing.h"
+
+/**
+ * Cpp containing the implementation of FeasibilityFilter
+ */
+using namespace lib_vehicle_model;
+
+namespace {
+
+  /**
+   * Advances a speed toward a velocity command at a constant acceleration for one timestep without passing the command
+   * 
+   * @param speed The speed at the start of the step. Updated to the speed at the end of the step
+   * @param command The velocity command
+   * @param accel The acceleration toward the command. Its sign must match the direction of the command from the speed
+   * @param timestep The duration of the step
+   * 
+   * @return The distance travelled during the step
+   */
+  double approachCommand(double& speed, double command, double accel, double timestep) {
+    // Speeds, commands and timesteps are checked by computeBounds so the solver range checks are skipped
+    const double unlimited_speed = KinematicsSolver::solve<KinematicsProperty::FINAL_VELOCITY, KinematicsProperty::DISTANCE, false>(speed, accel, timestep);
+    const bool reaches_command = accel > 0.0 ? unlimited_speed >= command : unlimited_speed <= command;
+
+    if (!reaches_command) {
+      const double distance = KinematicsSolver::solve<KinematicsProperty::DISTANCE, KinematicsProperty::FINAL_VELOCITY, false>(speed, accel, timestep);
+      speed = unlimited_speed;
+      return distance;
+    }
+
+    // Accelerate until the command is reached and then hold it for the rest of the step
+    const double ramp_time = KinematicsSolver::solve<KinematicsProperty::TIME, KinematicsProperty::DISTANCE, false>(speed, command, accel);
+    const double ramp_distance = KinematicsSolver::solve<KinematicsProperty::DISTANCE, KinematicsProperty::TIME, false>(speed, command, accel);
+    speed = command;
+    return ramp_distance + command * std::max(0.0, timestep - ramp_time);
+  }
+
+  void checkTimestep(double timestep) {
+    if (!(timestep > 0.0)) {
+      std::ostringstream msg;
+      msg << "Invalid timestep: " << timestep << " must be greater than 0";
+      throw std::invalid_argument(msg.str());
+    }
+  }
+}
+
+FeasibilityFilter::FeasibilityFilter(std::shared_ptr<ParameterServer> parameter_server) {
+
+  // Load Parameters
+  bool accelLimitParam = parameter_server->getParam("acceleration_limit", acceleration_limit_);
+  bool decelLimitParam = parameter_server->getParam("deceleration_limit", deceleration_limit_);
+
+  // Check if all the required parameters could be loaded
+  if (!(accelLimitParam && decelLimitParam)) {
+
+    std::ostringstream msg;
+    msg << "One of the required parameters could not be found or read " 
+      << " acceleration_limit: " << accelLimitParam 
+      << " deceleration_limit: " << decelLimitParam;
+
+    throw std::invalid_argument(msg.str());
+  }
+
+  if (!(acceleration_limit_ > 0.0 && deceleration_limit_ > 0.0)) {
+    std::ostringstream msg;
+    msg << "Invalid acceleration limits: acceleration_limit: " << acceleration_limit_ << " and deceleration_limit: "
+      << deceleration_limit_ << " must be greater than 0";
+    throw std::invalid_argument(msg.str());
+  }
+
+  // The heading can only be bounded if the wheel base is known
+  double length_to_f = 0;
+  double length_to_r = 0;
+  if (parameter_server->getParam("length_to_f", length_to_f) && parameter_server->getParam("length_to_r", length_to_r)
+    && length_to_f + length_to_r > 0.0) {
+    wheel_base_ = length_to_f + length_to_r;
+  }
+}
+
+bool FeasibilityFilter::computeBounds(const VehicleState& initial_state, const std::vector<VehicleControlInput>& control_inputs,
+  double timestep, FeasibilityBounds& bounds) const {
+
+  checkTimestep(timestep);
+
+  // The KinematicsSolver and the distance bounds below require non-negative speeds
+  if (initial_state.longitudinal_vel < 0.0) {
+    return false;
+  }
+  for (const VehicleControlInput& control : control_inputs) {
+    if (control.target_velocity < 0.0) {
+      return false;
+    }
+  }
+
+  const size_t count = control_inputs.size() + 1;
+  bounds.min_speed.resize(count);
+  bounds.max_speed.resize(count);
+  bounds.min_distance.resize(count);
+  bounds.max_distance.resize(count);
+  bounds.max_heading_change.resize(count);
+
+  double min_speed = initial_state.longitudinal_vel;
+  double max_speed = initial_state.longitudinal_vel;
+  double last_steer_angle = initial_state.steering_angle;
+
+  bounds.min_speed[0] = min_speed;
+  bounds.max_speed[0] = max_speed;
+  bounds.min_distance[0] = 0.0;
+  bounds.max_distance[0] = 0.0;
+  bounds.max_heading_change[0] = 0.0;
+
+  for (size_t i = 0; i < control_inputs.size(); i++) {
+    const double command = control_inputs[i].target_velocity;
+
+    // The fastest speed accelerates toward higher commands at the limit but may not slow down for lower ones
+    const double max_step_distance = command > max_speed ? approachCommand(max_speed, command, acceleration_limit_, timestep) : max_speed * timestep;
+    // The slowest speed decelerates toward lower commands at the limit but may not speed up for higher ones
+    const double min_step_distance = command < min_speed ? approachCommand(min_speed, command, -deceleration_limit_, timestep) : min_speed * timestep;
+
+    // Steering may take the step to move from the previous command to this one
+    const double max_steer = std::max(std::fabs(control_inputs[i].target_steering_angle), std::fabs(last_steer_angle));
+    double max_heading_step = std::numeric_limits<double>::infinity();
+    if (boundsHeading() && max_steer < M_PI_2) {
+      max_heading_step = max_step_distance * std::tan(max_steer) / wheel_base_;
+    }
+    last_steer_angle = control_inputs[i].target_steering_angle;
+
+    bounds.min_speed[i + 1] = min_speed;
+    bounds.max_speed[i + 1] = max_speed;
+    bounds.min_distance[i + 1] = bounds.min_distance[i] + min_step_distance;
+    bounds.max_distance[i + 1] = bounds.max_distance[i] + max_step_distance;
+    bounds.max_heading_change[i + 1] = bounds.max_heading_change[i] + max_heading_step;
+  }
+
+  return true;
+}
+
+bool FeasibilityFilter::isFeasible(const VehicleState& initial_state, const std::vector<VehicleControlInput>& control_inputs,
+  double timestep, const std::vector<FeasibilityGoal>& goals) const {
+
+  FeasibilityBounds bounds;
+  if (!computeBounds(initial_state, control_inputs, timestep, bounds)) {
+    return true; // Nothing can be ruled out without bounds
+  }
+
+  const double horizon = control_inputs.size() * timestep;
+  const size_t last_index = control_inputs.size();
+
+  for (const FeasibilityGoal& goal : goals) {
+    if (goal.time < 0.0 || goal.time > horizon) {
+      std::ostringstream msg;
+      msg << "Invalid goal time: " << goal.time << " is outside the control sequence horizon of: " << horizon;
+      throw std::invalid_argument(msg.str());
+    }
+
+    // Between two bounds the motion is monotonic so the bounds of the enclosing steps are used
+    const size_t before = std::min(static_cast<size_t>(std::floor(goal.time / timestep)), last_index);
+    const size_t after = std::min(static_cast<size_t>(std::ceil(goal.time / timestep)), last_index);
+
+    const bool infeasible = bounds.max_distance[after] < goal.min_distance
+      || bounds.min_distance[before] > goal.max_distance
+      || std::max(bounds.max_speed[before], bounds.max_speed[after]) < goal.min_speed
+      || std::min(bounds.min_speed[before], bounds.min_speed[after]) > goal.max_speed
+      || bounds.max_heading_change[after] < goal.min_heading_change;
+
+    if (infeasible) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::vector<size_t> FeasibilityFilter::filter(const VehicleState& initial_state, const std::vector<std::vector<VehicleControlInput>>& candidates,
+  double timestep, const std::vector<FeasibilityGoal>& goals) const {
+
+  tracing::ScopedSpan span("FeasibilityFilter::filter", "lib_vehicle_model");
+
+  std::vector<size_t> feasible;
+  for (size_t i = 0; i < candidates.size(); i++) {
+    if (isFeasible(initial_state, candidates[i], timestep, goals)) {
+      feasible.push_back(i);
+    }
+  }
+
+  return feasible;
+}
+
+bool FeasibilityFilter::predictIfFeasible(const VehicleState& initial_state, const std::vector<VehicleControlInput>& control_inputs,
+  double timestep, const std::vector<FeasibilityGoal>& goals, std::vector<VehicleState>& states) const {
+
+  if (!isFeasible(initial_state, control_inputs, timestep, goals)) {
+    return false;
+  }
+
+  states = lib_vehicle_model::predict(initial_state, control_inputs, timestep);
+  return true;
+}
+
+bool FeasibilityFilter::boundsHeading() const {
+  return !std::isinf(wheel_base_);
+}
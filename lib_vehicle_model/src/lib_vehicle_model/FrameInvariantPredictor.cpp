@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <math.h>
+#include <functional>
+#include "lib_vehicle_model/FrameInvariantPredictor.h"
+#include "lib_vehicle_model/Tracing.h"
+
+/**
+ * Cpp containing the implementation of SE2Transform and FrameInvariantPredictor
+ */
+using namespace lib_vehicle_model;
+
+namespace {
+  // Mode values stored at the start of a cache key so the two predict functions never share entries
+  const double NO_CONTROL_MODE = 0.0;
+  const double CONTROL_MODE = 1.0;
+
+  // Helper function which returns the provided state moved to its canonical frame
+  VehicleState canonicalState(const VehicleState& state) {
+    VehicleState canonical = state;
+    canonical.X_pos_global = 0;
+    canonical.Y_pos_global = 0;
+    canonical.orientation = 0;
+    return canonical;
+  }
+}
+
+//
+// SE2Transform
+//
+SE2Transform SE2Transform::fromState(const VehicleState& state) {
+  SE2Transform transform;
+  transform.x = state.X_pos_global;
+  transform.y = state.Y_pos_global;
+  transform.theta = state.orientation;
+  return transform;
+}
+
+void SE2Transform::apply(VehicleState* states, size_t count) const {
+  const double cos_theta = cos(theta);
+  const double sin_theta = sin(theta);
+
+  for (size_t i = 0; i < count; i++) {
+    VehicleState& state = states[i];
+    const double local_x = state.X_pos_global;
+    const double local_y = state.Y_pos_global;
+    state.X_pos_global = x + cos_theta * local_x - sin_theta * local_y;
+    state.Y_pos_global = y + sin_theta * local_x + cos_theta * local_y;
+    state.orientation += theta;
+  }
+}
+
+//
+// FrameInvariantPredictor
+//
+size_t FrameInvariantPredictor::CacheKeyHash::operator()(const CacheKey& key) const {
+  std::hash<double> hasher;
+  size_t seed = key.values.size();
+  for (double value : key.values) {
+    seed ^= hasher(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  }
+  return seed;
+}
+
+FrameInvariantPredictor::FrameInvariantPredictor(std::shared_ptr<VehicleMotionModel> model, size_t cache_capacity) :
+  model_(model), cache_capacity_(cache_capacity) {
+
+  if (!model_) {
+    throw std::invalid_argument("FrameInvariantPredictor requires a non-null vehicle model");
+  }
+
+  if (!model_->isFrameInvariant()) {
+    throw std::invalid_argument("FrameInvariantPredictor requires a vehicle model which is frame invariant");
+  }
+}
+
+FrameInvariantPredictor::CacheKey FrameInvariantPredictor::buildKey(double mode, const VehicleState& canonical_state,
+  const VehicleControlInput* control_inputs, size_t count, double timestep, double delta_t) {
+
+  CacheKey key;
+  key.values.reserve(12 + 2 * count);
+
+  key.values.push_back(mode);
+  key.values.push_back(timestep);
+  key.values.push_back(delta_t);
+
+  // Body frame fields. The pose is always zero in the canonical frame
+  key.values.push_back(canonical_state.longitudinal_vel);
+  key.values.push_back(canonical_state.lateral_vel);
+  key.values.push_back(canonical_state.yaw_rate);
+  key.values.push_back(canonical_state.front_wheel_rotation_rate);
+  key.values.push_back(canonical_state.rear_wheel_rotation_rate);
+  key.values.push_back(canonical_state.steering_angle);
+  key.values.push_back(canonical_state.trailer_angle);
+  key.values.push_back(canonical_state.prev_vel_cmd);
+  key.values.push_back(canonical_state.prev_steering_cmd);
+
+  for (size_t i = 0; i < count; i++) {
+    key.values.push_back(control_inputs[i].target_steering_angle);
+    key.values.push_back(control_inputs[i].target_velocity);
+  }
+
+  return key;
+}
+
+template<typename IntegrateFunction>
+std::vector<VehicleState> FrameInvariantPredictor::canonicalPredict(CacheKey&& key, IntegrateFunction integrate) {
+
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    cache_hits_++;
+    entries_.splice(entries_.begin(), entries_, found->second); // Mark as most recently used
+    return found->second->states;
+  }
+
+  cache_misses_++;
+  std::vector<VehicleState> states = integrate();
+
+  if (cache_capacity_ == 0) {
+    return states;
+  }
+
+  // Evict the least recently used entry once full
+  if (entries_.size() >= cache_capacity_) {
+    index_.erase(entries_.back().key);
+    entries_.pop_back();
+  }
+
+  entries_.push_front(CacheEntry());
+  entries_.front().key = std::move(key);
+  entries_.front().states = states;
+  index_[entries_.front().key] = entries_.begin();
+
+  return states;
+}
+
+std::vector<VehicleState> FrameInvariantPredictor::predict(const VehicleState& initial_state, double timestep, double delta_t) {
+  tracing::ScopedSpan span("FrameInvariantPredictor::predict", "lib_vehicle_model");
+
+  const VehicleState canonical = canonicalState(initial_state);
+
+  std::vector<VehicleState> states = canonicalPredict(buildKey(NO_CONTROL_MODE, canonical, nullptr, 0, timestep, delta_t),
+    [&]() { return model_->predict(canonical, timestep, delta_t); });
+
+  SE2Transform::fromState(initial_state).apply(states.data(), states.size());
+  return states;
+}
+
+std::vector<VehicleState> FrameInvariantPredictor::predict(const VehicleState& initial_state,
+  const std::vector<VehicleControlInput>& control_inputs, double timestep) {
+  tracing::ScopedSpan span("FrameInvariantPredictor::predict", "lib_vehicle_model");
+
+  const VehicleState canonical = canonicalState(initial_state);
+
+  std::vector<VehicleState> states = canonicalPredict(buildKey(CONTROL_MODE, canonical, control_inputs.data(), control_inputs.size(), timestep, 0.0),
+    [&]() { return model_->predict(canonical, control_inputs, timestep); });
+
+  SE2Transform::fromState(initial_state).apply(states.data(), states.size());
+  return states;
+}
+
+void FrameInvariantPredictor::clearCache() {
+  entries_.clear();
+  index_.clear();
+}
+
+size_t FrameInvariantPredictor::getCacheSize() const {
+  return entries_.size();
+}
+
+uint64_t FrameInvariantPredictor::getCacheHits() const {
+  return cache_hits_;
+}
+
+uint64_t FrameInvariantPredictor::getCacheMisses() const {
+  return cache_misses_;
+}
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <math.h>
+#include <sstream>
+#include <algorithm>
+#include "lib_vehicle_model/GoalPoseIndex.h"
+#include "lib_vehicle_model/FrameInvariantPredictor.h"
+#include "lib_vehicle_model/LibVehicleModel.h"
+#include "lib_vehicle_model/Tracing.h"
+
+/**
+ * Cpp containing the implementation of GoalPoseIndex
+ */
+using namespace lib_vehicle_model;
+
+namespace {
+  // Orders (squared distance, index) pairs so the heap front is the furthest of the nearest entries
+  bool furtherFirst(const std::pair<double, size_t>& a, const std::pair<double, size_t>& b) {
+    return a.first < b.first;
+  }
+}
+
+GoalPoseIndex::GoalPoseIndex(double orientation_weight, double speed_weight) :
+  orientation_weight_(orientation_weight), speed_weight_(speed_weight) {
+
+  if (orientation_weight_ < 0 || speed_weight_ < 0) {
+    throw std::invalid_argument("GoalPoseIndex weights cannot be negative");
+  }
+}
+
+GoalPoseIndex::Point GoalPoseIndex::toPoint(const VehicleState& state) const {
+  Point point;
+  point[0] = state.X_pos_global;
+  point[1] = state.Y_pos_global;
+  point[2] = orientation_weight_ * cos(state.orientation);
+  point[3] = orientation_weight_ * sin(state.orientation);
+  point[4] = speed_weight_ * state.longitudinal_vel;
+  return point;
+}
+
+double GoalPoseIndex::distance(const VehicleState& a, const VehicleState& b) const {
+  const Point point_a = toPoint(a);
+  const Point point_b = toPoint(b);
+
+  double squared = 0;
+  for (size_t d = 0; d < DIMENSIONS; d++) {
+    squared += (point_a[d] - point_b[d]) * (point_a[d] - point_b[d]);
+  }
+  return sqrt(squared);
+}
+
+VehicleState GoalPoseIndex::toBodyFrame(const VehicleState& initial_state, const VehicleState& goal) {
+  const double cos_theta = cos(initial_state.orientation);
+  const double sin_theta = sin(initial_state.orientation);
+  const double dx = goal.X_pos_global - initial_state.X_pos_global;
+  const double dy = goal.Y_pos_global - initial_state.Y_pos_global;
+
+  VehicleState body = goal;
+  body.X_pos_global = cos_theta * dx + sin_theta * dy;
+  body.Y_pos_global = -sin_theta * dx + cos_theta * dy;
+  body.orientation = goal.orientation - initial_state.orientation;
+  return body;
+}
+
+void GoalPoseIndex::buildTree(std::vector<Entry>& entries, size_t lo, size_t hi, size_t depth) {
+  if (hi - lo <= 1) {
+    return;
+  }
+
+  const size_t dimension = depth % DIMENSIONS;
+  const size_t mid = (lo + hi) / 2;
+  std::nth_element(entries.begin() + lo, entries.begin() + mid, entries.begin() + hi,
+    [dimension](const Entry& a, const Entry& b) { return a.point[dimension] < b.point[dimension]; });
+
+  buildTree(entries, lo, mid, depth + 1);
+  buildTree(entries, mid + 1, hi, depth + 1);
+}
+
+void GoalPoseIndex::searchTree(const std::vector<Entry>& entries, size_t lo, size_t hi, size_t depth, const Point& query,
+  size_t k, std::vector<std::pair<double, size_t>>& nearest) {
+
+  if (lo >= hi) {
+    return;
+  }
+
+  const size_t mid = (lo + hi) / 2;
+  const Point& point = entries[mid].point;
+
+  double squared = 0;
+  for (size_t d = 0; d < DIMENSIONS; d++) {
+    squared += (point[d] - query[d]) * (point[d] - query[d]);
+  }
+
+  if (nearest.size() < k) {
+    nearest.push_back(std::make_pair(squared, mid));
+    std::push_heap(nearest.begin(), nearest.end(), furtherFirst);
+  } else if (squared < nearest.front().first) {
+    std::pop_heap(nearest.begin(), nearest.end(), furtherFirst);
+    nearest.back() = std::make_pair(squared, mid);
+    std::push_heap(nearest.begin(), nearest.end(), furtherFirst);
+  }
+
+  // Search the side containing the query first then the other side only if it could hold a closer entry
+  const size_t dimension = depth % DIMENSIONS;
+  const double split_distance = query[dimension] - point[dimension];
+  const bool query_is_low = split_distance < 0;
+
+  searchTree(entries, query_is_low ? lo : mid + 1, query_is_low ? mid : hi, depth + 1, query, k, nearest);
+
+  if (nearest.size() < k || split_distance * split_distance < nearest.front().first) {
+    searchTree(entries, query_is_low ? mid + 1 : lo, query_is_low ? hi : mid, depth + 1, query, k, nearest);
+  }
+}
+
+void GoalPoseIndex::build(const MotionPrimitiveLibrary& library) {
+  tracing::ScopedSpan span("GoalPoseIndex::build", "lib_vehicle_model");
+
+  if (!library.isBuilt()) {
+    throw std::invalid_argument("GoalPoseIndex requires a motion primitive library which has been built or loaded");
+  }
+
+  if (library.isStale()) {
+    throw std::invalid_argument("GoalPoseIndex requires a motion primitive library which is current with the loaded model");
+  }
+
+  const MotionPrimitiveGrid& grid = library.getGrid();
+  std::vector<std::vector<Entry>> trees(grid.initial_speeds.size() * grid.initial_steering_angles.size());
+
+  for (size_t speed_index = 0; speed_index < grid.initial_speeds.size(); speed_index++) {
+    for (size_t steering_index = 0; steering_index < grid.initial_steering_angles.size(); steering_index++) {
+      std::vector<Entry>& entries = trees[speed_index * grid.initial_steering_angles.size() + steering_index];
+      entries.reserve(grid.control_sequences.size());
+
+      for (size_t sequence_index = 0; sequence_index < grid.control_sequences.size(); sequence_index++) {
+        size_t count = 0;
+        const VehicleState* states = library.getCanonicalPrimitive(speed_index, steering_index, sequence_index, count);
+        if (count == 0) {
+          continue;
+        }
+
+        Entry entry;
+        entry.end_state = states[count - 1];
+        entry.point = toPoint(entry.end_state);
+        entry.sequence_index = sequence_index;
+        entries.push_back(entry);
+      }
+
+      buildTree(entries, 0, entries.size(), 0);
+    }
+  }
+
+  trees_ = std::move(trees);
+  grid_ = grid;
+  generation_ = getParameterGeneration();
+  built_ = true;
+}
+
+std::vector<GoalPoseMatch> GoalPoseIndex::findNearest(const VehicleState& initial_state, const VehicleState& goal, size_t k) const {
+  if (!built_) {
+    throw std::invalid_argument("Attempted to query a GoalPoseIndex which has not been built");
+  }
+
+  if (isStale()) {
+    throw std::invalid_argument("Attempted to query a GoalPoseIndex which is stale. Rebuild it with the loaded model");
+  }
+
+  const size_t speed_index = MotionPrimitiveLibrary::nearestIndex(grid_.initial_speeds, initial_state.longitudinal_vel);
+  const size_t steering_index = MotionPrimitiveLibrary::nearestIndex(grid_.initial_steering_angles, initial_state.steering_angle);
+  const std::vector<Entry>& entries = trees_[speed_index * grid_.initial_steering_angles.size() + steering_index];
+
+  std::vector<std::pair<double, size_t>> nearest;
+  nearest.reserve(k);
+  if (k > 0) {
+    searchTree(entries, 0, entries.size(), 0, toPoint(toBodyFrame(initial_state, goal)), k, nearest);
+  }
+  std::sort_heap(nearest.begin(), nearest.end(), furtherFirst);
+
+  const SE2Transform transform = SE2Transform::fromState(initial_state);
+  std::vector<GoalPoseMatch> matches(nearest.size());
+  for (size_t i = 0; i < nearest.size(); i++) {
+    const Entry& entry = entries[nearest[i].second];
+    matches[i].speed_index = speed_index;
+    matches[i].steering_index = steering_index;
+    matches[i].sequence_index = entry.sequence_index;
+    matches[i].end_state = entry.end_state;
+    matches[i].distance = sqrt(nearest[i].first);
+    transform.apply(&matches[i].end_state, 1);
+  }
+
+  return matches;
+}
+
+GoalPoseMatch GoalPoseIndex::findControls(const VehicleState& initial_state, const VehicleState& goal, size_t refine_candidates) const {
+  tracing::ScopedSpan span("GoalPoseIndex::findControls", "lib_vehicle_model");
+
+  std::vector<GoalPoseMatch> matches = findNearest(initial_state, goal, std::max<size_t>(refine_candidates, 1));
+  if (matches.empty()) {
+    throw std::invalid_argument("GoalPoseIndex holds no primitives for the initial state");
+  }
+
+  if (refine_candidates == 0) {
+    return matches.front();
+  }
+
+  // Roll out each candidate from the exact initial state and keep the closest real end state
+  // The nearest unrefined match is kept if no rollout returns a state
+  GoalPoseMatch best = matches.front();
+  bool refined = false;
+  for (GoalPoseMatch& match : matches) {
+    std::vector<VehicleState> states = lib_vehicle_model::predict(initial_state, grid_.control_sequences[match.sequence_index], grid_.timestep);
+    if (states.empty()) {
+      continue;
+    }
+
+    match.end_state = states.back();
+    match.distance = distance(match.end_state, goal);
+    if (!refined || match.distance < best.distance) {
+      best = match;
+      refined = true;
+    }
+  }
+
+  return best;
+}
+
+const std::vector<VehicleControlInput>& GoalPoseIndex::getControls(const GoalPoseMatch& match) const {
+  if (match.sequence_index >= grid_.control_sequences.size()) {
+    std::ostringstream msg;
+    msg << "Invalid GoalPoseMatch sequence_index: " << match.sequence_index << " is out of range";
+    throw std::invalid_argument(msg.str());
+  }
+
+  return grid_.control_sequences[match.sequence_index];
+}
+
+bool GoalPoseIndex::isBuilt() const {
+  return built_;
+}
+
+bool GoalPoseIndex::isStale() const {
+  return built_ && generation_ != getParameterGeneration();
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include "lib_vehicle_model/KinematicsError.h"
+
+namespace lib_vehicle_model {
+
+  /**
+   * Overload of << operation so masks will output as | separated flag names in print functions
+   * 
+   */ 
+  std::ostream& operator<<( std::ostream& os, const KinematicsError& error )
+  {
+    if (error == KinematicsError::NONE) {
+      os << "NONE";
+      return os;
+    }
+
+    static const KinematicsError flags[] = {
+      KinematicsError::NEGATIVE_INPUT, KinematicsError::DISCONTINUITY,
+      KinematicsError::SIGN_MISMATCH, KinematicsError::UNSUPPORTED_COMBINATION
+    };
+    static const char* names[] = {
+      "NEGATIVE_INPUT", "DISCONTINUITY", "SIGN_MISMATCH", "UNSUPPORTED_COMBINATION"
+    };
+
+    bool first = true;
+    KinematicsError remaining = error;
+    for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); i++) {
+      if (hasError(error, flags[i])) {
+        os << (first ? "" : "|") << names[i];
+        first = false;
+        remaining = static_cast<KinematicsError>(static_cast<uint8_t>(remaining) & ~static_cast<uint8_t>(flags[i]));
+      }
+    }
+
+    if (remaining != KinematicsError::NONE) {
+      os << (first ? "" : "|") << "ERROR: UNKNOWN TYPE";
+    }
+
+    return os;
+  }
+}
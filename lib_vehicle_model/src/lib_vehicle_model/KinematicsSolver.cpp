@@ -14,7 +14,8 @@
  * the License.
  */
 
-#include <math.h> 
+#include <limits>
+#include <sstream>
 #include <ros/assert.h>
 #include "lib_vehicle_model/KinematicsSolver.h"
 /**
@@ -41,38 +42,157 @@ namespace lib_vehicle_model {
       }
 
       /**
-       * @brief Helper function to check that the provided value is non-negative
+       * @brief Calls op.apply<Out, Unavailable>() for the equation selected by the provided properties
        * 
-       * This function should be used to check v_i,v_f,d,and t values are positive
+       * op.unsupported(prop) is called with the offending property if the properties do not select an equation
        * 
-       * @throws std::domain_error if the provided value is negative
+       * @return The value returned by op
        */ 
-      void checkIsPositive(const double& val, const KinematicsProperty& prop) {
-        if (val < 0.0) {
-          std::ostringstream stream;
-          stream << "Invalid property value: " << prop << " cannot be negative";
-          throw std::domain_error(stream.str());
+      template<typename Op>
+      typename Op::Result dispatch(const KinematicsProperty& output_prop, const KinematicsProperty& unavailable_prop, const Op& op) {
+        switch(output_prop) {
+
+          case KinematicsProperty::INITIAL_VELOCITY:
+            switch(unavailable_prop) {
+              case KinematicsProperty::FINAL_VELOCITY:
+                return op.template apply<KinematicsProperty::INITIAL_VELOCITY, KinematicsProperty::FINAL_VELOCITY>();
+              case KinematicsProperty::ACCELERATION:
+                return op.template apply<KinematicsProperty::INITIAL_VELOCITY, KinematicsProperty::ACCELERATION>();
+              case KinematicsProperty::DISTANCE:
+                return op.template apply<KinematicsProperty::INITIAL_VELOCITY, KinematicsProperty::DISTANCE>();
+              case KinematicsProperty::TIME:
+                return op.template apply<KinematicsProperty::INITIAL_VELOCITY, KinematicsProperty::TIME>();
+              default:
+                return op.unsupported(unavailable_prop);
+            }
+
+          case KinematicsProperty::FINAL_VELOCITY:
+            switch(unavailable_prop) {
+              case KinematicsProperty::INITIAL_VELOCITY:
+                return op.template apply<KinematicsProperty::FINAL_VELOCITY, KinematicsProperty::INITIAL_VELOCITY>();
+              case KinematicsProperty::ACCELERATION:
+                return op.template apply<KinematicsProperty::FINAL_VELOCITY, KinematicsProperty::ACCELERATION>();
+              case KinematicsProperty::DISTANCE:
+                return op.template apply<KinematicsProperty::FINAL_VELOCITY, KinematicsProperty::DISTANCE>();
+              case KinematicsProperty::TIME:
+                return op.template apply<KinematicsProperty::FINAL_VELOCITY, KinematicsProperty::TIME>();
+              default:
+                return op.unsupported(unavailable_prop);
+            }
+
+          case KinematicsProperty::ACCELERATION:
+            switch(unavailable_prop) {
+              case KinematicsProperty::INITIAL_VELOCITY:
+                return op.template apply<KinematicsProperty::ACCELERATION, KinematicsProperty::INITIAL_VELOCITY>();
+              case KinematicsProperty::FINAL_VELOCITY:
+                return op.template apply<KinematicsProperty::ACCELERATION, KinematicsProperty::FINAL_VELOCITY>();
+              case KinematicsProperty::DISTANCE:
+                return op.template apply<KinematicsProperty::ACCELERATION, KinematicsProperty::DISTANCE>();
+              case KinematicsProperty::TIME:
+                return op.template apply<KinematicsProperty::ACCELERATION, KinematicsProperty::TIME>();
+              default:
+                return op.unsupported(unavailable_prop);
+            }
+
+          case KinematicsProperty::DISTANCE:
+            switch(unavailable_prop) {
+              case KinematicsProperty::INITIAL_VELOCITY:
+                return op.template apply<KinematicsProperty::DISTANCE, KinematicsProperty::INITIAL_VELOCITY>();
+              case KinematicsProperty::FINAL_VELOCITY:
+                return op.template apply<KinematicsProperty::DISTANCE, KinematicsProperty::FINAL_VELOCITY>();
+              case KinematicsProperty::ACCELERATION:
+                return op.template apply<KinematicsProperty::DISTANCE, KinematicsProperty::ACCELERATION>();
+              case KinematicsProperty::TIME:
+                return op.template apply<KinematicsProperty::DISTANCE, KinematicsProperty::TIME>();
+              default:
+                return op.unsupported(unavailable_prop);
+            }
+
+          case KinematicsProperty::TIME:
+            switch(unavailable_prop) {
+              case KinematicsProperty::INITIAL_VELOCITY:
+                return op.template apply<KinematicsProperty::TIME, KinematicsProperty::INITIAL_VELOCITY>();
+              case KinematicsProperty::FINAL_VELOCITY:
+                return op.template apply<KinematicsProperty::TIME, KinematicsProperty::FINAL_VELOCITY>();
+              case KinematicsProperty::ACCELERATION:
+                return op.template apply<KinematicsProperty::TIME, KinematicsProperty::ACCELERATION>();
+              case KinematicsProperty::DISTANCE:
+                return op.template apply<KinematicsProperty::TIME, KinematicsProperty::DISTANCE>();
+              default:
+                return op.unsupported(unavailable_prop);
+            }
+
+          // This should never be reached unless enum KinematicProperty enum is changed without updating this function
+          default:
+            return op.unsupported(output_prop);
         }
       }
 
       /**
-       * @brief Helper function to check if the change in velocity matches the direction of acceleration
-       * 
-       * @param v_i Initial velocity
-       * @param v_f Final velocity
-       * @param a Acceleration
-       * 
-       * @throws std::domain_error if the provided value is negative
+       * @brief Operation for dispatch which solves a single equation and throws on errors
        */ 
-      void checkDeltaVAndAccelMatch(const double& v_i, const double& v_f, const double& a) {
-        if ((a > 0 && v_i > v_f)
-          || (a < 0 && v_i < v_f)
-          || a == 0 && v_i != v_f) {
-            std::ostringstream stream;
-            stream << "Impossible acceleration and velocity combination v_i = " << v_i << " v_f = " << v_f << " a = " << a;
-            throw std::domain_error(stream.str());
+      struct ScalarSolve {
+        typedef double Result;
+        const double& prop1;
+        const double& prop2;
+        const double& prop3;
+
+        template<KinematicsProperty Out, KinematicsProperty Unavailable>
+        double apply() const {
+          return solve<Out, Unavailable>(prop1, prop2, prop3);
         }
-      }
+
+        double unsupported(const KinematicsProperty& prop) const {
+          assertTypeException(prop);
+          return std::numeric_limits<double>::quiet_NaN();
+        }
+      };
+
+      /**
+       * @brief Operation for dispatch which solves a single equation and returns errors
+       */ 
+      struct ScalarTrySolve {
+        typedef KinematicsResult Result;
+        const double& prop1;
+        const double& prop2;
+        const double& prop3;
+
+        template<KinematicsProperty Out, KinematicsProperty Unavailable>
+        KinematicsResult apply() const {
+          return trySolve<Out, Unavailable>(prop1, prop2, prop3);
+        }
+
+        KinematicsResult unsupported(const KinematicsProperty&) const {
+          KinematicsResult result;
+          result.error = KinematicsError::UNSUPPORTED_COMBINATION;
+          return result;
+        }
+      };
+
+      /**
+       * @brief Operation for dispatch which solves an equation over arrays of inputs
+       */ 
+      struct BatchSolve {
+        typedef void Result;
+        const double* prop1;
+        const double* prop2;
+        const double* prop3;
+        size_t count;
+        double* results;
+        KinematicsError* errors;
+
+        template<KinematicsProperty Out, KinematicsProperty Unavailable>
+        void apply() const {
+          solve<Out, Unavailable>(prop1, prop2, prop3, count, results, errors);
+        }
+
+        void unsupported(const KinematicsProperty&) const {
+          for (size_t i = 0; i < count; i++) {
+            results[i] = std::numeric_limits<double>::quiet_NaN();
+            errors[i] = KinematicsError::UNSUPPORTED_COMBINATION;
+          }
+        }
+      };
     }
 
     // 
@@ -82,237 +202,44 @@ namespace lib_vehicle_model {
     double solve(const KinematicsProperty& output_prop, const KinematicsProperty& unavailable_prop,
       const double& prop1, const double& prop2, const double& prop3) {
 
-      switch(output_prop) {
+      const ScalarSolve op = { prop1, prop2, prop3 };
+      return dispatch(output_prop, unavailable_prop, op);
+    }
 
-        case KinematicsProperty::INITIAL_VELOCITY:
-          switch(unavailable_prop) {
-            case KinematicsProperty::FINAL_VELOCITY:
-              // Prop Order: a,d,t
-              checkIsPositive(prop2, KinematicsProperty::DISTANCE);
-              checkIsPositive(prop3, KinematicsProperty::TIME);
-              // v_i = (d/t) - (0.5*a*t)
-              return (prop2 / prop3) - (0.5 * prop1 * prop3);
-            case KinematicsProperty::ACCELERATION:
-              // Prop Order: v_f,d,t
-              checkIsPositive(prop1, KinematicsProperty::FINAL_VELOCITY);
-              checkIsPositive(prop2, KinematicsProperty::DISTANCE);
-              checkIsPositive(prop3, KinematicsProperty::TIME);
-              // v_i = (2*d/t) - v_f
-              return (2 * prop2 / prop3) - prop1;
-            case KinematicsProperty::DISTANCE:
-              // Prop Order: v_f,a,t
-              checkIsPositive(prop1, KinematicsProperty::FINAL_VELOCITY);
-              checkIsPositive(prop3, KinematicsProperty::TIME);
-              // v_i = v_f - a * t
-              return prop1 - (prop2 * prop3);
-            case KinematicsProperty::TIME:
-            {
-              // Prop Order: v_f,a,d
-              checkIsPositive(prop1, KinematicsProperty::FINAL_VELOCITY);
-              checkIsPositive(prop3, KinematicsProperty::DISTANCE);
-              // v_i = sqrt(v_f^2 - 2*a*d)
-              const double vf_sqr = prop1*prop1;
-              const double a2 = prop2*2;
-              const double inner_term = vf_sqr - a2*prop3;
-              // Check for discontinuity 
-              if (inner_term < 0) {
-                std::ostringstream stream;
-                stream << "Discontinuity in calculation with v_f = " << prop1 << " a = " << prop2 << " d = " << prop3;
-                throw std::domain_error(stream.str());
-              }
-              
-              return sqrt(inner_term); // Take positive vi as that is a requirement of this function
-            }
-            default:
-              assertTypeException(unavailable_prop);
-              break;
-          }
-          break;
+    KinematicsResult trySolve(const KinematicsProperty& output_prop, const KinematicsProperty& unavailable_prop,
+      const double& prop1, const double& prop2, const double& prop3) noexcept {
 
-        case KinematicsProperty::FINAL_VELOCITY:
-          switch(unavailable_prop) {
-            case KinematicsProperty::INITIAL_VELOCITY:
-              // Prop Order: a,d,t
-              checkIsPositive(prop2, KinematicsProperty::DISTANCE);
-              checkIsPositive(prop3, KinematicsProperty::TIME);
-              // v_f = d/t + 0.5*a*t
-              return (prop2/prop3) + (0.5*prop1*prop3);
-            case KinematicsProperty::ACCELERATION:
-              // Prop Order: v_i,d,t
-              checkIsPositive(prop1, KinematicsProperty::INITIAL_VELOCITY);
-              checkIsPositive(prop2, KinematicsProperty::DISTANCE);
-              checkIsPositive(prop3, KinematicsProperty::TIME);
-              // v_f = 2*d/t - v_i
-              return (2*prop2/prop3) - prop1;
-            case KinematicsProperty::DISTANCE:
-              // Prop Order: v_i,a,t
-              checkIsPositive(prop1, KinematicsProperty::INITIAL_VELOCITY);
-              checkIsPositive(prop3, KinematicsProperty::TIME);
-              // v_f = v_i + a*t
-              return prop1 + (prop2*prop3);
-            case KinematicsProperty::TIME:
-            {
-              // Prop Order: v_i,a,d
-              checkIsPositive(prop1, KinematicsProperty::INITIAL_VELOCITY);
-              checkIsPositive(prop3, KinematicsProperty::DISTANCE);
-              // v_f = sqrt(v_i^2 + 2*a*d)
-              // Possible results are -v_f or +v_f
-              const double vi_sqr = prop1*prop1;
-              const double a2 = 2*prop2;
-              const double inner_term = vi_sqr + a2*prop3;
-              // Check for discontinuity 
-              if (inner_term < 0) {
-                std::ostringstream stream;
-                stream << "Discontinuity in calculation with v_i = " << prop1 << " a = " << prop2 << " d = " << prop3;
-                throw std::domain_error(stream.str());
-              }
+      const ScalarTrySolve op = { prop1, prop2, prop3 };
+      return dispatch(output_prop, unavailable_prop, op);
+    }
 
-              return sqrt(inner_term); // Take positive v_f as that is a requirement of this function
-            }
-            default:
-              assertTypeException(unavailable_prop);
-              break;
-          }
-          break;
+    void solve(const KinematicsProperty& output_prop, const KinematicsProperty& unavailable_prop,
+      const double* prop1, const double* prop2, const double* prop3, size_t count,
+      double* results, KinematicsError* errors) noexcept {
 
-        case KinematicsProperty::ACCELERATION:
-          switch(unavailable_prop) {
-            case KinematicsProperty::INITIAL_VELOCITY:
-              // Prop Order: v_f,d,t
-              checkIsPositive(prop1, KinematicsProperty::FINAL_VELOCITY);
-              checkIsPositive(prop2, KinematicsProperty::DISTANCE);
-              checkIsPositive(prop3, KinematicsProperty::TIME);
-              // a = (2/t) * (v_f - (d/t))
-              return (2/prop3) * (prop1 - (prop2/prop3));
-            case KinematicsProperty::FINAL_VELOCITY:
-              // Prop Order: v_i,d,t
-              checkIsPositive(prop1, KinematicsProperty::INITIAL_VELOCITY);
-              checkIsPositive(prop2, KinematicsProperty::DISTANCE);
-              checkIsPositive(prop3, KinematicsProperty::TIME);
-              // a = (2/t) * (d/t - v_i)
-              return (2/prop3) * ((prop2/prop3) - prop1);
-            case KinematicsProperty::DISTANCE:
-              // Prop Order: v_i,v_f,t
-              checkIsPositive(prop1, KinematicsProperty::INITIAL_VELOCITY);
-              checkIsPositive(prop2, KinematicsProperty::FINAL_VELOCITY);
-              checkIsPositive(prop3, KinematicsProperty::TIME);
-              // a = (v_f - v_i) / t
-              return (prop2 - prop1) / prop3;
-            case KinematicsProperty::TIME:
-              // Prop Order: v_i,v_f,d
-              checkIsPositive(prop1, KinematicsProperty::INITIAL_VELOCITY);
-              checkIsPositive(prop2, KinematicsProperty::FINAL_VELOCITY);
-              checkIsPositive(prop3, KinematicsProperty::DISTANCE);
-              // a = (v_f^2 - v_i^2) / (2*d)
-              return (prop2*prop2 - prop1*prop1) / (2*prop3);
-            default:
-              assertTypeException(unavailable_prop);
-              break;
-          }
-          break;
+      const BatchSolve op = { prop1, prop2, prop3, count, results, errors };
+      dispatch(output_prop, unavailable_prop, op);
+    }
 
-        case KinematicsProperty::DISTANCE:
-          switch(unavailable_prop) {
-            case KinematicsProperty::INITIAL_VELOCITY:
-              // Prop Order: v_f,a,t
-              checkIsPositive(prop1, KinematicsProperty::FINAL_VELOCITY);
-              checkIsPositive(prop3, KinematicsProperty::TIME);
-              // d = v_f*t - 0.5*a*t^2
-              return (prop1*prop3) - (0.5*prop2*prop3*prop3);
-            case KinematicsProperty::FINAL_VELOCITY:
-              // Prop Order: v_i,a,t
-              checkIsPositive(prop1, KinematicsProperty::INITIAL_VELOCITY);
-              checkIsPositive(prop3, KinematicsProperty::TIME);
-              // d = v_i*t + 0.5*a*t^2
-              return (prop1*prop3) + (0.5*prop2*prop3*prop3);
-            case KinematicsProperty::ACCELERATION:
-              // Prop Order: v_i,v_f,t
-              checkIsPositive(prop1, KinematicsProperty::INITIAL_VELOCITY);
-              checkIsPositive(prop2, KinematicsProperty::FINAL_VELOCITY);
-              checkIsPositive(prop3, KinematicsProperty::TIME);
-              // d = (v_i + v_f)*t / 2
-              return (prop1+prop2) * prop3 / 2;
-            case KinematicsProperty::TIME:
-              // Prop Order: v_i,v_f,a
-              checkIsPositive(prop1, KinematicsProperty::INITIAL_VELOCITY);
-              checkIsPositive(prop2, KinematicsProperty::FINAL_VELOCITY);
-              checkDeltaVAndAccelMatch(prop1, prop2, prop3);
-              // d = (v_f^2 - v_i^2) / 2*a
-              return (prop2*prop2 - prop1*prop1) / (2*prop3);
-            default:
-              assertTypeException(unavailable_prop);
-              break;
-          }
-          break;
-          
-        case KinematicsProperty::TIME:
-          switch(unavailable_prop) {
-            case KinematicsProperty::INITIAL_VELOCITY:
-            {
-              // Prop Order: v_f,a,d
-              checkIsPositive(prop1, KinematicsProperty::FINAL_VELOCITY);
-              checkIsPositive(prop3, KinematicsProperty::DISTANCE);
-              // t = (v_f - sqrt(v_f^2 - 2*a*d)) / a
-              // Need to evaluate both positive and negative v_i from square root
-              const double v_f_sqr = prop1*prop1;
-              const double ad_2 = 2*prop2*prop3;
-              // Inner term
-              const double inner_term = v_f_sqr - ad_2;
-              // Check for discontinuity 
-              if (inner_term < 0) {
-                std::ostringstream stream;
-                stream << "Discontinuity in calculation with v_f = " << prop1 << " a = " << prop2 << " d = " << prop3;
-                throw std::domain_error(stream.str());
-              }
-              const double pos_vi = sqrt(inner_term); // Take positive vi as that is a requirement of this function
-              return (prop1 - pos_vi) / prop2;
-            }
-            case KinematicsProperty::FINAL_VELOCITY:
-            {
-              // Prop Order: v_i,a,d
-              checkIsPositive(prop1, KinematicsProperty::INITIAL_VELOCITY);
-              checkIsPositive(prop3, KinematicsProperty::DISTANCE);
-              // t = (sqrt(v_i^2 + 2*a*d) - v_i) / a
-              
-              const double v_i_sqr = prop1*prop1;
+    size_t solve(const KinematicsProperty& output_prop, const KinematicsProperty& unavailable_prop,
+      const std::vector<double>& prop1, const std::vector<double>& prop2, const std::vector<double>& prop3,
+      std::vector<double>& results, std::vector<KinematicsError>& errors) {
 
-              // Inner term
-              const double inner_term = v_i_sqr + 2*prop2*prop3;
-              // Check for discontinuity 
-              if (inner_term < 0) {
-                std::ostringstream stream;
-                stream << "Discontinuity in calculation with v_f = " << prop1 << " a = " << prop2 << " d = " << prop3;
-                throw std::domain_error(stream.str());
-              }
+      if (prop1.size() != prop2.size() || prop1.size() != prop3.size()) {
+        std::ostringstream stream;
+        stream << "Mismatched input sizes prop1: " << prop1.size() << " prop2: " << prop2.size() << " prop3: " << prop3.size();
+        throw std::invalid_argument(stream.str());
+      }
 
-              const double v_f_pos = sqrt(inner_term); // Take v_f as positive since that is a requirement of this function
-              return (v_f_pos - prop1) / prop2;
-            }
-            case KinematicsProperty::ACCELERATION:
-              // Prop Order: v_i,v_f,d
-              checkIsPositive(prop1, KinematicsProperty::INITIAL_VELOCITY);
-              checkIsPositive(prop2, KinematicsProperty::FINAL_VELOCITY);
-              checkIsPositive(prop3, KinematicsProperty::DISTANCE);
-              // t = (2*d) / (v_i+v_f)
-              return (2*prop3) / (prop1+prop2);
-            case KinematicsProperty::DISTANCE:
-              // Prop Order: v_i,v_f,a
-              checkIsPositive(prop1, KinematicsProperty::INITIAL_VELOCITY);
-              checkIsPositive(prop2, KinematicsProperty::FINAL_VELOCITY);
-              checkDeltaVAndAccelMatch(prop1, prop2, prop3);
-              // t = (v_f - v_i) / a
-              return (prop2 - prop1) / prop3;
-            default:
-              assertTypeException(unavailable_prop);
-              break;
-          }
-          break;
+      results.resize(prop1.size());
+      errors.resize(prop1.size());
+      solve(output_prop, unavailable_prop, prop1.data(), prop2.data(), prop3.data(), prop1.size(), results.data(), errors.data());
 
-        // This should never be reached unless enum KinematicProperty enum is changed without updating this function
-        default:
-          assertTypeException(output_prop);
-          break;
+      size_t solved = 0;
+      for (const KinematicsError& error : errors) {
+        solved += error == KinematicsError::NONE;
       }
+      return solved;
     }
   }
 }
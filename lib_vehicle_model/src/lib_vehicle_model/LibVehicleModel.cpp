@@ -15,13 +15,23 @@
  */
 
 #include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <string>
+#include <unordered_map>
 #include <dlfcn.h>
 #include <sstream>
+#include <cstring>
+#include <cerrno>
+#include <sys/mman.h>
 #include "lib_vehicle_model/LibVehicleModel.h"
 #include "lib_vehicle_model/ROSParameterServer.h"
+#include "lib_vehicle_model/Tracing.h"
 #include "ModelLoader.h"
 #include "ConstraintChecker.h"
+#include "StatisticsRecorder.h"
 
 
 
@@ -38,6 +48,255 @@ namespace lib_vehicle_model {
     std::unique_ptr<VehicleMotionModel, ModelLoader::destroy_fnc_ptr> vehicle_model_(nullptr, nullptr);
     std::unique_ptr<ConstraintChecker> constraint_checker_;
     bool modelLoaded_ = false; // Flag indicating init has already been called
+
+    // Per-thread clones of the loaded vehicle model
+    std::mutex model_pool_mutex_;
+    std::unordered_map<std::thread::id, std::shared_ptr<VehicleMotionModel>> model_pool_;
+    std::atomic<uint64_t> model_generation_(0); // Incremented each time a model is loaded or unloaded so stale thread caches are ignored
+
+    /**
+     * @brief Returns the number of steps a prediction without control inputs will integrate
+     */
+    uint64_t noControlSteps(double timestep, double delta_t) {
+      if (!(timestep > 0) || delta_t <= timestep) {
+        return 1;
+      }
+      return static_cast<uint64_t>(delta_t / timestep);
+    }
+
+    /**
+     * Optional warm-up configuration read at init
+     */
+    struct WarmUpConfig {
+      std::vector<int> horizons; // Number of steps in each synthetic prediction. Empty if warm-up is disabled
+      double timestep = 0.1;
+      int iterations = 3;
+    };
+    double warm_up_duration_ = 0.0; // Duration of the last warm-up in seconds
+
+    /**
+     * @brief Loads the optional warm-up parameters
+     * 
+     * Warm-up is only enabled if the warm_up_horizons parameter is set.
+     * The warm_up_timestep and warm_up_iterations parameters are only read in that case.
+     * 
+     * @throws std::invalid_argument If a warm-up parameter is set but invalid
+     */
+    WarmUpConfig loadWarmUpConfig(std::shared_ptr<ParameterServer> parameter_server) {
+      WarmUpConfig config;
+      if (!parameter_server->getParam("warm_up_horizons", config.horizons)) {
+        config.horizons.clear();
+        return config;
+      }
+
+      parameter_server->getParam("warm_up_timestep", config.timestep);
+      parameter_server->getParam("warm_up_iterations", config.iterations);
+
+      for (int horizon : config.horizons) {
+        if (horizon <= 0) {
+          std::ostringstream msg;
+          msg << "Invalid warm_up_horizons entry: " << horizon << " The number of steps must be positive";
+          throw std::invalid_argument(msg.str());
+        }
+      }
+
+      if (!(config.timestep > 0)) {
+        std::ostringstream msg;
+        msg << "Invalid warm_up_timestep: " << config.timestep << " The timestep must be positive";
+        throw std::invalid_argument(msg.str());
+      }
+
+      if (config.iterations < 0) {
+        std::ostringstream msg;
+        msg << "Invalid warm_up_iterations: " << config.iterations << " The number of iterations cannot be negative";
+        throw std::invalid_argument(msg.str());
+      }
+
+      return config;
+    }
+
+    /**
+     * Optional real-time configuration read at init
+     */
+    struct RealTimeConfig {
+      size_t max_horizon = 0; // Largest number of steps accepted by predictRealTime. 0 if real-time mode is disabled
+      bool lock_memory = false;
+    };
+    size_t real_time_max_horizon_ = 0; // Max horizon of the loaded model. 0 if real-time mode is disabled
+    bool memory_locked_ = false; // True if init called mlockall
+
+    /**
+     * @brief Loads the optional real-time parameters
+     * 
+     * Real-time mode is only enabled if the real_time_max_horizon parameter is set.
+     * The real_time_lock_memory parameter is only read in that case.
+     * 
+     * @throws std::invalid_argument If a real-time parameter is set but invalid
+     */
+    RealTimeConfig loadRealTimeConfig(std::shared_ptr<ParameterServer> parameter_server) {
+      RealTimeConfig config;
+      int max_horizon = 0;
+      if (!parameter_server->getParam("real_time_max_horizon", max_horizon)) {
+        return config;
+      }
+
+      if (max_horizon <= 0) {
+        std::ostringstream msg;
+        msg << "Invalid real_time_max_horizon: " << max_horizon << " The number of steps must be positive";
+        throw std::invalid_argument(msg.str());
+      }
+
+      config.max_horizon = static_cast<size_t>(max_horizon);
+      parameter_server->getParam("real_time_lock_memory", config.lock_memory);
+
+      return config;
+    }
+
+    /**
+     * Cache of the model instance used by the current thread so the pool is only locked on a thread's first call
+     * Owns the thread's entry in the pool so the clone is released when the thread exits
+     */
+    struct ThreadModelCache {
+      uint64_t generation = 0;
+      VehicleMotionModel* model = nullptr;
+      bool pooled = false; // True if model is a clone held by model_pool_ for this thread
+
+      ~ThreadModelCache() {
+        if (pooled) {
+          // The clone is destroyed under the pool lock so unload() cannot close its library at the same time
+          std::lock_guard<std::mutex> guard(model_pool_mutex_);
+          model_pool_.erase(std::this_thread::get_id());
+        }
+        model = nullptr;
+        pooled = false;
+      }
+    };
+    thread_local ThreadModelCache thread_model_cache_;
+
+    /**
+     * @brief Returns the model instance which the calling thread should use for predictions
+     * 
+     * Stateless models and models which do not support cloning are shared by all threads.
+     * Otherwise each thread gets its own clone of the loaded model which is released when the thread exits or the model is unloaded.
+     * 
+     * NOTE: Must only be called while a model is loaded
+     */
+    VehicleMotionModel* threadModel() {
+      const uint64_t generation = model_generation_.load();
+      if (thread_model_cache_.model && thread_model_cache_.generation == generation) {
+        return thread_model_cache_.model;
+      }
+
+      VehicleMotionModel* model = vehicle_model_.get();
+      bool pooled = false;
+      if (!model->isStateless()) {
+        std::lock_guard<std::mutex> guard(model_pool_mutex_);
+        std::shared_ptr<VehicleMotionModel>& thread_clone = model_pool_[std::this_thread::get_id()];
+        if (!thread_clone) {
+          thread_clone = model->clone();
+        }
+        if (thread_clone) {
+          model = thread_clone.get();
+          pooled = true;
+        } else {
+          model_pool_.erase(std::this_thread::get_id()); // Cloning is not supported so the shared model is used
+        }
+      }
+
+      thread_model_cache_.generation = generation;
+      thread_model_cache_.model = model;
+      thread_model_cache_.pooled = pooled;
+      return model;
+    }
+
+    thread_local uint64_t real_time_generation_ = 0; // Model generation the current thread was last prepared for real-time predictions
+
+    /**
+     * @brief Performs all allocations needed by the calling thread's real-time predictions
+     * 
+     * NOTE: Must only be called while a model is loaded and real-time mode is enabled
+     * 
+     * @return True if the thread's model instance is real-time safe
+     */
+    bool prepareThreadForRealTime() {
+      VehicleMotionModel* model = threadModel();
+      model->reserveRealTime(real_time_max_horizon_);
+
+      // Register this thread with the statistics recorder so its first real-time call does not allocate
+      StatisticsRecorder::registerThread();
+
+      real_time_generation_ = thread_model_cache_.generation;
+      return model->isRealTimeSafe();
+    }
+
+    /**
+     * @brief Predicts into a trajectory allocated from the provided resource using this thread's model instance
+     * 
+     * Real-time safe models integrate directly into the trajectory. Other models fall back to their list based predict function.
+     * 
+     * NOTE: Must only be called while a model is loaded and after the inputs have been validated
+     * 
+     * @throws std::invalid_argument If a real-time safe model failed to complete the prediction
+     */
+    ResourceVector<VehicleState> predictIntoResource(const VehicleState& initial_state,
+      const VehicleControlInput* control_inputs, size_t count, double timestep, MemoryResource& resource) {
+
+      VehicleMotionModel* model = threadModel();
+      const ResourceAllocator<VehicleState> allocator(&resource);
+
+      if (!model->isRealTimeSafe()) {
+        std::vector<VehicleState> states = model->predict(initial_state, std::vector<VehicleControlInput>(control_inputs, control_inputs + count), timestep);
+        return ResourceVector<VehicleState>(states.begin(), states.end(), allocator);
+      }
+
+      ResourceVector<VehicleState> states(count, VehicleState(), allocator);
+      if (!model->predictInto(initial_state, control_inputs, count, timestep, states.data())) {
+        throw std::invalid_argument("The loaded vehicle model failed to complete the prediction");
+      }
+      return states;
+    }
+
+    /**
+     * @brief Runs synthetic predictions through the loaded model so page faults, cold caches and lazy allocations
+     *        are paid for during init instead of by the first real predictions
+     * 
+     * The synthetic calls go directly to the model so they are not included in the prediction statistics.
+     * 
+     * @return The duration of the warm-up in seconds
+     */
+    double warmUp(const WarmUpConfig& config) {
+      tracing::ScopedSpan span("warmUp", "lib_vehicle_model");
+      const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+      // Pre-size the per-thread model pool and create the clone for the initializing thread
+      {
+        std::lock_guard<std::mutex> guard(model_pool_mutex_);
+        model_pool_.reserve(std::max(1u, std::thread::hardware_concurrency()));
+      }
+      VehicleMotionModel* model = threadModel();
+
+      VehicleState initial_state; // All values default to 0
+      for (int i = 0; i < config.iterations; i++) {
+        for (int horizon : config.horizons) {
+          std::vector<VehicleControlInput> control_inputs(horizon);
+
+          // Exercise the validation code paths. The synthetic inputs are not required to satisfy the configured limits
+          try {
+            constraint_checker_->validateInitialState(initial_state);
+            constraint_checker_->validateControlInputs(initial_state, control_inputs, config.timestep);
+          } catch (const std::invalid_argument&) {}
+
+          model->predict(initial_state, config.timestep, horizon * config.timestep);
+          model->predict(initial_state, control_inputs, config.timestep);
+          model->predictReduced(initial_state, control_inputs, config.timestep);
+        }
+      }
+
+      // Register this thread with the statistics recorder so its first real call does not allocate
+      StatisticsRecorder::registerThread();
+
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
   }
 
   //
@@ -45,6 +304,8 @@ namespace lib_vehicle_model {
   //
   void init(std::shared_ptr<ParameterServer> parameter_server) {
 
+    tracing::ScopedSpan span("init", "lib_vehicle_model");
+
     // Mutex lock to ensure thread safety of lib loading and parameter loading
     // Since this function is the only place static data members are modified all other functions should be thread safe
     std::lock_guard<std::mutex> guard(init_mutex_); 
@@ -63,12 +324,47 @@ namespace lib_vehicle_model {
       throw std::invalid_argument("The vehicle path param vehicle_model_lib_path could not be found or read");
     }
 
+    WarmUpConfig warm_up_config = loadWarmUpConfig(parameter_server);
+    RealTimeConfig real_time_config = loadRealTimeConfig(parameter_server);
+
     constraint_checker_.reset(new ConstraintChecker(parameter_server));
 
     // Load the vehicle model to be used
     vehicle_model_ = ModelLoader::load(vehicle_model_lib_path);
     vehicle_model_->setParameterServer(parameter_server);
 
+    // Invalidate any thread caches from a previously loaded model
+    model_generation_++;
+
+    // Run the optional warm-up before any real predictions are made
+    warm_up_duration_ = warm_up_config.horizons.empty() ? 0.0 : warmUp(warm_up_config);
+
+    // Allocate the real-time buffers of the initializing thread
+    real_time_max_horizon_ = real_time_config.max_horizon;
+    if (real_time_max_horizon_ > 0) {
+      prepareThreadForRealTime();
+    }
+
+    // Lock memory only once the model has loaded and warmed up so a failed init never leaves the process locked
+    // MCL_CURRENT also covers the pages of the loaded model
+    if (real_time_config.lock_memory && !memory_locked_) {
+      if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        const int lock_error = errno;
+        {
+          std::lock_guard<std::mutex> pool_guard(model_pool_mutex_);
+          model_pool_.clear();
+          model_generation_++;
+        }
+        vehicle_model_.reset();
+        real_time_max_horizon_ = 0;
+
+        std::ostringstream msg;
+        msg << "real_time_lock_memory was set but mlockall failed with error: " << strerror(lock_error);
+        throw std::invalid_argument(msg.str());
+      }
+      memory_locked_ = true;
+    }
+
     // Set model loading flag
     modelLoaded_ = true;
   }
@@ -84,18 +380,32 @@ namespace lib_vehicle_model {
 
     // Release allocated objects
     if (modelLoaded_) {
+      {
+        // Release the per-thread clones before the model they were created from
+        std::lock_guard<std::mutex> pool_guard(model_pool_mutex_);
+        model_pool_.clear();
+        model_generation_++;
+      }
       vehicle_model_.reset(); // Release and call loaded lib destructor
       constraint_checker_.reset();
+      real_time_max_horizon_ = 0;
+      if (memory_locked_) {
+        munlockall();
+        memory_locked_ = false;
+      }
       modelLoaded_ = false;
     }
   }
 
   std::vector<VehicleState> predict(const VehicleState& initial_state,
     double timestep, double delta_t) {
-      
+      tracing::ScopedSpan span("predict", "lib_vehicle_model");
+
       if (!modelLoaded_) {
         throw ModelAccessException("Attempted to use lib_vehicle_model::predict before model was loaded with call to lib_vehicle_model::init()");
       }
+
+      ScopedPredictRecord record(PredictCallType::PREDICT_NO_CONTROL, noControlSteps(timestep, delta_t));
       
       // Validate inputs
       if (timestep > delta_t) {
@@ -105,22 +415,449 @@ namespace lib_vehicle_model {
       }
       
       constraint_checker_->validateInitialState(initial_state);
-      // Pass request to loaded vehicle model
-      return vehicle_model_->predict(initial_state, timestep, delta_t);
+      record.validated();
+
+      // Pass request to this thread's instance of the loaded vehicle model
+      return threadModel()->predict(initial_state, timestep, delta_t);
     }
 
   std::vector<VehicleState> predict(const VehicleState& initial_state,
     const std::vector<VehicleControlInput>& control_inputs, double timestep) {
+      tracing::ScopedSpan span("predict", "lib_vehicle_model");
 
       if (!modelLoaded_) {
         throw ModelAccessException("Attempted to use lib_vehicle_model::predict before model was loaded with call to lib_vehicle_model::init()");
       }
 
+      ScopedPredictRecord record(PredictCallType::PREDICT_WITH_CONTROL, control_inputs.size());
+
       // Validate inputs
       constraint_checker_->validateInitialState(initial_state);
       constraint_checker_->validateControlInputs(initial_state, control_inputs, timestep);
+      record.validated();
 
-      // Pass request to loaded vehicle model
-      return vehicle_model_->predict(initial_state, control_inputs, timestep);
+      // Pass request to this thread's instance of the loaded vehicle model
+      return threadModel()->predict(initial_state, control_inputs, timestep);
     }
+
+  std::vector<VehicleState> predict(const VehicleState& initial_state,
+    double timestep, double delta_t, size_t output_stride) {
+      tracing::ScopedSpan span("predict", "lib_vehicle_model");
+
+      if (!modelLoaded_) {
+        throw ModelAccessException("Attempted to use lib_vehicle_model::predict before model was loaded with call to lib_vehicle_model::init()");
+      }
+
+      ScopedPredictRecord record(PredictCallType::PREDICT_NO_CONTROL_STRIDE, noControlSteps(timestep, delta_t));
+
+      // Validate inputs
+      if (output_stride == 0) {
+        throw std::invalid_argument("Invalid output_stride: 0. The stride must be at least 1");
+      }
+
+      if (timestep > delta_t) {
+        std::ostringstream msg;
+        msg << "Invalid timestep: " << timestep << " is smaller than delta_t : " << delta_t;
+        throw std::invalid_argument(msg.str());
+      }
+
+      constraint_checker_->validateInitialState(initial_state);
+      record.validated();
+
+      // Pass request to this thread's instance of the loaded vehicle model
+      return threadModel()->predict(initial_state, timestep, delta_t, output_stride);
+    }
+
+  std::vector<VehicleState> predict(const VehicleState& initial_state,
+    const std::vector<VehicleControlInput>& control_inputs, double timestep, size_t output_stride) {
+      tracing::ScopedSpan span("predict", "lib_vehicle_model");
+
+      if (!modelLoaded_) {
+        throw ModelAccessException("Attempted to use lib_vehicle_model::predict before model was loaded with call to lib_vehicle_model::init()");
+      }
+
+      ScopedPredictRecord record(PredictCallType::PREDICT_WITH_CONTROL_STRIDE, control_inputs.size());
+
+      // Validate inputs
+      if (output_stride == 0) {
+        throw std::invalid_argument("Invalid output_stride: 0. The stride must be at least 1");
+      }
+
+      constraint_checker_->validateInitialState(initial_state);
+      constraint_checker_->validateControlInputs(initial_state, control_inputs, timestep);
+      record.validated();
+
+      // Pass request to this thread's instance of the loaded vehicle model
+      return threadModel()->predict(initial_state, control_inputs, timestep, output_stride);
+    }
+
+  std::vector<VehicleState> predict(const VehicleState& initial_state,
+    const std::vector<TimedControlInput>& control_changes, double timestep, double delta_t) {
+      tracing::ScopedSpan span("predict", "lib_vehicle_model");
+
+      if (!modelLoaded_) {
+        throw ModelAccessException("Attempted to use lib_vehicle_model::predict before model was loaded with call to lib_vehicle_model::init()");
+      }
+
+      ScopedPredictRecord record(PredictCallType::PREDICT_CONTROL_CHANGES, noControlSteps(timestep, delta_t));
+
+      // Validate inputs
+      if (timestep > delta_t) {
+        std::ostringstream msg;
+        msg << "Invalid timestep: " << timestep << " is smaller than delta_t : " << delta_t;
+        throw std::invalid_argument(msg.str());
+      }
+
+      constraint_checker_->validateInitialState(initial_state);
+      constraint_checker_->validateControlChanges(initial_state, control_changes, timestep);
+      record.validated();
+
+      // Pass request to this thread's instance of the loaded vehicle model
+      return threadModel()->predict(initial_state, control_changes, timestep, delta_t);
+    }
+
+  std::vector<VehicleState> predict(const VehicleState& initial_state,
+    const std::vector<TimedControlInput>& control_changes, double timestep, double delta_t, size_t output_stride) {
+      tracing::ScopedSpan span("predict", "lib_vehicle_model");
+
+      if (!modelLoaded_) {
+        throw ModelAccessException("Attempted to use lib_vehicle_model::predict before model was loaded with call to lib_vehicle_model::init()");
+      }
+
+      ScopedPredictRecord record(PredictCallType::PREDICT_CONTROL_CHANGES_STRIDE, noControlSteps(timestep, delta_t));
+
+      // Validate inputs
+      if (output_stride == 0) {
+        throw std::invalid_argument("Invalid output_stride: 0. The stride must be at least 1");
+      }
+
+      if (timestep > delta_t) {
+        std::ostringstream msg;
+        msg << "Invalid timestep: " << timestep << " is smaller than delta_t : " << delta_t;
+        throw std::invalid_argument(msg.str());
+      }
+
+      constraint_checker_->validateInitialState(initial_state);
+      constraint_checker_->validateControlChanges(initial_state, control_changes, timestep);
+      record.validated();
+
+      // Pass request to this thread's instance of the loaded vehicle model
+      return threadModel()->predict(initial_state, control_changes, timestep, delta_t, output_stride);
+    }
+
+  ValidatedControls validateControls(const std::vector<VehicleControlInput>& control_inputs, double timestep) {
+      tracing::ScopedSpan span("validateControls", "lib_vehicle_model");
+
+      if (!modelLoaded_) {
+        throw ModelAccessException("Attempted to use lib_vehicle_model::validateControls before model was loaded with call to lib_vehicle_model::init()");
+      }
+
+      // Read the generation first so a concurrent reload can only make the token stale
+      const uint64_t generation = model_generation_.load();
+      constraint_checker_->validateControlSequence(control_inputs, timestep);
+
+      return ValidatedControls(control_inputs, timestep, generation);
+    }
+
+  std::vector<VehicleState> predict(const VehicleState& initial_state, const ValidatedControls& controls) {
+      tracing::ScopedSpan span("predict", "lib_vehicle_model");
+
+      if (!modelLoaded_) {
+        throw ModelAccessException("Attempted to use lib_vehicle_model::predict before model was loaded with call to lib_vehicle_model::init()");
+      }
+
+      const std::vector<VehicleControlInput>& control_inputs = controls.getControlInputs();
+      ScopedPredictRecord record(PredictCallType::PREDICT_VALIDATED_CONTROLS, control_inputs.size());
+
+      // Validate inputs
+      if (controls.empty()) {
+        throw std::invalid_argument("Invalid controls: the ValidatedControls token is empty");
+      }
+
+      if (controls.getParameterGeneration() != model_generation_.load()) {
+        std::ostringstream msg;
+        msg << "Invalid controls: the ValidatedControls token was validated at parameter generation " << controls.getParameterGeneration()
+          << " but the current generation is " << model_generation_.load();
+        throw std::invalid_argument(msg.str());
+      }
+
+      constraint_checker_->validateInitialState(initial_state);
+      constraint_checker_->validateInitialSteeringRate(initial_state, control_inputs.front(), controls.getTimestep());
+      record.validated();
+
+      // Pass request to this thread's instance of the loaded vehicle model
+      return threadModel()->predict(initial_state, control_inputs, controls.getTimestep());
+    }
+
+  ResourceVector<VehicleState> predict(const VehicleState& initial_state,
+    double timestep, double delta_t, MemoryResource& resource) {
+      tracing::ScopedSpan span("predict", "lib_vehicle_model");
+
+      if (!modelLoaded_) {
+        throw ModelAccessException("Attempted to use lib_vehicle_model::predict before model was loaded with call to lib_vehicle_model::init()");
+      }
+
+      const uint64_t num_steps = noControlSteps(timestep, delta_t);
+      ScopedPredictRecord record(PredictCallType::PREDICT_NO_CONTROL_RESOURCE, num_steps);
+
+      // Validate inputs
+      if (timestep > delta_t) {
+        std::ostringstream msg;
+        msg << "Invalid timestep: " << timestep << " is smaller than delta_t : " << delta_t;
+        throw std::invalid_argument(msg.str());
+      }
+
+      constraint_checker_->validateInitialState(initial_state);
+      record.validated();
+
+      // This prediction takes in no new control inputs so repeat the previous commands from the state
+      VehicleControlInput control_input;
+      control_input.target_steering_angle = initial_state.prev_steering_cmd;
+      control_input.target_velocity = initial_state.prev_vel_cmd;
+      const ResourceVector<VehicleControlInput> control_inputs(num_steps, control_input, ResourceAllocator<VehicleControlInput>(&resource));
+
+      // Pass request to this thread's instance of the loaded vehicle model
+      return predictIntoResource(initial_state, control_inputs.data(), control_inputs.size(), timestep, resource);
+    }
+
+  ResourceVector<VehicleState> predict(const VehicleState& initial_state,
+    const std::vector<VehicleControlInput>& control_inputs, double timestep, MemoryResource& resource) {
+      tracing::ScopedSpan span("predict", "lib_vehicle_model");
+
+      if (!modelLoaded_) {
+        throw ModelAccessException("Attempted to use lib_vehicle_model::predict before model was loaded with call to lib_vehicle_model::init()");
+      }
+
+      ScopedPredictRecord record(PredictCallType::PREDICT_WITH_CONTROL_RESOURCE, control_inputs.size());
+
+      // Validate inputs
+      constraint_checker_->validateInitialState(initial_state);
+      constraint_checker_->validateControlInputs(initial_state, control_inputs, timestep);
+      record.validated();
+
+      // Pass request to this thread's instance of the loaded vehicle model
+      return predictIntoResource(initial_state, control_inputs.data(), control_inputs.size(), timestep, resource);
+    }
+
+  std::vector<ReducedVehicleState> predictReduced(const VehicleState& initial_state,
+    double timestep, double delta_t) {
+      tracing::ScopedSpan span("predictReduced", "lib_vehicle_model");
+
+      if (!modelLoaded_) {
+        throw ModelAccessException("Attempted to use lib_vehicle_model::predictReduced before model was loaded with call to lib_vehicle_model::init()");
+      }
+
+      ScopedPredictRecord record(PredictCallType::PREDICT_REDUCED_NO_CONTROL, noControlSteps(timestep, delta_t));
+
+      // Validate inputs
+      if (timestep > delta_t) {
+        std::ostringstream msg;
+        msg << "Invalid timestep: " << timestep << " is smaller than delta_t : " << delta_t;
+        throw std::invalid_argument(msg.str());
+      }
+
+      constraint_checker_->validateInitialState(initial_state);
+      record.validated();
+
+      // Pass request to this thread's instance of the loaded vehicle model
+      return threadModel()->predictReduced(initial_state, timestep, delta_t);
+    }
+
+  std::vector<ReducedVehicleState> predictReduced(const VehicleState& initial_state,
+    const std::vector<VehicleControlInput>& control_inputs, double timestep) {
+      tracing::ScopedSpan span("predictReduced", "lib_vehicle_model");
+
+      if (!modelLoaded_) {
+        throw ModelAccessException("Attempted to use lib_vehicle_model::predictReduced before model was loaded with call to lib_vehicle_model::init()");
+      }
+
+      ScopedPredictRecord record(PredictCallType::PREDICT_REDUCED_WITH_CONTROL, control_inputs.size());
+
+      // Validate inputs
+      constraint_checker_->validateInitialState(initial_state);
+      constraint_checker_->validateControlInputs(initial_state, control_inputs, timestep);
+      record.validated();
+
+      // Pass request to this thread's instance of the loaded vehicle model
+      return threadModel()->predictReduced(initial_state, control_inputs, timestep);
+    }
+
+  VehicleState predictStep(const VehicleState& initial_state,
+    const VehicleControlInput& control_input, double timestep) {
+      tracing::ScopedSpan span("predictStep", "lib_vehicle_model");
+
+      if (!modelLoaded_) {
+        throw ModelAccessException("Attempted to use lib_vehicle_model::predictStep before model was loaded with call to lib_vehicle_model::init()");
+      }
+
+      ScopedPredictRecord record(PredictCallType::PREDICT_STEP, 1);
+
+      // Validate inputs
+      constraint_checker_->validateInitialState(initial_state);
+      constraint_checker_->validateControlInputs(initial_state, std::vector<VehicleControlInput>(1, control_input), timestep);
+      record.validated();
+
+      // Pass request to this thread's instance of the loaded vehicle model
+      return threadModel()->predictStep(initial_state, control_input, timestep);
+    }
+
+  TrajectoryRange predictLazy(const VehicleState& initial_state,
+    const std::vector<VehicleControlInput>& control_inputs, double timestep) {
+      tracing::ScopedSpan span("predictLazy", "lib_vehicle_model");
+
+      if (!modelLoaded_) {
+        throw ModelAccessException("Attempted to use lib_vehicle_model::predictLazy before model was loaded with call to lib_vehicle_model::init()");
+      }
+
+      ScopedPredictRecord record(PredictCallType::PREDICT_LAZY, control_inputs.size());
+
+      // Validate all inputs up front as this does not require any integration
+      constraint_checker_->validateInitialState(initial_state);
+      constraint_checker_->validateControlInputs(initial_state, control_inputs, timestep);
+      record.validated();
+
+      // Each step goes to the loaded vehicle model without repeating the validation
+      return TrajectoryRange(
+        [](const VehicleState& state, const VehicleControlInput& control, double step_timestep) -> VehicleState {
+          if (!modelLoaded_) {
+            throw ModelAccessException("Attempted to advance a lib_vehicle_model::predictLazy range after the model was unloaded");
+          }
+          return threadModel()->predictStep(state, control, step_timestep);
+        },
+        initial_state, control_inputs, timestep
+      );
+    }
+
+  bool prepareRealTimeThread() {
+    if (!modelLoaded_) {
+      throw ModelAccessException("Attempted to use lib_vehicle_model::prepareRealTimeThread before model was loaded with call to lib_vehicle_model::init()");
+    }
+
+    if (real_time_max_horizon_ == 0) {
+      throw std::invalid_argument("Real-time predictions are disabled as the real_time_max_horizon param was not set");
+    }
+
+    return prepareThreadForRealTime();
+  }
+
+  PredictStatus predictRealTime(const VehicleState& initial_state,
+    const VehicleControlInput* control_inputs, size_t count, double timestep, VehicleState* output) noexcept {
+      tracing::ScopedSpan span("predictRealTime", "lib_vehicle_model");
+
+      if (!modelLoaded_) {
+        return PredictStatus::MODEL_NOT_LOADED;
+      }
+
+      if (real_time_max_horizon_ == 0) {
+        return PredictStatus::REAL_TIME_DISABLED;
+      }
+
+      // Only the cached model instance is used as obtaining a new one would lock and allocate
+      if (real_time_generation_ != model_generation_.load() || thread_model_cache_.generation != real_time_generation_) {
+        return PredictStatus::THREAD_NOT_PREPARED;
+      }
+
+      ScopedPredictRecord record(PredictCallType::PREDICT_REAL_TIME, count);
+
+      // Validate inputs
+      if (count > real_time_max_horizon_) {
+        return PredictStatus::HORIZON_TOO_LONG;
+      }
+
+      if (!output || !constraint_checker_->isValidInitialState(initial_state)
+        || !constraint_checker_->areValidControlInputs(initial_state, control_inputs, count, timestep)) {
+        return PredictStatus::INVALID_INPUT;
+      }
+      record.validated();
+
+      // Write directly into the caller's buffer using this thread's instance of the loaded vehicle model
+      if (!thread_model_cache_.model->predictInto(initial_state, control_inputs, count, timestep, output)) {
+        return PredictStatus::MODEL_FAILURE;
+      }
+
+      return PredictStatus::SUCCESS;
+    }
+
+  bool checkControlInputs(const VehicleState& initial_state,
+    const std::vector<VehicleControlInput>& control_inputs, double timestep, ControlViolationReport& report) {
+
+      if (!modelLoaded_) {
+        throw ModelAccessException("Attempted to use lib_vehicle_model::checkControlInputs before model was loaded with call to lib_vehicle_model::init()");
+      }
+
+      return constraint_checker_->checkControlInputs(initial_state, control_inputs.data(), control_inputs.size(), timestep, report);
+    }
+
+  std::vector<VehicleControlInput> sanitizeControlInputs(const VehicleState& initial_state,
+    const std::vector<VehicleControlInput>& control_inputs, double timestep, ControlViolationReport& report) {
+
+      if (!modelLoaded_) {
+        throw ModelAccessException("Attempted to use lib_vehicle_model::sanitizeControlInputs before model was loaded with call to lib_vehicle_model::init()");
+      }
+
+      if (control_inputs.empty()) {
+        throw std::invalid_argument("Invalid control_inputs: empty vector provided as control inputs");
+      }
+
+      if (!(timestep > 0.0)) {
+        throw std::invalid_argument("Invalid timestep for sanitizeControlInputs: timestep must be greater than 0");
+      }
+
+      // The rate limit of the first input is relative to the initial state so it must already be within the limits
+      constraint_checker_->validateInitialState(initial_state);
+
+      std::vector<VehicleControlInput> sanitized(control_inputs);
+      constraint_checker_->sanitizeControlInputs(initial_state, sanitized.data(), sanitized.size(), timestep, report);
+
+      return sanitized;
+    }
+
+  size_t checkControlBatch(const ControlBatch& batch, double timestep, ControlViolation* results) {
+
+      if (!modelLoaded_) {
+        throw ModelAccessException("Attempted to use lib_vehicle_model::checkControlBatch before model was loaded with call to lib_vehicle_model::init()");
+      }
+
+      if (batch.sequence_count == 0) {
+        return 0;
+      }
+
+      // Empty control sequences are rejected as they are by predict()
+      if (batch.horizon == 0) {
+        throw std::invalid_argument("Invalid control batch: horizon of 0 provided for a non-empty batch");
+      }
+
+      if (!results || !batch.initial_steering_angles || !batch.target_velocities || !batch.target_steering_angles) {
+        throw std::invalid_argument("Invalid control batch: null array provided for a non-empty batch");
+      }
+
+      constraint_checker_->checkControlBatch(batch, timestep, results);
+
+      return std::count(results, results + batch.sequence_count, ControlViolation::NONE);
+    }
+
+  PredictionStatistics getPredictionStatistics() {
+    return StatisticsRecorder::snapshot();
+  }
+
+  void resetPredictionStatistics() {
+    StatisticsRecorder::reset();
+  }
+
+  double getWarmUpDuration() {
+    std::lock_guard<std::mutex> guard(init_mutex_);
+    return warm_up_duration_;
+  }
+
+  uint64_t getParameterGeneration() {
+    return model_generation_.load();
+  }
+
+  bool isFrameInvariant() {
+    if (!modelLoaded_) {
+      throw ModelAccessException("Attempted to use lib_vehicle_model::isFrameInvariant before model was loaded with call to lib_vehicle_model::init()");
+    }
+
+    return threadModel()->isFrameInvariant();
+  }
 }
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include "lib_vehicle_model/MemoryResource.h"
+
+/**
+ * Cpp containing the implementation of newDeleteResource and MonotonicBufferResource
+ */
+namespace lib_vehicle_model {
+
+  //
+  // Private Namespace
+  //
+  namespace {
+    const size_t MIN_CHUNK_SIZE = 64; // Smallest buffer requested from an upstream resource
+
+    /**
+     * Resource which forwards to the global operator new and delete
+     */
+    class NewDeleteResource : public MemoryResource
+    {
+      protected:
+        void* doAllocate(size_t bytes, size_t alignment) override {
+          if (alignment > alignof(std::max_align_t)) {
+            throw std::bad_alloc();
+          }
+          return ::operator new(bytes);
+        }
+
+        void doDeallocate(void* ptr, size_t bytes, size_t alignment) override {
+          ::operator delete(ptr);
+        }
+
+        bool doIsEqual(const MemoryResource& other) const noexcept override {
+          return this == &other;
+        }
+    };
+  }
+
+  MemoryResource* newDeleteResource() noexcept {
+    static NewDeleteResource resource;
+    return &resource;
+  }
+
+  //
+  // MonotonicBufferResource
+  //
+  MonotonicBufferResource::MonotonicBufferResource(size_t initial_size, MemoryResource* upstream) :
+    upstream_(upstream), initial_buffer_(nullptr), initial_size_(0),
+    initial_chunk_size_(std::max(initial_size, MIN_CHUNK_SIZE)), next_chunk_size_(initial_chunk_size_), current_(nullptr), space_(0) {
+
+    if (!upstream_) {
+      throw std::invalid_argument("MonotonicBufferResource requires a non null upstream resource");
+    }
+  }
+
+  MonotonicBufferResource::MonotonicBufferResource(void* buffer, size_t size, MemoryResource* upstream) :
+    upstream_(upstream), initial_buffer_(buffer), initial_size_(buffer ? size : 0),
+    initial_chunk_size_(std::max(size * 2, MIN_CHUNK_SIZE)), next_chunk_size_(initial_chunk_size_),
+    current_(static_cast<char*>(initial_buffer_)), space_(initial_size_) {
+
+    if (!upstream_) {
+      throw std::invalid_argument("MonotonicBufferResource requires a non null upstream resource");
+    }
+  }
+
+  MonotonicBufferResource::~MonotonicBufferResource() {
+    release();
+  }
+
+  void MonotonicBufferResource::release() {
+    while (chunks_) {
+      Chunk* next = chunks_->next;
+      upstream_->deallocate(chunks_, chunks_->size, alignof(std::max_align_t));
+      chunks_ = next;
+    }
+
+    current_ = static_cast<char*>(initial_buffer_);
+    space_ = initial_size_;
+    next_chunk_size_ = initial_chunk_size_;
+  }
+
+  MemoryResource* MonotonicBufferResource::upstreamResource() const {
+    return upstream_;
+  }
+
+  void* MonotonicBufferResource::doAllocate(size_t bytes, size_t alignment) {
+    void* ptr = current_;
+    if (ptr && std::align(alignment, bytes, ptr, space_)) {
+      current_ = static_cast<char*>(ptr) + bytes;
+      space_ -= bytes;
+      return ptr;
+    }
+
+    // The active buffer is exhausted so request a new one large enough for this allocation
+    const size_t header_size = (sizeof(Chunk) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+    const size_t required = header_size + bytes + alignment;
+    if (required < bytes) {
+      throw std::bad_alloc(); // Overflow
+    }
+    const size_t chunk_size = std::max(next_chunk_size_, required);
+
+    Chunk* chunk = static_cast<Chunk*>(upstream_->allocate(chunk_size, alignof(std::max_align_t)));
+    chunk->next = chunks_;
+    chunk->size = chunk_size;
+    chunks_ = chunk;
+    next_chunk_size_ = chunk_size * 2;
+
+    current_ = reinterpret_cast<char*>(chunk) + header_size;
+    space_ = chunk_size - header_size;
+
+    ptr = current_;
+    if (!std::align(alignment, bytes, ptr, space_)) {
+      throw std::bad_alloc(); // Unreachable as the chunk was sized for the alignment
+    }
+    current_ = static_cast<char*>(ptr) + bytes;
+    space_ -= bytes;
+    return ptr;
+  }
+
+  void MonotonicBufferResource::doDeallocate(void* ptr, size_t bytes, size_t alignment) {
+    // Memory is only freed by release()
+  }
+
+  bool MonotonicBufferResource::doIsEqual(const MemoryResource& other) const noexcept {
+    return this == &other;
+  }
+}
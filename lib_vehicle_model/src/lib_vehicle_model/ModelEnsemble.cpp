@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <math.h>
+#include <sstream>
+#include <exception>
+#include <algorithm>
+#include "lib_vehicle_model/ModelEnsemble.h"
+#include "lib_vehicle_model/Tracing.h"
+#include "ConstraintChecker.h"
+#include "ModelLoader.h"
+
+/**
+ * Cpp containing the implementation of ModelEnsemble
+ */
+using namespace lib_vehicle_model;
+
+namespace {
+  // Every numeric field of VehicleState so statistics can be computed element-wise
+  double VehicleState::* const STATE_FIELDS[] = {
+    &VehicleState::X_pos_global,
+    &VehicleState::Y_pos_global,
+    &VehicleState::orientation,
+    &VehicleState::longitudinal_vel,
+    &VehicleState::lateral_vel,
+    &VehicleState::yaw_rate,
+    &VehicleState::front_wheel_rotation_rate,
+    &VehicleState::rear_wheel_rotation_rate,
+    &VehicleState::steering_angle,
+    &VehicleState::trailer_angle,
+    &VehicleState::prev_vel_cmd,
+    &VehicleState::prev_steering_cmd
+  };
+
+  // Helper function which fills in the spread statistics of a prediction from its trajectories
+  void computeSpread(EnsemblePrediction& prediction) {
+    size_t steps = prediction.trajectories.front().size();
+    for (const std::vector<VehicleState>& trajectory : prediction.trajectories) {
+      steps = std::min(steps, trajectory.size());
+    }
+
+    const double model_count = static_cast<double>(prediction.trajectories.size());
+    prediction.mean.assign(steps, VehicleState());
+    prediction.std_dev.assign(steps, VehicleState());
+    prediction.max_position_deviation.assign(steps, 0.0);
+
+    for (size_t i = 0; i < steps; i++) {
+      VehicleState& mean = prediction.mean[i];
+      VehicleState& std_dev = prediction.std_dev[i];
+
+      for (double VehicleState::* field : STATE_FIELDS) {
+        double sum = 0;
+        for (const std::vector<VehicleState>& trajectory : prediction.trajectories) {
+          sum += trajectory[i].*field;
+        }
+        mean.*field = sum / model_count;
+
+        double squared_sum = 0;
+        for (const std::vector<VehicleState>& trajectory : prediction.trajectories) {
+          const double diff = trajectory[i].*field - mean.*field;
+          squared_sum += diff * diff;
+        }
+        std_dev.*field = sqrt(squared_sum / model_count);
+      }
+
+      for (const std::vector<VehicleState>& trajectory : prediction.trajectories) {
+        const double dx = trajectory[i].X_pos_global - mean.X_pos_global;
+        const double dy = trajectory[i].Y_pos_global - mean.Y_pos_global;
+        prediction.max_position_deviation[i] = std::max(prediction.max_position_deviation[i], sqrt(dx * dx + dy * dy));
+      }
+    }
+  }
+}
+
+ModelEnsemble::ModelEnsemble(std::shared_ptr<ParameterServer> parameter_server) {
+
+  if (!parameter_server) {
+    throw std::invalid_argument("ModelEnsemble requires a non-null parameter server");
+  }
+
+  std::vector<std::string> model_lib_paths;
+  if (!parameter_server->getParam("ensemble_model_lib_paths", model_lib_paths) || model_lib_paths.empty()) {
+    throw std::invalid_argument("The ensemble param ensemble_model_lib_paths could not be found or read or is empty");
+  }
+
+  constraint_checker_.reset(new ConstraintChecker(parameter_server));
+
+  for (std::string& path : model_lib_paths) {
+    std::unique_ptr<VehicleMotionModel, ModelLoader::destroy_fnc_ptr> loaded = ModelLoader::load(path);
+    loaded->setParameterServer(parameter_server);
+
+    // The model must be destroyed by the library which created it
+    ModelLoader::destroy_fnc_ptr destroy = loaded.get_deleter();
+    models_.push_back(std::shared_ptr<VehicleMotionModel>(loaded.release(), destroy));
+  }
+
+  startWorkers();
+}
+
+ModelEnsemble::ModelEnsemble(std::shared_ptr<ParameterServer> parameter_server, const std::vector<std::shared_ptr<VehicleMotionModel>>& models) :
+  models_(models) {
+
+  if (!parameter_server) {
+    throw std::invalid_argument("ModelEnsemble requires a non-null parameter server");
+  }
+
+  if (models_.empty()) {
+    throw std::invalid_argument("ModelEnsemble requires at least one vehicle model");
+  }
+
+  for (const std::shared_ptr<VehicleMotionModel>& model : models_) {
+    if (!model) {
+      throw std::invalid_argument("ModelEnsemble requires non-null vehicle models");
+    }
+  }
+
+  constraint_checker_.reset(new ConstraintChecker(parameter_server));
+
+  startWorkers();
+}
+
+// Defined here as ConstraintChecker is incomplete in the header
+ModelEnsemble::~ModelEnsemble() {
+  stopWorkers();
+}
+
+void ModelEnsemble::startWorkers() {
+  workers_.reserve(models_.size() - 1);
+  try {
+    for (size_t i = 1; i < models_.size(); i++) {
+      workers_.push_back(std::thread(&ModelEnsemble::workerLoop, this, i));
+    }
+  } catch (...) {
+    // The destructor is not run for a partially constructed ensemble
+    stopWorkers();
+    throw;
+  }
+}
+
+void ModelEnsemble::stopWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(work_mutex_);
+    stopping_ = true;
+  }
+  work_cv_.notify_all();
+
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+}
+
+void ModelEnsemble::workerLoop(size_t model_index) {
+  uint64_t completed_generation = 0;
+  std::unique_lock<std::mutex> lock(work_mutex_);
+  while (true) {
+    work_cv_.wait(lock, [this, completed_generation]() { return stopping_ || task_generation_ != completed_generation; });
+    if (stopping_) {
+      return;
+    }
+
+    completed_generation = task_generation_;
+    const std::function<void(size_t)>* task = task_;
+
+    lock.unlock();
+    (*task)(model_index);
+    lock.lock();
+
+    if (--pending_workers_ == 0) {
+      done_cv_.notify_one();
+    }
+  }
+}
+
+template<typename PredictFunction>
+EnsemblePrediction ModelEnsemble::fanOut(PredictFunction predict) {
+  tracing::ScopedSpan span("ModelEnsemble::fanOut", "lib_vehicle_model");
+
+  EnsemblePrediction prediction;
+  prediction.trajectories.resize(models_.size());
+
+  // Each model records its own error so the trajectories and errors are never shared between threads
+  std::vector<std::exception_ptr> errors(models_.size());
+  const std::function<void(size_t)> task = [this, &predict, &prediction, &errors](size_t model_index) {
+    try {
+      prediction.trajectories[model_index] = predict(*models_[model_index]);
+    } catch (...) {
+      errors[model_index] = std::current_exception();
+    }
+  };
+
+  // The calling thread runs the first model while the workers run the others
+  {
+    std::lock_guard<std::mutex> lock(work_mutex_);
+    task_ = &task;
+    pending_workers_ = workers_.size();
+    task_generation_++;
+  }
+  work_cv_.notify_all();
+
+  task(0);
+
+  // Every model must finish before an exception is reported as the workers reference this call's inputs
+  {
+    std::unique_lock<std::mutex> lock(work_mutex_);
+    done_cv_.wait(lock, [this]() { return pending_workers_ == 0; });
+    task_ = nullptr;
+  }
+
+  for (const std::exception_ptr& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  computeSpread(prediction);
+  return prediction;
+}
+
+EnsemblePrediction ModelEnsemble::predict(const VehicleState& initial_state, double timestep, double delta_t) {
+  tracing::ScopedSpan span("ModelEnsemble::predict", "lib_vehicle_model");
+
+  // Validate inputs once for every model
+  if (timestep > delta_t) {
+    std::ostringstream msg;
+    msg << "Invalid timestep: " << timestep << " is smaller than delta_t : " << delta_t;
+    throw std::invalid_argument(msg.str());
+  }
+
+  constraint_checker_->validateInitialState(initial_state);
+
+  std::lock_guard<std::mutex> guard(predict_mutex_);
+  return fanOut([&](VehicleMotionModel& model) { return model.predict(initial_state, timestep, delta_t); });
+}
+
+EnsemblePrediction ModelEnsemble::predict(const VehicleState& initial_state,
+  const std::vector<VehicleControlInput>& control_inputs, double timestep) {
+  tracing::ScopedSpan span("ModelEnsemble::predict", "lib_vehicle_model");
+
+  // Validate inputs once for every model
+  constraint_checker_->validateInitialState(initial_state);
+  constraint_checker_->validateControlInputs(initial_state, control_inputs, timestep);
+
+  std::lock_guard<std::mutex> guard(predict_mutex_);
+  return fanOut([&](VehicleMotionModel& model) { return model.predict(initial_state, control_inputs, timestep); });
+}
+
+size_t ModelEnsemble::size() const {
+  return models_.size();
+}
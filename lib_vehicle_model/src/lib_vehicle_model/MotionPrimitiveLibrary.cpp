@@ -0,0 +1,411 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <math.h>
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include "lib_vehicle_model/MotionPrimitiveLibrary.h"
+#include "lib_vehicle_model/FrameInvariantPredictor.h"
+#include "lib_vehicle_model/LibVehicleModel.h"
+#include "lib_vehicle_model/Tracing.h"
+
+/**
+ * Cpp containing the implementation of MotionPrimitiveLibrary
+ */
+using namespace lib_vehicle_model;
+
+namespace {
+  const char* const FILE_HEADER = "lib_vehicle_model_motion_primitives";
+  const int FILE_VERSION = 1;
+
+  // Maximum difference in any state field for a stored primitive to match the loaded model
+  const double VERIFY_TOLERANCE = 0.000001;
+
+  // Helper function which builds the canonical initial state of a primitive
+  VehicleState initialState(const MotionPrimitiveGrid& grid, double speed, double steering_angle) {
+    VehicleState state = grid.base_state;
+    state.X_pos_global = 0;
+    state.Y_pos_global = 0;
+    state.orientation = 0;
+    state.longitudinal_vel = speed;
+    state.steering_angle = steering_angle;
+    state.prev_vel_cmd = speed;
+    state.prev_steering_cmd = steering_angle;
+    return state;
+  }
+
+  void writeState(std::ostream& os, const VehicleState& s) {
+    os << s.X_pos_global << " " << s.Y_pos_global << " " << s.orientation << " "
+      << s.longitudinal_vel << " " << s.lateral_vel << " " << s.yaw_rate << " "
+      << s.front_wheel_rotation_rate << " " << s.rear_wheel_rotation_rate << " "
+      << s.steering_angle << " " << s.trailer_angle << " "
+      << s.prev_vel_cmd << " " << s.prev_steering_cmd << "\n";
+  }
+
+  void readState(std::istream& is, VehicleState& s) {
+    is >> s.X_pos_global >> s.Y_pos_global >> s.orientation
+      >> s.longitudinal_vel >> s.lateral_vel >> s.yaw_rate
+      >> s.front_wheel_rotation_rate >> s.rear_wheel_rotation_rate
+      >> s.steering_angle >> s.trailer_angle
+      >> s.prev_vel_cmd >> s.prev_steering_cmd;
+  }
+
+  // Helper function which reads a labelled list of values
+  void readValues(std::istream& is, const std::string& label, std::vector<double>& values) {
+    std::string read_label;
+    size_t count = 0;
+    is >> read_label >> count;
+    if (!is || read_label != label) {
+      throw std::invalid_argument("Motion primitive file is missing the " + label + " section");
+    }
+    values.resize(count);
+    for (size_t i = 0; i < count; i++) {
+      is >> values[i];
+    }
+  }
+
+  bool statesMatch(const VehicleState& a, const VehicleState& b) {
+    return fabs(a.X_pos_global - b.X_pos_global) <= VERIFY_TOLERANCE
+      && fabs(a.Y_pos_global - b.Y_pos_global) <= VERIFY_TOLERANCE
+      && fabs(a.orientation - b.orientation) <= VERIFY_TOLERANCE
+      && fabs(a.longitudinal_vel - b.longitudinal_vel) <= VERIFY_TOLERANCE
+      && fabs(a.lateral_vel - b.lateral_vel) <= VERIFY_TOLERANCE
+      && fabs(a.yaw_rate - b.yaw_rate) <= VERIFY_TOLERANCE
+      && fabs(a.front_wheel_rotation_rate - b.front_wheel_rotation_rate) <= VERIFY_TOLERANCE
+      && fabs(a.rear_wheel_rotation_rate - b.rear_wheel_rotation_rate) <= VERIFY_TOLERANCE
+      && fabs(a.steering_angle - b.steering_angle) <= VERIFY_TOLERANCE
+      && fabs(a.trailer_angle - b.trailer_angle) <= VERIFY_TOLERANCE;
+  }
+}
+
+void MotionPrimitiveLibrary::build(const MotionPrimitiveGrid& grid) {
+  if (grid.initial_speeds.empty() || grid.initial_steering_angles.empty() || grid.control_sequences.empty()) {
+    throw std::invalid_argument("Motion primitive grid must contain at least one initial speed, initial steering angle and control sequence");
+  }
+
+  if (!(grid.timestep > 0)) {
+    std::ostringstream msg;
+    msg << "Invalid motion primitive timestep: " << grid.timestep << " must be greater than 0";
+    throw std::invalid_argument(msg.str());
+  }
+
+  if (!lib_vehicle_model::isFrameInvariant()) {
+    throw std::invalid_argument("Motion primitives require a loaded vehicle model which is frame invariant");
+  }
+
+  // Integrate into a copy so a failed build leaves the library unchanged
+  MotionPrimitiveLibrary built;
+  built.grid_ = grid;
+  built.integrateGrid();
+
+  *this = std::move(built);
+}
+
+void MotionPrimitiveLibrary::integrateGrid() {
+  tracing::ScopedSpan span("MotionPrimitiveLibrary::integrateGrid", "lib_vehicle_model");
+
+  // Record the generation before integrating so a model loaded part way through is detected by the next query
+  const uint64_t generation = getParameterGeneration();
+
+  std::vector<VehicleState> states;
+  std::vector<size_t> offsets;
+  offsets.reserve(grid_.initial_speeds.size() * grid_.initial_steering_angles.size() * grid_.control_sequences.size() + 1);
+
+  for (double speed : grid_.initial_speeds) {
+    for (double steering_angle : grid_.initial_steering_angles) {
+      const VehicleState initial_state = initialState(grid_, speed, steering_angle);
+
+      for (const std::vector<VehicleControlInput>& sequence : grid_.control_sequences) {
+        offsets.push_back(states.size());
+        std::vector<VehicleState> primitive = lib_vehicle_model::predict(initial_state, sequence, grid_.timestep);
+        states.insert(states.end(), primitive.begin(), primitive.end());
+      }
+    }
+  }
+  offsets.push_back(states.size());
+
+  states_ = std::move(states);
+  offsets_ = std::move(offsets);
+  generation_ = generation;
+  built_ = true;
+  verify_pending_ = false;
+}
+
+bool MotionPrimitiveLibrary::primitiveMatchesLoadedModel(size_t speed_index, size_t steering_index, size_t sequence_index) const {
+  const size_t index = primitiveIndex(speed_index, steering_index, sequence_index);
+  const VehicleState initial_state = initialState(grid_, grid_.initial_speeds[speed_index], grid_.initial_steering_angles[steering_index]);
+  std::vector<VehicleState> primitive = lib_vehicle_model::predict(initial_state, grid_.control_sequences[sequence_index], grid_.timestep);
+
+  if (primitive.size() != offsets_[index + 1] - offsets_[index]) {
+    return false;
+  }
+
+  for (size_t i = 0; i < primitive.size(); i++) {
+    if (!statesMatch(primitive[i], states_[offsets_[index] + i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool MotionPrimitiveLibrary::matchesLoadedModel() const {
+  // Primitives starting at rest or driving straight may not depend on every parameter so the extremes of the grid are all checked
+  const size_t speed_indices[] = { 0, grid_.initial_speeds.size() - 1 };
+  const size_t steering_indices[] = { 0, grid_.initial_steering_angles.size() - 1 };
+  const size_t sequence_indices[] = { 0, grid_.control_sequences.size() - 1 };
+
+  for (size_t speed_index : speed_indices) {
+    for (size_t steering_index : steering_indices) {
+      for (size_t sequence_index : sequence_indices) {
+        if (!primitiveMatchesLoadedModel(speed_index, steering_index, sequence_index)) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+void MotionPrimitiveLibrary::ensureCurrent() {
+  if (!built_) {
+    throw std::invalid_argument("Attempted to query a motion primitive library which has not been built or loaded");
+  }
+
+  const uint64_t generation = getParameterGeneration();
+  if (generation == generation_ && !verify_pending_) {
+    return;
+  }
+
+  if (!lib_vehicle_model::isFrameInvariant()) {
+    throw std::invalid_argument("Motion primitives require a loaded vehicle model which is frame invariant");
+  }
+
+  // A library read from a file only needs rebuilding if it was generated with different parameters
+  if (verify_pending_ && matchesLoadedModel()) {
+    generation_ = generation;
+    verify_pending_ = false;
+    return;
+  }
+
+  integrateGrid();
+  rebuild_count_++;
+}
+
+size_t MotionPrimitiveLibrary::primitiveIndex(size_t speed_index, size_t steering_index, size_t sequence_index) const {
+  if (!built_) {
+    throw std::invalid_argument("Attempted to query a motion primitive library which has not been built or loaded");
+  }
+
+  if (speed_index >= grid_.initial_speeds.size() || steering_index >= grid_.initial_steering_angles.size()
+    || sequence_index >= grid_.control_sequences.size()) {
+    std::ostringstream msg;
+    msg << "Invalid motion primitive index: speed " << speed_index << ", steering " << steering_index << ", sequence " << sequence_index;
+    throw std::invalid_argument(msg.str());
+  }
+
+  return (speed_index * grid_.initial_steering_angles.size() + steering_index) * grid_.control_sequences.size() + sequence_index;
+}
+
+size_t MotionPrimitiveLibrary::nearestIndex(const std::vector<double>& values, double target) {
+  size_t nearest = 0;
+  for (size_t i = 1; i < values.size(); i++) {
+    if (fabs(values[i] - target) < fabs(values[nearest] - target)) {
+      nearest = i;
+    }
+  }
+  return nearest;
+}
+
+std::vector<VehicleState> MotionPrimitiveLibrary::query(const VehicleState& initial_state, size_t sequence_index) {
+  if (!built_) {
+    throw std::invalid_argument("Attempted to query a motion primitive library which has not been built or loaded");
+  }
+
+  return query(initial_state, nearestIndex(grid_.initial_speeds, initial_state.longitudinal_vel),
+    nearestIndex(grid_.initial_steering_angles, initial_state.steering_angle), sequence_index);
+}
+
+std::vector<VehicleState> MotionPrimitiveLibrary::query(const VehicleState& pose, size_t speed_index, size_t steering_index, size_t sequence_index) {
+  const size_t index = primitiveIndex(speed_index, steering_index, sequence_index);
+  ensureCurrent();
+
+  std::vector<VehicleState> states(states_.begin() + offsets_[index], states_.begin() + offsets_[index + 1]);
+  SE2Transform::fromState(pose).apply(states.data(), states.size());
+
+  return states;
+}
+
+const VehicleState* MotionPrimitiveLibrary::getCanonicalPrimitive(size_t speed_index, size_t steering_index, size_t sequence_index, size_t& count) const {
+  const size_t index = primitiveIndex(speed_index, steering_index, sequence_index);
+  count = offsets_[index + 1] - offsets_[index];
+  return states_.data() + offsets_[index];
+}
+
+void MotionPrimitiveLibrary::save(const std::string& file_path) const {
+  if (!built_) {
+    throw std::invalid_argument("Attempted to save a motion primitive library which has not been built or loaded");
+  }
+
+  std::ofstream file(file_path.c_str(), std::ios::out | std::ios::trunc);
+  if (!file.is_open()) {
+    throw std::invalid_argument("Failed to open motion primitive file for writing: " + file_path);
+  }
+
+  // Enough digits for every double to be read back exactly
+  file << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+  file << FILE_HEADER << " " << FILE_VERSION << "\n";
+  file << "timestep " << grid_.timestep << "\n";
+  file << "base_state ";
+  writeState(file, grid_.base_state);
+
+  file << "initial_speeds " << grid_.initial_speeds.size();
+  for (double speed : grid_.initial_speeds) {
+    file << " " << speed;
+  }
+  file << "\ninitial_steering_angles " << grid_.initial_steering_angles.size();
+  for (double steering_angle : grid_.initial_steering_angles) {
+    file << " " << steering_angle;
+  }
+
+  file << "\ncontrol_sequences " << grid_.control_sequences.size() << "\n";
+  for (const std::vector<VehicleControlInput>& sequence : grid_.control_sequences) {
+    file << sequence.size();
+    for (const VehicleControlInput& control : sequence) {
+      file << " " << control.target_steering_angle << " " << control.target_velocity;
+    }
+    file << "\n";
+  }
+
+  file << "primitives " << offsets_.size() - 1 << "\n";
+  for (size_t i = 0; i + 1 < offsets_.size(); i++) {
+    file << offsets_[i + 1] - offsets_[i] << "\n";
+    for (size_t j = offsets_[i]; j < offsets_[i + 1]; j++) {
+      writeState(file, states_[j]);
+    }
+  }
+
+  if (!file) {
+    throw std::invalid_argument("Failed to write motion primitive file: " + file_path);
+  }
+}
+
+void MotionPrimitiveLibrary::load(const std::string& file_path) {
+  std::ifstream file(file_path.c_str());
+  if (!file.is_open()) {
+    throw std::invalid_argument("Failed to open motion primitive file for reading: " + file_path);
+  }
+
+  std::string header;
+  int version = 0;
+  file >> header >> version;
+  if (!file || header != FILE_HEADER || version != FILE_VERSION) {
+    throw std::invalid_argument("File is not a supported motion primitive library: " + file_path);
+  }
+
+  MotionPrimitiveLibrary loaded;
+  std::string label;
+
+  file >> label >> loaded.grid_.timestep;
+  if (!file || label != "timestep") {
+    throw std::invalid_argument("Motion primitive file is missing the timestep section");
+  }
+
+  file >> label;
+  if (!file || label != "base_state") {
+    throw std::invalid_argument("Motion primitive file is missing the base_state section");
+  }
+  readState(file, loaded.grid_.base_state);
+
+  readValues(file, "initial_speeds", loaded.grid_.initial_speeds);
+  readValues(file, "initial_steering_angles", loaded.grid_.initial_steering_angles);
+
+  size_t sequence_count = 0;
+  file >> label >> sequence_count;
+  if (!file || label != "control_sequences") {
+    throw std::invalid_argument("Motion primitive file is missing the control_sequences section");
+  }
+  loaded.grid_.control_sequences.resize(sequence_count);
+  for (std::vector<VehicleControlInput>& sequence : loaded.grid_.control_sequences) {
+    size_t length = 0;
+    file >> length;
+    if (!file) {
+      throw std::invalid_argument("Motion primitive file is truncated or malformed: " + file_path);
+    }
+    sequence.resize(length);
+    for (VehicleControlInput& control : sequence) {
+      file >> control.target_steering_angle >> control.target_velocity;
+    }
+  }
+
+  size_t primitive_count = 0;
+  file >> label >> primitive_count;
+  if (!file || label != "primitives") {
+    throw std::invalid_argument("Motion primitive file is missing the primitives section");
+  }
+
+  const size_t expected_count = loaded.grid_.initial_speeds.size() * loaded.grid_.initial_steering_angles.size() * sequence_count;
+  if (primitive_count == 0 || primitive_count != expected_count) {
+    throw std::invalid_argument("Motion primitive file does not contain one primitive per grid combination: " + file_path);
+  }
+
+  for (size_t i = 0; i < primitive_count; i++) {
+    size_t length = 0;
+    file >> length;
+    if (!file) {
+      throw std::invalid_argument("Motion primitive file is truncated or malformed: " + file_path);
+    }
+    loaded.offsets_.push_back(loaded.states_.size());
+    loaded.states_.resize(loaded.states_.size() + length);
+    for (size_t j = loaded.offsets_.back(); j < loaded.states_.size(); j++) {
+      readState(file, loaded.states_[j]);
+    }
+  }
+  loaded.offsets_.push_back(loaded.states_.size());
+
+  if (!file) {
+    throw std::invalid_argument("Motion primitive file is truncated or malformed: " + file_path);
+  }
+
+  loaded.built_ = true;
+  loaded.verify_pending_ = true;
+
+  // Compare with the loaded model now if there is one. Otherwise this happens on the first query
+  // This library is only replaced once the loaded one has been verified or rebuilt
+  try {
+    loaded.ensureCurrent();
+  } catch (const ModelAccessException&) {}
+
+  *this = std::move(loaded);
+}
+
+bool MotionPrimitiveLibrary::isBuilt() const {
+  return built_;
+}
+
+bool MotionPrimitiveLibrary::isStale() const {
+  return built_ && (verify_pending_ || generation_ != getParameterGeneration());
+}
+
+const MotionPrimitiveGrid& MotionPrimitiveLibrary::getGrid() const {
+  return grid_;
+}
+
+uint64_t MotionPrimitiveLibrary::getRebuildCount() const {
+  return rebuild_count_;
+}
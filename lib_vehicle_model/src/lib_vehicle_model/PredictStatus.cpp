@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include "lib_vehicle_model/PredictStatus.h"
+
+namespace lib_vehicle_model {
+
+  /**
+   * Overload of << operation so enum objects will output as strings in print functions
+   * 
+   */ 
+  std::ostream& operator<<( std::ostream& os, const PredictStatus& status )
+  {
+    switch( status )
+    {
+        case PredictStatus::SUCCESS: os << "SUCCESS"; break;
+        case PredictStatus::MODEL_NOT_LOADED: os << "MODEL_NOT_LOADED"; break;
+        case PredictStatus::REAL_TIME_DISABLED: os << "REAL_TIME_DISABLED"; break;
+        case PredictStatus::THREAD_NOT_PREPARED: os << "THREAD_NOT_PREPARED"; break;
+        case PredictStatus::HORIZON_TOO_LONG: os << "HORIZON_TOO_LONG"; break;
+        case PredictStatus::INVALID_INPUT: os << "INVALID_INPUT"; break;
+        case PredictStatus::MODEL_FAILURE: os << "MODEL_FAILURE"; break;
+        default: os << "ERROR: UNKNOWN TYPE"; break;
+    }
+
+    return os;
+  }
+}
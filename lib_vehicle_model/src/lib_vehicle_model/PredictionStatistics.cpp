@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include "lib_vehicle_model/PredictionStatistics.h"
+
+/**
+ * Cpp containing the implementation of PredictionStatistics
+ */
+namespace lib_vehicle_model {
+
+  const size_t PredictionStatistics::HORIZON_BUCKET_COUNT;
+  const size_t PredictionStatistics::LATENCY_BUCKET_COUNT;
+  const size_t PredictionStatistics::CALL_TYPE_COUNT;
+
+  std::ostream& operator<<( std::ostream& os, const PredictCallType& type ) {
+    switch(type) {
+      case PredictCallType::PREDICT_NO_CONTROL:
+        os << "PREDICT_NO_CONTROL";
+        break;
+      case PredictCallType::PREDICT_WITH_CONTROL:
+        os << "PREDICT_WITH_CONTROL";
+        break;
+      case PredictCallType::PREDICT_NO_CONTROL_STRIDE:
+        os << "PREDICT_NO_CONTROL_STRIDE";
+        break;
+      case PredictCallType::PREDICT_WITH_CONTROL_STRIDE:
+        os << "PREDICT_WITH_CONTROL_STRIDE";
+        break;
+      case PredictCallType::PREDICT_REDUCED_NO_CONTROL:
+        os << "PREDICT_REDUCED_NO_CONTROL";
+        break;
+      case PredictCallType::PREDICT_REDUCED_WITH_CONTROL:
+        os << "PREDICT_REDUCED_WITH_CONTROL";
+        break;
+      case PredictCallType::PREDICT_STEP:
+        os << "PREDICT_STEP";
+        break;
+      case PredictCallType::PREDICT_LAZY:
+        os << "PREDICT_LAZY";
+        break;
+      case PredictCallType::PREDICT_REAL_TIME:
+        os << "PREDICT_REAL_TIME";
+        break;
+      case PredictCallType::PREDICT_NO_CONTROL_RESOURCE:
+        os << "PREDICT_NO_CONTROL_RESOURCE";
+        break;
+      case PredictCallType::PREDICT_WITH_CONTROL_RESOURCE:
+        os << "PREDICT_WITH_CONTROL_RESOURCE";
+        break;
+      case PredictCallType::PREDICT_CONTROL_CHANGES:
+        os << "PREDICT_CONTROL_CHANGES";
+        break;
+      case PredictCallType::PREDICT_VALIDATED_CONTROLS:
+        os << "PREDICT_VALIDATED_CONTROLS";
+        break;
+      case PredictCallType::PREDICT_CONTROL_CHANGES_STRIDE:
+        os << "PREDICT_CONTROL_CHANGES_STRIDE";
+        break;
+      default:
+        os << "UNKNOWN";
+    }
+    return os;
+  }
+
+  uint64_t PredictionStatistics::totalCalls() const {
+    uint64_t total = 0;
+    for (size_t i = 0; i < CALL_TYPE_COUNT; i++) {
+      total += call_counts[i];
+    }
+    return total;
+  }
+
+  uint64_t PredictionStatistics::callCount(PredictCallType type) const {
+    const size_t index = static_cast<size_t>(type);
+    return index < CALL_TYPE_COUNT ? call_counts[index] : 0;
+  }
+
+  size_t PredictionStatistics::horizonBucket(uint64_t steps) {
+    // Index of the highest set bit
+    size_t bucket = 0;
+    while (steps > 1 && bucket < HORIZON_BUCKET_COUNT - 1) {
+      steps >>= 1;
+      bucket++;
+    }
+    return bucket;
+  }
+
+  size_t PredictionStatistics::latencyBucket(uint64_t nanoseconds) {
+    // Number of significant bits in the duration in microseconds
+    uint64_t microseconds = nanoseconds / 1000;
+    size_t bucket = 0;
+    while (microseconds > 0 && bucket < LATENCY_BUCKET_COUNT - 1) {
+      microseconds >>= 1;
+      bucket++;
+    }
+    return bucket;
+  }
+
+  std::ostream& operator<<( std::ostream& os, const PredictionStatistics& stats ) {
+    os << "PredictionStatistics [ total_calls: " << stats.totalCalls() <<
+      ", validation_failures: " << stats.validation_failures <<
+      ", in_flight: " << stats.in_flight;
+
+    for (size_t i = 0; i < PredictionStatistics::CALL_TYPE_COUNT; i++) {
+      if (stats.call_counts[i] > 0) {
+        os << ", " << static_cast<PredictCallType>(i) << ": " << stats.call_counts[i];
+      }
+    }
+
+    for (size_t h = 0; h < PredictionStatistics::HORIZON_BUCKET_COUNT; h++) {
+      for (size_t l = 0; l < PredictionStatistics::LATENCY_BUCKET_COUNT; l++) {
+        if (stats.latency_histogram[h][l] > 0) {
+          os << ", horizon_bucket " << h << " latency_bucket " << l << ": " << stats.latency_histogram[h][l];
+        }
+      }
+    }
+
+    os << " ]";
+    return os;
+  }
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <math.h>
+#include "lib_vehicle_model/RecedingHorizonPredictor.h"
+
+/**
+ * Cpp containing the implementation of RecedingHorizonPredictor
+ */
+using namespace lib_vehicle_model;
+
+namespace {
+  // Helper function to check if two control inputs are identical
+  bool controlsMatch(const VehicleControlInput& a, const VehicleControlInput& b) {
+    return a.target_steering_angle == b.target_steering_angle
+      && a.target_velocity == b.target_velocity;
+  }
+}
+
+RecedingHorizonPredictor::RecedingHorizonPredictor(std::shared_ptr<VehicleMotionModel> model, double state_tolerance) :
+  model_(model), state_tolerance_(state_tolerance) {
+
+  if (!model_) {
+    throw std::invalid_argument("RecedingHorizonPredictor requires a non-null vehicle model");
+  }
+
+  if (state_tolerance_ < 0) {
+    throw std::invalid_argument("RecedingHorizonPredictor state_tolerance cannot be negative");
+  }
+}
+
+bool RecedingHorizonPredictor::isWithinTolerance(const VehicleState& a, const VehicleState& b) const {
+  return fabs(a.X_pos_global - b.X_pos_global) <= state_tolerance_
+    && fabs(a.Y_pos_global - b.Y_pos_global) <= state_tolerance_
+    && fabs(a.orientation - b.orientation) <= state_tolerance_
+    && fabs(a.longitudinal_vel - b.longitudinal_vel) <= state_tolerance_
+    && fabs(a.lateral_vel - b.lateral_vel) <= state_tolerance_
+    && fabs(a.yaw_rate - b.yaw_rate) <= state_tolerance_
+    && fabs(a.front_wheel_rotation_rate - b.front_wheel_rotation_rate) <= state_tolerance_
+    && fabs(a.rear_wheel_rotation_rate - b.rear_wheel_rotation_rate) <= state_tolerance_
+    && fabs(a.steering_angle - b.steering_angle) <= state_tolerance_
+    && fabs(a.trailer_angle - b.trailer_angle) <= state_tolerance_;
+}
+
+std::vector<VehicleState> RecedingHorizonPredictor::predict(const VehicleState& initial_state,
+  const std::vector<VehicleControlInput>& control_inputs, double timestep) {
+
+  // Find the number of leading states which can be taken from the stored trajectory
+  // trajectory_[i] is the result of applying control_inputs_[i] so a match at index k
+  // means trajectory_[k+1+j] is the result of applying control_inputs_[k+1+j] to the new initial state
+  size_t match_index = 0;
+  size_t reusable = 0;
+
+  if (timestep == timestep_) {
+    for (size_t k = 0; k + 1 < trajectory_.size(); k++) {
+      if (!isWithinTolerance(initial_state, trajectory_[k])) {
+        continue;
+      }
+
+      size_t count = 0;
+      while (count < control_inputs.size() && k + 1 + count < trajectory_.size()
+        && controlsMatch(control_inputs[count], control_inputs_[k + 1 + count])) {
+        count++;
+      }
+
+      match_index = k;
+      reusable = count;
+      break;
+    }
+  }
+
+  std::vector<VehicleState> result;
+
+  if (reusable == 0) {
+    result = model_->predict(initial_state, control_inputs, timestep);
+  } else {
+    result.reserve(control_inputs.size());
+    result.insert(result.end(), trajectory_.begin() + match_index + 1, trajectory_.begin() + match_index + 1 + reusable);
+
+    // Integrate the remaining tail starting from the last reused state
+    if (reusable < control_inputs.size()) {
+      std::vector<VehicleControlInput> tail_controls(control_inputs.begin() + reusable, control_inputs.end());
+      std::vector<VehicleState> tail = model_->predict(result.back(), tail_controls, timestep);
+      result.insert(result.end(), tail.begin(), tail.end());
+    }
+  }
+
+  // Store this prediction for the next cycle
+  timestep_ = timestep;
+  control_inputs_ = control_inputs;
+  trajectory_ = result;
+  reused_steps_ = reusable;
+
+  return result;
+}
+
+void RecedingHorizonPredictor::reset() {
+  timestep_ = 0.0;
+  control_inputs_.clear();
+  trajectory_.clear();
+  reused_steps_ = 0;
+}
+
+size_t RecedingHorizonPredictor::getReusedStepCount() const {
+  return reused_steps_;
+}
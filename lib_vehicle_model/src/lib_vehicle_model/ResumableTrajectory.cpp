@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include "lib_vehicle_model/ResumableTrajectory.h"
+
+/**
+ * Cpp containing the implementation of ResumableTrajectory
+ */
+using namespace lib_vehicle_model;
+
+ResumableTrajectory::ResumableTrajectory(std::shared_ptr<VehicleMotionModel> model, const VehicleState& initial_state, double timestep) :
+  model_(model), initial_state_(initial_state), timestep_(timestep) {
+
+  if (!model_) {
+    throw std::invalid_argument("ResumableTrajectory requires a non-null vehicle model");
+  }
+
+  if (timestep_ <= 0) {
+    throw std::invalid_argument("ResumableTrajectory timestep must be positive");
+  }
+}
+
+std::vector<VehicleState> ResumableTrajectory::append(const std::vector<VehicleControlInput>& control_inputs) {
+  if (control_inputs.empty()) {
+    return std::vector<VehicleState>();
+  }
+
+  // Only the new segment is integrated
+  std::vector<VehicleState> segment = model_->predict(getFinalState(), control_inputs, timestep_);
+
+  control_inputs_.insert(control_inputs_.end(), control_inputs.begin(), control_inputs.end());
+  states_.insert(states_.end(), segment.begin(), segment.end());
+
+  return segment;
+}
+
+const std::vector<VehicleState>& ResumableTrajectory::getStates() const {
+  return states_;
+}
+
+const std::vector<VehicleControlInput>& ResumableTrajectory::getControlInputs() const {
+  return control_inputs_;
+}
+
+const VehicleState& ResumableTrajectory::getFinalState() const {
+  return states_.empty() ? initial_state_ : states_.back();
+}
+
+double ResumableTrajectory::getElapsedTime() const {
+  return states_.size() * timestep_;
+}
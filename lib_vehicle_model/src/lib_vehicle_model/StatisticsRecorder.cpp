@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "StatisticsRecorder.h"
+
+/**
+ * Cpp containing the implementation of StatisticsRecorder and ScopedPredictRecord
+ */
+namespace lib_vehicle_model {
+
+  //
+  // Private Namespace
+  //
+  namespace {
+
+    /**
+     * Counters written by a single thread
+     * Writers use relaxed load/store pairs instead of read-modify-write operations as each block only has one writer.
+     * Readers may therefore see a slightly stale value but never a torn one.
+     */
+    struct ThreadBlock {
+      std::atomic<uint64_t> latency_histogram[PredictionStatistics::HORIZON_BUCKET_COUNT][PredictionStatistics::LATENCY_BUCKET_COUNT];
+      std::atomic<uint64_t> call_counts[PredictionStatistics::CALL_TYPE_COUNT];
+      std::atomic<uint64_t> validation_failures;
+      std::atomic<int64_t> in_flight;
+      std::atomic<bool> in_use;
+
+      ThreadBlock() : validation_failures(0), in_flight(0), in_use(true) {
+        for (size_t h = 0; h < PredictionStatistics::HORIZON_BUCKET_COUNT; h++) {
+          for (size_t l = 0; l < PredictionStatistics::LATENCY_BUCKET_COUNT; l++) {
+            latency_histogram[h][l].store(0, std::memory_order_relaxed);
+          }
+        }
+        for (size_t i = 0; i < PredictionStatistics::CALL_TYPE_COUNT; i++) {
+          call_counts[i].store(0, std::memory_order_relaxed);
+        }
+      }
+    };
+
+    template<typename T>
+    inline void singleWriterAdd(std::atomic<T>& counter, T value) {
+      counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    std::mutex registry_mutex_; // Guards registry_ and baseline_
+    std::vector<std::unique_ptr<ThreadBlock>> registry_;
+    PredictionStatistics baseline_; // Totals at the time of the last reset
+
+    /**
+     * Releases the current thread's block for reuse when the thread exits
+     */
+    struct ThreadBlockHandle {
+      ThreadBlock* block = nullptr;
+
+      ~ThreadBlockHandle() {
+        if (block) {
+          block->in_use.store(false);
+        }
+      }
+    };
+    thread_local ThreadBlockHandle thread_block_;
+
+    ThreadBlock& threadBlock() {
+      if (thread_block_.block) {
+        return *thread_block_.block;
+      }
+
+      std::lock_guard<std::mutex> guard(registry_mutex_);
+      for (std::unique_ptr<ThreadBlock>& block : registry_) {
+        bool expected = false;
+        if (block->in_use.compare_exchange_strong(expected, true)) {
+          thread_block_.block = block.get();
+          return *thread_block_.block;
+        }
+      }
+
+      registry_.push_back(std::unique_ptr<ThreadBlock>(new ThreadBlock()));
+      thread_block_.block = registry_.back().get();
+      return *thread_block_.block;
+    }
+
+    /**
+     * Sums the counters of all blocks. The registry mutex must be held by the caller
+     */
+    PredictionStatistics sumBlocks() {
+      PredictionStatistics totals;
+      for (const std::unique_ptr<ThreadBlock>& block : registry_) {
+        for (size_t h = 0; h < PredictionStatistics::HORIZON_BUCKET_COUNT; h++) {
+          for (size_t l = 0; l < PredictionStatistics::LATENCY_BUCKET_COUNT; l++) {
+            totals.latency_histogram[h][l] += block->latency_histogram[h][l].load(std::memory_order_relaxed);
+          }
+        }
+        for (size_t i = 0; i < PredictionStatistics::CALL_TYPE_COUNT; i++) {
+          totals.call_counts[i] += block->call_counts[i].load(std::memory_order_relaxed);
+        }
+        totals.validation_failures += block->validation_failures.load(std::memory_order_relaxed);
+        totals.in_flight += block->in_flight.load(std::memory_order_relaxed);
+      }
+      return totals;
+    }
+  }
+
+  //
+  // StatisticsRecorder
+  //
+  void StatisticsRecorder::registerThread() {
+    threadBlock();
+  }
+
+  void StatisticsRecorder::beginCall(PredictCallType type) {
+    ThreadBlock& block = threadBlock();
+    singleWriterAdd<uint64_t>(block.call_counts[static_cast<size_t>(type)], 1);
+    singleWriterAdd<int64_t>(block.in_flight, 1);
+  }
+
+  void StatisticsRecorder::endValidatedCall(uint64_t horizon_steps, uint64_t nanoseconds) {
+    ThreadBlock& block = threadBlock();
+    singleWriterAdd<uint64_t>(block.latency_histogram[PredictionStatistics::horizonBucket(horizon_steps)][PredictionStatistics::latencyBucket(nanoseconds)], 1);
+    singleWriterAdd<int64_t>(block.in_flight, -1);
+  }
+
+  void StatisticsRecorder::endRejectedCall() {
+    ThreadBlock& block = threadBlock();
+    singleWriterAdd<uint64_t>(block.validation_failures, 1);
+    singleWriterAdd<int64_t>(block.in_flight, -1);
+  }
+
+  PredictionStatistics StatisticsRecorder::snapshot() {
+    std::lock_guard<std::mutex> guard(registry_mutex_);
+    PredictionStatistics stats = sumBlocks();
+
+    // Remove everything recorded before the last reset
+    for (size_t h = 0; h < PredictionStatistics::HORIZON_BUCKET_COUNT; h++) {
+      for (size_t l = 0; l < PredictionStatistics::LATENCY_BUCKET_COUNT; l++) {
+        stats.latency_histogram[h][l] -= baseline_.latency_histogram[h][l];
+      }
+    }
+    for (size_t i = 0; i < PredictionStatistics::CALL_TYPE_COUNT; i++) {
+      stats.call_counts[i] -= baseline_.call_counts[i];
+    }
+    stats.validation_failures -= baseline_.validation_failures;
+
+    return stats;
+  }
+
+  void StatisticsRecorder::reset() {
+    // Counters are never written by other threads so a reset is recorded as a new baseline
+    std::lock_guard<std::mutex> guard(registry_mutex_);
+    baseline_ = sumBlocks();
+  }
+
+  //
+  // ScopedPredictRecord
+  //
+  ScopedPredictRecord::ScopedPredictRecord(PredictCallType type, uint64_t horizon_steps) :
+    start_(std::chrono::steady_clock::now()), horizon_steps_(horizon_steps) {
+
+    StatisticsRecorder::beginCall(type);
+  }
+
+  ScopedPredictRecord::~ScopedPredictRecord() {
+    if (validated_) {
+      const std::chrono::nanoseconds duration = std::chrono::steady_clock::now() - start_;
+      StatisticsRecorder::endValidatedCall(horizon_steps_, duration.count());
+    } else {
+      // Leaving a prediction function before validation completes means its inputs were rejected
+      StatisticsRecorder::endRejectedCall();
+    }
+  }
+
+  void ScopedPredictRecord::validated() {
+    validated_ = true;
+  }
+}
@@ -0,0 +1,94 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include "lib_vehicle_model/PredictionStatistics.h"
+
+namespace lib_vehicle_model {
+  /**
+   * @class StatisticsRecorder
+   * @brief Records the usage statistics of the lib_vehicle_model prediction functions
+   *
+   * Each thread writes to its own block of counters so recording never takes a lock or contends with other threads.
+   * Only a thread's first recording and calls to snapshot() or reset() take the registry lock.
+   * Blocks of exited threads are reused by new threads and their counts are kept.
+   */
+  class StatisticsRecorder
+  {
+    public:
+      /**
+       * @brief Assigns a block of counters to the calling thread if it does not already have one
+       */
+      static void registerThread();
+
+      /**
+       * @brief Records the start of a call to a prediction function
+       */
+      static void beginCall(PredictCallType type);
+
+      /**
+       * @brief Records the end of a call which passed validation
+       *
+       * @param horizon_steps The number of steps in the requested prediction
+       * @param nanoseconds The duration of the call
+       */
+      static void endValidatedCall(uint64_t horizon_steps, uint64_t nanoseconds);
+
+      /**
+       * @brief Records the end of a call which failed validation
+       */
+      static void endRejectedCall();
+
+      /**
+       * @brief Returns the statistics recorded by all threads since the last reset
+       */
+      static PredictionStatistics snapshot();
+
+      /**
+       * @brief Clears all recorded statistics except the in flight count
+       */
+      static void reset();
+  };
+
+  /**
+   * @class ScopedPredictRecord
+   * @brief RAII helper which records a single prediction call with the StatisticsRecorder
+   *
+   * The call is treated as a validation failure unless validated() is called before the record is destroyed.
+   */
+  class ScopedPredictRecord
+  {
+    private:
+      std::chrono::steady_clock::time_point start_;
+      uint64_t horizon_steps_;
+      bool validated_ = false;
+
+    public:
+      ScopedPredictRecord(PredictCallType type, uint64_t horizon_steps);
+
+      ~ScopedPredictRecord();
+
+      /**
+       * @brief Marks the call as having passed input validation
+       */
+      void validated();
+
+      ScopedPredictRecord(const ScopedPredictRecord&) = delete;
+      ScopedPredictRecord& operator=(const ScopedPredictRecord&) = delete;
+  };
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <fstream>
+#include <iomanip>
+#include <unistd.h>
+#include "lib_vehicle_model/Tracing.h"
+
+/**
+ * Cpp containing the implementation of the lib_vehicle_model::tracing namespace
+ */
+namespace lib_vehicle_model {
+  namespace tracing {
+
+    //
+    // Private Namespace
+    //
+    namespace {
+
+      /**
+       * A single ring buffer entry
+       * Each field is atomic and guarded by a sequence number so a reader never uses a partially written span.
+       * The sequence is 0 while the slot is being written and otherwise holds the write index + 1.
+       */
+      struct Slot {
+        std::atomic<uint64_t> sequence;
+        std::atomic<const char*> name;
+        std::atomic<const char*> category;
+        std::atomic<uint64_t> start_ns;
+        std::atomic<uint64_t> duration_ns;
+        std::atomic<uint32_t> thread_id;
+
+        Slot() : sequence(0), name(nullptr), category(nullptr), start_ns(0), duration_ns(0), thread_id(0) {}
+      };
+
+      struct RingBuffer {
+        const size_t capacity;
+        std::unique_ptr<Slot[]> slots;
+        std::atomic<uint64_t> head; // Index of the next span to write
+
+        explicit RingBuffer(size_t size) : capacity(size), slots(new Slot[size]), head(0) {}
+      };
+
+      std::mutex config_mutex_; // Guards buffers_
+      std::vector<std::unique_ptr<RingBuffer>> buffers_; // All allocated buffers. The last one is active
+      std::atomic<RingBuffer*> active_buffer_(nullptr);
+      std::atomic<bool> enabled_(false);
+      std::atomic<uint32_t> next_thread_id_(1);
+      const std::chrono::steady_clock::time_point origin_ = std::chrono::steady_clock::now();
+
+      uint64_t nowNanoseconds() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin_).count();
+      }
+
+      /**
+       * Returns a small sequential id for the calling thread which is easier to read in trace viewers than std::thread::id
+       */
+      uint32_t threadId() {
+        thread_local uint32_t id = next_thread_id_.fetch_add(1);
+        return id;
+      }
+
+      void record(const char* name, const char* category, uint64_t start_ns, uint64_t duration_ns) {
+        RingBuffer* buffer = active_buffer_.load(std::memory_order_acquire);
+        if (!buffer) {
+          return;
+        }
+
+        const uint64_t index = buffer->head.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = buffer->slots[index % buffer->capacity];
+
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.category.store(category, std::memory_order_relaxed);
+        slot.start_ns.store(start_ns, std::memory_order_relaxed);
+        slot.duration_ns.store(duration_ns, std::memory_order_relaxed);
+        slot.thread_id.store(threadId(), std::memory_order_relaxed);
+        slot.sequence.store(index + 1, std::memory_order_release);
+      }
+
+      void writeEscaped(std::ostream& os, const char* str) {
+        for (const char* c = str; c && *c; c++) {
+          if (*c == '"' || *c == '\\') {
+            os << '\\';
+          }
+          os << *c;
+        }
+      }
+    }
+
+    //
+    // Public Namespace
+    //
+    void enable(size_t capacity) {
+      if (capacity == 0) {
+        throw std::invalid_argument("Trace buffer capacity must be greater than 0");
+      }
+
+      std::lock_guard<std::mutex> guard(config_mutex_);
+      RingBuffer* buffer = active_buffer_.load();
+      if (!buffer || buffer->capacity != capacity) {
+        buffers_.push_back(std::unique_ptr<RingBuffer>(new RingBuffer(capacity)));
+        active_buffer_.store(buffers_.back().get(), std::memory_order_release);
+      }
+
+      enabled_.store(true, std::memory_order_release);
+    }
+
+    void disable() {
+      enabled_.store(false, std::memory_order_release);
+    }
+
+    bool isEnabled() {
+      return enabled_.load(std::memory_order_acquire);
+    }
+
+    void clear() {
+      std::lock_guard<std::mutex> guard(config_mutex_);
+      RingBuffer* buffer = active_buffer_.load();
+      if (!buffer) {
+        return;
+      }
+
+      for (size_t i = 0; i < buffer->capacity; i++) {
+        buffer->slots[i].sequence.store(0, std::memory_order_relaxed);
+      }
+      buffer->head.store(0, std::memory_order_release);
+    }
+
+    size_t writeChromeTrace(std::ostream& os) {
+      RingBuffer* buffer = active_buffer_.load(std::memory_order_acquire);
+      const int pid = getpid();
+
+      os << "{\"traceEvents\":[";
+
+      size_t written = 0;
+      if (buffer) {
+        // Only the most recent capacity spans are still in the buffer
+        const uint64_t head = buffer->head.load(std::memory_order_acquire);
+        const uint64_t first = head > buffer->capacity ? head - buffer->capacity : 0;
+
+        for (uint64_t index = first; index < head; index++) {
+          const Slot& slot = buffer->slots[index % buffer->capacity];
+
+          const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+          if (sequence != index + 1) {
+            continue; // Still being written or already overwritten
+          }
+          const char* name = slot.name.load(std::memory_order_relaxed);
+          const char* category = slot.category.load(std::memory_order_relaxed);
+          const uint64_t start_ns = slot.start_ns.load(std::memory_order_relaxed);
+          const uint64_t duration_ns = slot.duration_ns.load(std::memory_order_relaxed);
+          const uint32_t thread_id = slot.thread_id.load(std::memory_order_relaxed);
+          std::atomic_thread_fence(std::memory_order_acquire);
+          if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+            continue; // Overwritten while reading
+          }
+
+          if (written > 0) {
+            os << ",";
+          }
+          // Complete events (ph X) with timestamps in microseconds
+          os << "\n{\"name\":\"";
+          writeEscaped(os, name);
+          os << "\",\"cat\":\"";
+          writeEscaped(os, category);
+          os << "\",\"ph\":\"X\",\"ts\":" << std::fixed << std::setprecision(3) << start_ns / 1000.0
+            << ",\"dur\":" << duration_ns / 1000.0
+            << ",\"pid\":" << pid << ",\"tid\":" << thread_id << "}";
+          written++;
+        }
+      }
+
+      os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+      return written;
+    }
+
+    size_t flush(const std::string& file_path) {
+      std::ofstream file(file_path.c_str(), std::ios::out | std::ios::trunc);
+      if (!file.is_open()) {
+        throw std::invalid_argument("Failed to open trace file for writing: " + file_path);
+      }
+
+      return writeChromeTrace(file);
+    }
+
+    //
+    // ScopedSpan
+    //
+    ScopedSpan::ScopedSpan(const char* name, const char* category) :
+      name_(name), category_(category), start_ns_(0), active_(enabled_.load(std::memory_order_relaxed)) {
+
+      if (active_) {
+        start_ns_ = nowNanoseconds();
+      }
+    }
+
+    ScopedSpan::~ScopedSpan() {
+      if (active_) {
+        record(name_, category_, start_ns_, nowNanoseconds() - start_ns_);
+      }
+    }
+  }
+}
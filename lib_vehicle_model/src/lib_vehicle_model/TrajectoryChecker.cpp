@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <algorithm>
+#include "lib_vehicle_model/TrajectoryChecker.h"
+#include "lib_vehicle_model/Tracing.h"
+
+/**
+ * Cpp containing the implementation of TrajectoryChecker
+ */
+using namespace lib_vehicle_model;
+
+namespace lib_vehicle_model {
+
+  /**
+   * Overload of << operation so masks will output as | separated flag names in print functions
+   * 
+   */ 
+  std::ostream& operator<<( std::ostream& os, const TrajectoryViolation& violation )
+  {
+    if (violation == TrajectoryViolation::NONE) {
+      os << "NONE";
+      return os;
+    }
+
+    static const TrajectoryViolation flags[] = {
+      TrajectoryViolation::SPEED_BELOW_MIN, TrajectoryViolation::SPEED_ABOVE_MAX,
+      TrajectoryViolation::TRAILER_ANGLE_BELOW_MIN, TrajectoryViolation::TRAILER_ANGLE_ABOVE_MAX,
+      TrajectoryViolation::LATERAL_ACCELERATION_ABOVE_MAX, TrajectoryViolation::YAW_RATE_ABOVE_MAX
+    };
+    static const char* names[] = {
+      "SPEED_BELOW_MIN", "SPEED_ABOVE_MAX", "TRAILER_ANGLE_BELOW_MIN", "TRAILER_ANGLE_ABOVE_MAX",
+      "LATERAL_ACCELERATION_ABOVE_MAX", "YAW_RATE_ABOVE_MAX"
+    };
+
+    bool first = true;
+    TrajectoryViolation remaining = violation;
+    for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); i++) {
+      if (hasViolation(violation, flags[i])) {
+        os << (first ? "" : "|") << names[i];
+        first = false;
+        remaining = static_cast<TrajectoryViolation>(static_cast<uint8_t>(remaining) & ~static_cast<uint8_t>(flags[i]));
+      }
+    }
+
+    if (remaining != TrajectoryViolation::NONE) {
+      os << (first ? "" : "|") << "ERROR: UNKNOWN TYPE";
+    }
+
+    return os;
+  }
+}
+
+const size_t TrajectoryChecker::BLOCK_SIZE;
+
+TrajectoryChecker::TrajectoryChecker(std::shared_ptr<ParameterServer> parameter_server) {
+
+  // Load Parameters
+  bool maxSpeedParam = parameter_server->getParam("max_forward_speed", max_forward_speed_);
+  bool minSpeedParam = parameter_server->getParam("min_forward_speed", min_forward_speed_);
+  bool maxTrailerAngleParam = parameter_server->getParam("max_trailer_angle", max_trailer_angle_);
+  bool minTrailerAngleParam = parameter_server->getParam("min_trailer_angle", min_trailer_angle_);
+
+  // Check if all the required parameters could be loaded
+  if (!(maxSpeedParam && minSpeedParam && maxTrailerAngleParam && minTrailerAngleParam)) {
+
+    std::ostringstream msg;
+    msg << "One of the required parameters could not be found or read " 
+      << " max_forward_speed: " << maxSpeedParam 
+      << " min_forward_speed: " << minSpeedParam 
+      << " max_trailer_angle: " << maxTrailerAngleParam 
+      << " min_trailer_angle: " << minTrailerAngleParam;
+
+    throw std::invalid_argument(msg.str());
+  }
+
+  // Optional limits are disabled by an infinite bound so every state is still checked without branches
+  if (!parameter_server->getParam("max_lateral_acceleration", max_lateral_acceleration_)) {
+    max_lateral_acceleration_ = std::numeric_limits<double>::infinity();
+  }
+
+  if (!parameter_server->getParam("max_yaw_rate", max_yaw_rate_)) {
+    max_yaw_rate_ = std::numeric_limits<double>::infinity();
+  }
+}
+
+TrajectoryViolation TrajectoryChecker::checkState(const VehicleState& state) const noexcept {
+  const double lateral_accel = std::fabs(state.longitudinal_vel * state.yaw_rate);
+
+  return static_cast<TrajectoryViolation>(
+    (state.longitudinal_vel < min_forward_speed_) << 0
+    | (state.longitudinal_vel > max_forward_speed_) << 1
+    | (state.trailer_angle < min_trailer_angle_) << 2
+    | (state.trailer_angle > max_trailer_angle_) << 3
+    | (lateral_accel > max_lateral_acceleration_) << 4
+    | (std::fabs(state.yaw_rate) > max_yaw_rate_) << 5);
+}
+
+TrajectoryViolation TrajectoryChecker::checkTrajectory(const VehicleState* states, size_t count, size_t* first_violation) const noexcept {
+
+  for (size_t block_start = 0; block_start < count; block_start += BLOCK_SIZE) {
+    const size_t block_end = std::min(block_start + BLOCK_SIZE, count);
+
+    // Evaluate the whole block before checking for a violation
+    unsigned int block_violations = 0;
+    for (size_t i = block_start; i < block_end; i++) {
+      block_violations |= static_cast<unsigned int>(checkState(states[i]));
+    }
+
+    if (block_violations != 0) {
+      for (size_t i = block_start; i < block_end; i++) {
+        const TrajectoryViolation violation = checkState(states[i]);
+        if (violation != TrajectoryViolation::NONE) {
+          if (first_violation) {
+            *first_violation = i;
+          }
+          return violation;
+        }
+      }
+    }
+  }
+
+  if (first_violation) {
+    *first_violation = count;
+  }
+  return TrajectoryViolation::NONE;
+}
+
+TrajectoryViolation TrajectoryChecker::checkTrajectory(const std::vector<VehicleState>& states) const noexcept {
+  return checkTrajectory(states.data(), states.size());
+}
+
+size_t TrajectoryChecker::checkTrajectories(const VehicleState* states, size_t trajectory_count, size_t horizon, TrajectoryViolation* results) const noexcept {
+  tracing::ScopedSpan span("TrajectoryChecker::checkTrajectories", "lib_vehicle_model");
+
+  size_t feasible = 0;
+  for (size_t i = 0; i < trajectory_count; i++) {
+    results[i] = checkTrajectory(states + i * horizon, horizon);
+    feasible += results[i] == TrajectoryViolation::NONE;
+  }
+
+  return feasible;
+}
+
+size_t TrajectoryChecker::checkTrajectories(const std::vector<std::vector<VehicleState>>& trajectories, std::vector<TrajectoryViolation>& results) const {
+  tracing::ScopedSpan span("TrajectoryChecker::checkTrajectories", "lib_vehicle_model");
+
+  results.resize(trajectories.size());
+
+  size_t feasible = 0;
+  for (size_t i = 0; i < trajectories.size(); i++) {
+    results[i] = checkTrajectory(trajectories[i]);
+    feasible += results[i] == TrajectoryViolation::NONE;
+  }
+
+  return feasible;
+}
+
+bool TrajectoryChecker::checksLateralAcceleration() const {
+  return !std::isinf(max_lateral_acceleration_);
+}
+
+bool TrajectoryChecker::checksYawRate() const {
+  return !std::isinf(max_yaw_rate_);
+}
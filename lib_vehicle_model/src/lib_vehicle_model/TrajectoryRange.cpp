@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include "lib_vehicle_model/TrajectoryRange.h"
+
+/**
+ * Cpp containing the implementation of TrajectoryRange
+ */
+using namespace lib_vehicle_model;
+
+TrajectoryRange::TrajectoryRange(StepFunction step_function, const VehicleState& initial_state,
+  const std::vector<VehicleControlInput>& control_inputs, double timestep) :
+  step_function_(step_function), initial_state_(initial_state), control_inputs_(control_inputs), timestep_(timestep) {
+
+  if (!step_function_) {
+    throw std::invalid_argument("TrajectoryRange requires a valid step function");
+  }
+}
+
+TrajectoryRange::TrajectoryRange(std::shared_ptr<VehicleMotionModel> model, const VehicleState& initial_state,
+  const std::vector<VehicleControlInput>& control_inputs, double timestep) :
+  TrajectoryRange(modelStepFunction(model), initial_state, control_inputs, timestep) {}
+
+TrajectoryRange::StepFunction TrajectoryRange::modelStepFunction(std::shared_ptr<VehicleMotionModel> model) {
+  if (!model) {
+    throw std::invalid_argument("TrajectoryRange requires a non-null vehicle model");
+  }
+
+  // The model is captured by shared pointer so it lives as long as the range
+  return [model](const VehicleState& state, const VehicleControlInput& control, double timestep) -> VehicleState {
+    return model->predictStep(state, control, timestep);
+  };
+}
+
+TrajectoryRange::const_iterator TrajectoryRange::begin() const {
+  if (control_inputs_.empty()) {
+    return end();
+  }
+
+  return const_iterator(this, 0, step_function_(initial_state_, control_inputs_[0], timestep_));
+}
+
+TrajectoryRange::const_iterator TrajectoryRange::end() const {
+  return const_iterator(this, control_inputs_.size(), initial_state_);
+}
+
+size_t TrajectoryRange::size() const {
+  return control_inputs_.size();
+}
+
+//
+// const_iterator
+//
+TrajectoryRange::const_iterator::const_iterator(const TrajectoryRange* range, size_t index, const VehicleState& state) :
+  range_(range), index_(index), state_(state) {}
+
+TrajectoryRange::const_iterator::reference TrajectoryRange::const_iterator::operator*() const {
+  return state_;
+}
+
+TrajectoryRange::const_iterator::pointer TrajectoryRange::const_iterator::operator->() const {
+  return &state_;
+}
+
+TrajectoryRange::const_iterator& TrajectoryRange::const_iterator::operator++() {
+  index_++;
+
+  // Only integrate if there is another control input to apply
+  if (index_ < range_->control_inputs_.size()) {
+    state_ = range_->step_function_(state_, range_->control_inputs_[index_], range_->timestep_);
+  }
+
+  return *this;
+}
+
+TrajectoryRange::const_iterator TrajectoryRange::const_iterator::operator++(int) {
+  const_iterator previous = *this;
+  ++(*this);
+  return previous;
+}
+
+bool TrajectoryRange::const_iterator::operator==(const const_iterator& other) const {
+  return range_ == other.range_ && index_ == other.index_;
+}
+
+bool TrajectoryRange::const_iterator::operator!=(const const_iterator& other) const {
+  return !(*this == other);
+}
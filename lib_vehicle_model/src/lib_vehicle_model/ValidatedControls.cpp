@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include "lib_vehicle_model/ValidatedControls.h"
+
+/**
+ * Cpp containing the implementation of ValidatedControls
+ */
+using namespace lib_vehicle_model;
+
+namespace {
+  // Returned by default constructed tokens
+  const std::vector<VehicleControlInput> NO_CONTROLS;
+}
+
+ValidatedControls::ValidatedControls(const std::vector<VehicleControlInput>& control_inputs, double timestep, uint64_t generation) :
+  control_inputs_(std::make_shared<const std::vector<VehicleControlInput>>(control_inputs)), timestep_(timestep), generation_(generation) {}
+
+const std::vector<VehicleControlInput>& ValidatedControls::getControlInputs() const {
+  return control_inputs_ ? *control_inputs_ : NO_CONTROLS;
+}
+
+double ValidatedControls::getTimestep() const {
+  return timestep_;
+}
+
+uint64_t ValidatedControls::getParameterGeneration() const {
+  return generation_;
+}
+
+bool ValidatedControls::empty() const {
+  return !control_inputs_ || control_inputs_->empty();
+}
@@ -15,6 +15,8 @@
  */
 
 #include <memory>
+#include <sstream>
+#include <random>
 #include <gtest/gtest.h>
 #include <gmock/gmock.h> 
 #include "lib_vehicle_model/VehicleState.h"
@@ -71,6 +73,15 @@ TEST(ConstraintChecker, constructor)
   EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
 
   
+  ASSERT_NO_THROW(ConstraintChecker cc(mock_param_server));
+
+  // A negative steering rate limit can never be met
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(-1.0), Return(true)));
+
+  ASSERT_THROW(ConstraintChecker cc(mock_param_server), std::invalid_argument);
+
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(0.0), Return(true)));
+
   ASSERT_NO_THROW(ConstraintChecker cc(mock_param_server));
 
 
@@ -215,3 +226,371 @@ TEST(ConstraintChecker, validateControlInputs)
   std::vector<VehicleControlInput> inputs_empty;
   ASSERT_THROW(cc->validateControlInputs(vs, inputs_empty, timestep), std::invalid_argument);
 }
+
+/**
+ * Tests the validateControlSequence and validateInitialSteeringRate functions of the ConstraintChecker
+ */ 
+TEST(ConstraintChecker, validateControlSequence)
+{
+
+  // Build constraint checker
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  std::unique_ptr<ConstraintChecker> cc;
+  ASSERT_NO_THROW(cc = std::unique_ptr<ConstraintChecker>(new ConstraintChecker(mock_param_server)));
+
+  VehicleState vs; // All values default to 0
+  double timestep = 0.1;
+
+  // The steering rate of the first input depends on the initial state so is only checked by validateInitialSteeringRate
+  std::vector<VehicleControlInput> inputs(3);
+  for (VehicleControlInput& control : inputs) {
+    control.target_steering_angle = 50.0;
+  }
+  ASSERT_NO_THROW(cc->validateControlSequence(inputs, timestep));
+  ASSERT_THROW(cc->validateInitialSteeringRate(vs, inputs[0], timestep), std::invalid_argument);
+  ASSERT_THROW(cc->validateControlInputs(vs, inputs, timestep), std::invalid_argument);
+
+  vs.steering_angle = 45.0;
+  ASSERT_NO_THROW(cc->validateInitialSteeringRate(vs, inputs[0], timestep));
+  ASSERT_NO_THROW(cc->validateControlInputs(vs, inputs, timestep));
+
+  // Only the steering rate is checked against the initial state
+  VehicleControlInput fast;
+  fast.target_velocity = 20.0;
+  ASSERT_NO_THROW(cc->validateInitialSteeringRate(VehicleState(), fast, timestep));
+
+  // All other checks still apply
+  inputs[2].target_steering_angle = 40.0;
+  ASSERT_THROW(cc->validateControlSequence(inputs, timestep), std::invalid_argument);
+  inputs[2].target_steering_angle = 50.0;
+  inputs[0].target_velocity = 20.0;
+  ASSERT_THROW(cc->validateControlSequence(inputs, timestep), std::invalid_argument);
+
+  std::vector<VehicleControlInput> inputs_empty;
+  ASSERT_THROW(cc->validateControlSequence(inputs_empty, timestep), std::invalid_argument);
+}
+
+/**
+ * Tests the validateControlChanges function of the ConstraintChecker
+ */ 
+TEST(ConstraintChecker, validateControlChanges)
+{
+
+  // Build constraint checker
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  std::unique_ptr<ConstraintChecker> cc;
+  ASSERT_NO_THROW(cc = std::unique_ptr<ConstraintChecker>(new ConstraintChecker(mock_param_server)));
+
+  VehicleState vs; // All values default to 0
+  double timestep = 0.1;
+
+  // Test valid change points
+  std::vector<TimedControlInput> changes(3);
+  changes[0].time = 0.0;
+  changes[1].time = 2.5;
+  changes[1].control.target_steering_angle = 5.0;
+  changes[2].time = 2.5; // Repeated times are allowed
+  changes[2].control.target_velocity = 8.0;
+  ASSERT_NO_THROW(cc->validateControlChanges(vs, changes, timestep));
+
+  // Test unordered and negative times
+  changes[2].time = 1.0;
+  ASSERT_THROW(cc->validateControlChanges(vs, changes, timestep), std::invalid_argument);
+  changes[2].time = 3.0;
+
+  changes[0].time = -1.0;
+  ASSERT_THROW(cc->validateControlChanges(vs, changes, timestep), std::invalid_argument);
+  changes[0].time = 0.0;
+
+  // Test failing control inputs
+  changes[2].control.target_velocity = 20.0;
+  ASSERT_THROW(cc->validateControlChanges(vs, changes, timestep), std::invalid_argument);
+  changes[2].control.target_velocity = 0.0;
+
+  changes[2].control.target_steering_angle = -200.0;
+  ASSERT_THROW(cc->validateControlChanges(vs, changes, timestep), std::invalid_argument);
+
+  // Check steering angle rate between change points 90 * .1 = 9
+  changes[2].control.target_steering_angle = -5.0;
+  ASSERT_THROW(cc->validateControlChanges(vs, changes, timestep), std::invalid_argument);
+  changes[2].control.target_steering_angle = 0.0;
+  ASSERT_NO_THROW(cc->validateControlChanges(vs, changes, timestep));
+
+  // Change points which round to the same step only apply the last one, so the rate is checked against the applied control
+  std::vector<TimedControlInput> same_step_changes(2);
+  same_step_changes[0].time = 0.01;
+  same_step_changes[0].control.target_steering_angle = 20.0; // Overridden before it is applied
+  same_step_changes[1].time = 0.02;
+  same_step_changes[1].control.target_steering_angle = 5.0;
+  ASSERT_NO_THROW(cc->validateControlChanges(vs, same_step_changes, timestep));
+
+  same_step_changes[0].control.target_steering_angle = 5.0;
+  same_step_changes[1].control.target_steering_angle = 20.0; // Applied in the first step after a steering angle of 0
+  ASSERT_THROW(cc->validateControlChanges(vs, same_step_changes, timestep), std::invalid_argument);
+
+  same_step_changes[0].control.target_steering_angle = -200.0; // Overridden change points are still checked against the limits
+  same_step_changes[1].control.target_steering_angle = 5.0;
+  ASSERT_THROW(cc->validateControlChanges(vs, same_step_changes, timestep), std::invalid_argument);
+
+  std::vector<TimedControlInput> changes_empty;
+  ASSERT_THROW(cc->validateControlChanges(vs, changes_empty, timestep), std::invalid_argument);
+}
+
+/**
+ * Tests the checkControlInputs function of the ConstraintChecker
+ */ 
+TEST(ConstraintChecker, checkControlInputs)
+{
+
+  // Build constraint checker
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  std::unique_ptr<ConstraintChecker> cc;
+  ASSERT_NO_THROW(cc = std::unique_ptr<ConstraintChecker>(new ConstraintChecker(mock_param_server)));
+
+  VehicleState vs; // All values default to 0
+  double timestep = 0.1;
+  ControlViolationReport report;
+
+  // Valid inputs leave the per control masks empty
+  std::vector<VehicleControlInput> inputs(3);
+  ASSERT_TRUE(cc->checkControlInputs(vs, inputs.data(), inputs.size(), timestep, report));
+  ASSERT_TRUE(report.violations.empty());
+  ASSERT_EQ(0, report.violation_count);
+  ASSERT_EQ(ControlViolation::NONE, report.combined);
+  ASSERT_TRUE(cc->areValidControlInputs(vs, inputs.data(), inputs.size(), timestep));
+
+  // Every violation of every input is reported
+  inputs[1].target_velocity = 20.0;
+  inputs[1].target_steering_angle = 200.0; // Also exceeds the steering rate of 90 * .1 = 9
+  inputs[2].target_steering_angle = 0.0; // Steering rate violation from the previous input only
+  ASSERT_FALSE(cc->checkControlInputs(vs, inputs.data(), inputs.size(), timestep, report));
+  ASSERT_EQ(3, report.violations.size());
+  ASSERT_EQ(2, report.violation_count);
+  ASSERT_EQ(1, report.first_violation);
+  ASSERT_EQ(ControlViolation::NONE, report.violations[0]);
+  ASSERT_EQ(ControlViolation::VELOCITY_ABOVE_MAX | ControlViolation::STEERING_ABOVE_MAX | ControlViolation::STEERING_RATE_ABOVE_MAX,
+    report.violations[1]);
+  ASSERT_EQ(ControlViolation::STEERING_RATE_ABOVE_MAX, report.violations[2]);
+  ASSERT_TRUE(hasViolation(report.combined, ControlViolation::VELOCITY_ABOVE_MAX));
+  ASSERT_FALSE(hasViolation(report.combined, ControlViolation::VELOCITY_BELOW_MIN));
+  ASSERT_FALSE(cc->areValidControlInputs(vs, inputs.data(), inputs.size(), timestep));
+
+  // The throwing version reports the first violated limit of the first invalid input
+  try {
+    cc->validateControlInputs(vs, inputs, timestep);
+    FAIL() << "Expected std::invalid_argument";
+  } catch (const std::invalid_argument& e) {
+    ASSERT_EQ(0, std::string(e.what()).find("Invalid control_input 1 with target_velocity: 20"));
+  }
+
+  inputs[1].target_velocity = -20.0;
+  inputs[1].target_steering_angle = -5.0;
+  inputs[2].target_steering_angle = -5.0;
+  ASSERT_FALSE(cc->checkControlInputs(vs, inputs.data(), inputs.size(), timestep, report));
+  ASSERT_EQ(1, report.violation_count);
+  ASSERT_EQ(ControlViolation::VELOCITY_BELOW_MIN, report.violations[1]);
+  ASSERT_EQ(ControlViolation::VELOCITY_BELOW_MIN, report.combined);
+
+  // A reused report is cleared by a successful check
+  inputs[1].target_velocity = 0.0;
+  ASSERT_TRUE(cc->checkControlInputs(vs, inputs.data(), inputs.size(), timestep, report));
+  ASSERT_TRUE(report.violations.empty());
+  ASSERT_EQ(0, report.violation_count);
+
+  // Steering below min
+  inputs[0].target_steering_angle = -200.0;
+  vs.steering_angle = -200.0;
+  ASSERT_FALSE(cc->checkControlInputs(vs, inputs.data(), 1, timestep, report));
+  ASSERT_EQ(ControlViolation::STEERING_BELOW_MIN, report.violations[0]);
+
+  // No inputs
+  ASSERT_FALSE(cc->checkControlInputs(vs, inputs.data(), 0, timestep, report));
+  ASSERT_EQ(0, report.violation_count);
+  ASSERT_FALSE(cc->checkControlInputs(vs, nullptr, 3, timestep, report));
+
+  std::ostringstream os;
+  os << (ControlViolation::VELOCITY_ABOVE_MAX | ControlViolation::STEERING_RATE_ABOVE_MAX) << " " << ControlViolation::NONE;
+  ASSERT_EQ("VELOCITY_ABOVE_MAX|STEERING_RATE_ABOVE_MAX NONE", os.str());
+}
+
+/**
+ * Tests the checkControlArrays and checkControlBatch functions of the ConstraintChecker
+ */ 
+TEST(ConstraintChecker, checkControlBatch)
+{
+
+  // Build constraint checker
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  std::unique_ptr<ConstraintChecker> cc;
+  ASSERT_NO_THROW(cc = std::unique_ptr<ConstraintChecker>(new ConstraintChecker(mock_param_server)));
+
+  double timestep = 0.1;
+
+  // Build a batch where every sequence violates a different set of limits
+  const size_t sequence_count = 6;
+  const size_t horizon = 17;
+  std::vector<double> velocities(sequence_count * horizon, 5.0);
+  std::vector<double> steering(sequence_count * horizon, 0.0);
+  std::vector<double> initial_steering(sequence_count, 0.0);
+
+  velocities[1 * horizon + 16] = 11.0; // Above max speed in the last control
+  velocities[2 * horizon + 8] = -11.0;
+  for (size_t i = 0; i < horizon; i++) {
+    steering[3 * horizon + i] = 5.0 * i; // Ramps past the max steering angle but within the rate limit until the end
+  }
+  steering[4 * horizon + 9] = -9.5; // Steering rate of 95 into and out of this control
+  initial_steering[5] = 10.0; // Only the first control violates the rate limit
+
+  ControlBatch batch;
+  batch.target_velocities = velocities.data();
+  batch.target_steering_angles = steering.data();
+  batch.initial_steering_angles = initial_steering.data();
+  batch.sequence_count = sequence_count;
+  batch.horizon = horizon;
+
+  std::vector<ControlViolation> results(sequence_count, ControlViolation::STEERING_BELOW_MIN);
+  cc->checkControlBatch(batch, timestep, results.data());
+
+  ASSERT_EQ(ControlViolation::NONE, results[0]);
+  ASSERT_EQ(ControlViolation::VELOCITY_ABOVE_MAX, results[1]);
+  ASSERT_EQ(ControlViolation::VELOCITY_BELOW_MIN, results[2]);
+  ASSERT_EQ(ControlViolation::NONE, results[3]); // 5 * 16 = 80 is still within the limits
+  ASSERT_EQ(ControlViolation::STEERING_RATE_ABOVE_MAX, results[4]);
+  ASSERT_EQ(ControlViolation::STEERING_RATE_ABOVE_MAX, results[5]);
+
+  // The branch-free check reports the union of the masks reported by checkControlInputs
+  steering[3 * horizon + 16] = 200.0;
+  velocities[3 * horizon + 2] = -20.0;
+  cc->checkControlBatch(batch, timestep, results.data());
+  for (size_t s = 0; s < sequence_count; s++) {
+    VehicleState vs;
+    vs.steering_angle = initial_steering[s];
+    std::vector<VehicleControlInput> inputs(horizon);
+    for (size_t i = 0; i < horizon; i++) {
+      inputs[i].target_velocity = velocities[s * horizon + i];
+      inputs[i].target_steering_angle = steering[s * horizon + i];
+    }
+
+    ControlViolationReport report;
+    cc->checkControlInputs(vs, inputs.data(), inputs.size(), timestep, report);
+    ASSERT_EQ(report.combined, results[s]) << "sequence " << s;
+    ASSERT_EQ(report.combined, cc->checkControlArrays(initial_steering[s], &velocities[s * horizon], &steering[s * horizon], horizon, timestep));
+  }
+  ASSERT_EQ(ControlViolation::VELOCITY_BELOW_MIN | ControlViolation::STEERING_ABOVE_MAX | ControlViolation::STEERING_RATE_ABOVE_MAX, results[3]);
+
+  // Empty sequences have no violations
+  ASSERT_EQ(ControlViolation::NONE, cc->checkControlArrays(0.0, nullptr, nullptr, 0, timestep));
+}
+
+/**
+ * Tests the sanitizeControlInputs function of the ConstraintChecker
+ */ 
+TEST(ConstraintChecker, sanitizeControlInputs)
+{
+
+  // Build constraint checker
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(0.6), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-0.6), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(0.3), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  std::unique_ptr<ConstraintChecker> cc;
+  ASSERT_NO_THROW(cc = std::unique_ptr<ConstraintChecker>(new ConstraintChecker(mock_param_server)));
+
+  VehicleState vs; // All values default to 0
+  double timestep = 0.1;
+  ControlViolationReport report;
+
+  // A null array is only accepted when it is empty
+  ASSERT_TRUE(cc->sanitizeControlInputs(vs, nullptr, 0, timestep, report));
+  ASSERT_FALSE(cc->sanitizeControlInputs(vs, nullptr, 3, timestep, report));
+
+  // Valid inputs are not modified
+  std::vector<VehicleControlInput> inputs(3);
+  inputs[1].target_steering_angle = 0.03;
+  inputs[2].target_velocity = 10.0;
+  std::vector<VehicleControlInput> sanitized(inputs);
+  ASSERT_TRUE(cc->sanitizeControlInputs(vs, sanitized.data(), sanitized.size(), timestep, report));
+  ASSERT_TRUE(report.violations.empty());
+  for (size_t i = 0; i < inputs.size(); i++) {
+    ASSERT_EQ(inputs[i].target_velocity, sanitized[i].target_velocity);
+    ASSERT_EQ(inputs[i].target_steering_angle, sanitized[i].target_steering_angle);
+  }
+
+  // Each control is clamped to the limits and then rate limited from the previous sanitized control
+  inputs[0].target_velocity = 15.0;
+  inputs[1].target_velocity = -15.0;
+  inputs[1].target_steering_angle = 1.0; // Clamped to 0.6 and then rate limited to 0.03
+  inputs[2].target_steering_angle = 0.0; // Valid relative to the sanitized previous control
+  sanitized = inputs;
+  ASSERT_FALSE(cc->sanitizeControlInputs(vs, sanitized.data(), sanitized.size(), timestep, report));
+  ASSERT_EQ(2, report.violation_count);
+  ASSERT_EQ(0, report.first_violation);
+  ASSERT_EQ(ControlViolation::VELOCITY_ABOVE_MAX, report.violations[0]);
+  ASSERT_EQ(ControlViolation::VELOCITY_BELOW_MIN | ControlViolation::STEERING_ABOVE_MAX | ControlViolation::STEERING_RATE_ABOVE_MAX,
+    report.violations[1]);
+  ASSERT_EQ(ControlViolation::NONE, report.violations[2]);
+  ASSERT_NEAR(10.0, sanitized[0].target_velocity, 0.0000001);
+  ASSERT_NEAR(-10.0, sanitized[1].target_velocity, 0.0000001);
+  ASSERT_NEAR(0.03, sanitized[1].target_steering_angle, 0.0000001);
+  ASSERT_NEAR(0.0, sanitized[2].target_steering_angle, 0.0000001);
+  ASSERT_NO_THROW(cc->validateControlInputs(vs, sanitized, timestep));
+
+  // Sanitized random sequences always pass validation including at the limits of the steering rate
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> speed(-20.0, 20.0);
+  std::uniform_real_distribution<double> steer(-1.0, 1.0);
+  for (size_t trial = 0; trial < 100; trial++) {
+    vs.steering_angle = steer(gen) * 0.6;
+    std::vector<VehicleControlInput> random_inputs(50);
+    for (VehicleControlInput& control : random_inputs) {
+      control.target_velocity = speed(gen);
+      control.target_steering_angle = steer(gen);
+    }
+
+    cc->sanitizeControlInputs(vs, random_inputs.data(), random_inputs.size(), 0.07, report);
+    ASSERT_TRUE(cc->areValidControlInputs(vs, random_inputs.data(), random_inputs.size(), 0.07));
+    ASSERT_NO_THROW(cc->validateControlInputs(vs, random_inputs, 0.07));
+  }
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <memory>
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "lib_vehicle_model/FeasibilityFilter.h"
+#include "lib_vehicle_model/ModelAccessException.h"
+#include "lib_vehicle_model/ParameterServer.h"
+
+/**
+ * Unit tests for FeasibilityFilter
+ */
+
+using namespace lib_vehicle_model;
+using ::testing::A;
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Return;
+
+namespace {
+  class FeasibilityParamServer : public ParameterServer {
+    public:
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, std::string& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, double& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, float& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, int& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, bool& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, std::vector<std::string>& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, std::vector<double>& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, std::vector<float>& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, std::vector<int>& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, std::vector<bool>& output));
+      ~FeasibilityParamServer() {};
+  };
+
+  ACTION_P(set_value, val)
+  {
+    arg1 = val;
+  }
+
+  std::shared_ptr<FeasibilityParamServer> buildParamServer(bool wheel_base) {
+    auto param_server = std::make_shared<FeasibilityParamServer>();
+
+    EXPECT_CALL(*param_server, getParam("acceleration_limit", A<double&>())).WillRepeatedly(DoAll(set_value(2.0), Return(true)));
+    EXPECT_CALL(*param_server, getParam("deceleration_limit", A<double&>())).WillRepeatedly(DoAll(set_value(4.0), Return(true)));
+
+    if (wheel_base) {
+      EXPECT_CALL(*param_server, getParam("length_to_f", A<double&>())).WillRepeatedly(DoAll(set_value(1.5), Return(true)));
+      EXPECT_CALL(*param_server, getParam("length_to_r", A<double&>())).WillRepeatedly(DoAll(set_value(1.0), Return(true)));
+    } else {
+      EXPECT_CALL(*param_server, getParam("length_to_f", A<double&>())).WillRepeatedly(Return(false));
+      EXPECT_CALL(*param_server, getParam("length_to_r", A<double&>())).WillRepeatedly(Return(false));
+    }
+
+    return param_server;
+  }
+
+  std::vector<VehicleControlInput> speedCommands(const std::vector<double>& speeds) {
+    std::vector<VehicleControlInput> controls(speeds.size());
+    for (size_t i = 0; i < speeds.size(); i++) {
+      controls[i].target_velocity = speeds[i];
+    }
+    return controls;
+  }
+}
+
+/**
+ * Tests the constructor of the FeasibilityFilter
+ */
+TEST(FeasibilityFilter, constructor)
+{
+  ASSERT_TRUE(FeasibilityFilter(buildParamServer(true)).boundsHeading());
+  ASSERT_FALSE(FeasibilityFilter(buildParamServer(false)).boundsHeading());
+
+  auto missing = std::make_shared<FeasibilityParamServer>();
+  EXPECT_CALL(*missing, getParam(_, A<double&>())).WillRepeatedly(Return(false));
+  ASSERT_THROW(FeasibilityFilter filter(missing), std::invalid_argument);
+
+  auto zero_limit = std::make_shared<FeasibilityParamServer>();
+  EXPECT_CALL(*zero_limit, getParam("acceleration_limit", A<double&>())).WillRepeatedly(DoAll(set_value(0.0), Return(true)));
+  EXPECT_CALL(*zero_limit, getParam("deceleration_limit", A<double&>())).WillRepeatedly(DoAll(set_value(4.0), Return(true)));
+  ASSERT_THROW(FeasibilityFilter filter(zero_limit), std::invalid_argument);
+}
+
+/**
+ * Tests the speed and distance bounds computed by the FeasibilityFilter
+ */
+TEST(FeasibilityFilter, computeBounds)
+{
+  FeasibilityFilter filter(buildParamServer(false));
+  FeasibilityBounds bounds;
+  VehicleState vs;
+
+  // Accelerating from rest at 2 m/s^2 toward 3 m/s
+  ASSERT_TRUE(filter.computeBounds(vs, speedCommands({ 3.0, 3.0, 3.0 }), 1.0, bounds));
+  ASSERT_EQ(4, bounds.max_speed.size());
+  ASSERT_NEAR(2.0, bounds.max_speed[1], 0.0000001);
+  ASSERT_NEAR(3.0, bounds.max_speed[2], 0.0000001);
+  ASSERT_NEAR(3.0, bounds.max_speed[3], 0.0000001);
+  ASSERT_NEAR(1.0, bounds.max_distance[1], 0.0000001);
+  ASSERT_NEAR(1.0 + 2.0 * 0.5 + 0.25 + 3.0 * 0.5, bounds.max_distance[2], 0.0000001); // Reaches 3 m/s after 0.5 s
+  ASSERT_NEAR(bounds.max_distance[2] + 3.0, bounds.max_distance[3], 0.0000001);
+  // The vehicle may not respond to a higher command at all
+  ASSERT_NEAR(0.0, bounds.min_speed[3], 0.0000001);
+  ASSERT_NEAR(0.0, bounds.min_distance[3], 0.0000001);
+
+  // Braking from 10 m/s at 4 m/s^2 toward 0
+  vs.longitudinal_vel = 10.0;
+  ASSERT_TRUE(filter.computeBounds(vs, speedCommands({ 0.0, 0.0, 0.0, 0.0 }), 1.0, bounds));
+  ASSERT_NEAR(6.0, bounds.min_speed[1], 0.0000001);
+  ASSERT_NEAR(2.0, bounds.min_speed[2], 0.0000001);
+  ASSERT_NEAR(0.0, bounds.min_speed[3], 0.0000001);
+  ASSERT_NEAR(8.0, bounds.min_distance[1], 0.0000001);
+  ASSERT_NEAR(12.0, bounds.min_distance[2], 0.0000001);
+  ASSERT_NEAR(12.5, bounds.min_distance[3], 0.0000001);
+  ASSERT_NEAR(12.5, bounds.min_distance[4], 0.0000001);
+  ASSERT_NEAR(40.0, bounds.max_distance[4], 0.0000001);
+  ASSERT_TRUE(bounds.max_heading_change[4] > 1000.0); // Heading is unbounded without a wheel base
+
+  // Negative speeds can not be bounded
+  ASSERT_FALSE(filter.computeBounds(vs, speedCommands({ 1.0, -1.0 }), 1.0, bounds));
+  vs.longitudinal_vel = -1.0;
+  ASSERT_FALSE(filter.computeBounds(vs, speedCommands({ 1.0 }), 1.0, bounds));
+
+  ASSERT_THROW(filter.computeBounds(vs, speedCommands({ 1.0 }), 0.0, bounds), std::invalid_argument);
+}
+
+/**
+ * Tests that the bounds contain the motion of a speed controller which respects the acceleration limits
+ */
+TEST(FeasibilityFilter, boundsContainMotion)
+{
+  FeasibilityFilter filter(buildParamServer(true));
+  FeasibilityBounds bounds;
+
+  VehicleState vs;
+  vs.longitudinal_vel = 4.0;
+  std::vector<VehicleControlInput> controls = speedCommands({ 8.0, 8.0, 12.0, 2.0, 2.0, 0.0, 6.0, 6.0, 1.0, 1.0 });
+  for (size_t i = 0; i < controls.size(); i++) {
+    controls[i].target_steering_angle = 0.05 * ((i % 3) - 1.0);
+  }
+  const double timestep = 0.5;
+  ASSERT_TRUE(filter.computeBounds(vs, controls, timestep, bounds));
+
+  // Proportional speed controllers of different gains with a kinematic bicycle heading
+  for (double kP : { 0.3, 1.0, 5.0 }) {
+    double speed = vs.longitudinal_vel;
+    double distance = 0.0;
+    double heading = 0.0;
+    const size_t substeps = 1000;
+    const double dt = timestep / substeps;
+
+    for (size_t i = 0; i < controls.size(); i++) {
+      for (size_t s = 0; s < substeps; s++) {
+        const double accel = std::min(std::max(kP * (controls[i].target_velocity - speed), -4.0), 2.0);
+        const double next_speed = speed + accel * dt;
+        distance += 0.5 * (speed + next_speed) * dt;
+        heading += 0.5 * (speed + next_speed) * dt * std::tan(controls[i].target_steering_angle) / 2.5;
+        speed = next_speed;
+      }
+
+      ASSERT_LE(bounds.min_speed[i + 1] - 0.000001, speed);
+      ASSERT_GE(bounds.max_speed[i + 1] + 0.000001, speed);
+      ASSERT_LE(bounds.min_distance[i + 1] - 0.000001, distance);
+      ASSERT_GE(bounds.max_distance[i + 1] + 0.000001, distance);
+      ASSERT_GE(bounds.max_heading_change[i + 1] + 0.000001, std::fabs(heading));
+    }
+  }
+}
+
+/**
+ * Tests rejecting candidates with isFeasible and filter
+ */
+TEST(FeasibilityFilter, filter)
+{
+  FeasibilityFilter filter(buildParamServer(true));
+  VehicleState vs;
+
+  // Reaching 10 m in 3 s from rest needs an average speed the acceleration limit can not provide for slow commands
+  FeasibilityGoal reach;
+  reach.time = 3.0;
+  reach.min_distance = 5.0;
+
+  std::vector<std::vector<VehicleControlInput>> candidates;
+  candidates.push_back(speedCommands({ 1.0, 1.0, 1.0, 1.0 })); // At most 3 m by 3 s
+  candidates.push_back(speedCommands({ 5.0, 5.0, 5.0, 5.0 })); // At most 1 + 3 + 5 m by 3 s
+  candidates.push_back(speedCommands({ 5.0, 0.0, 5.0, 5.0 }));
+
+  std::vector<FeasibilityGoal> goals(1, reach);
+  ASSERT_FALSE(filter.isFeasible(vs, candidates[0], 1.0, goals));
+  ASSERT_TRUE(filter.isFeasible(vs, candidates[1], 1.0, goals));
+
+  std::vector<size_t> feasible = filter.filter(vs, candidates, 1.0, goals);
+  ASSERT_EQ(2, feasible.size());
+  ASSERT_EQ(1, feasible[0]);
+  ASSERT_EQ(2, feasible[1]);
+
+  // Stopping goals use the slowest possible motion
+  FeasibilityGoal stop;
+  stop.time = 2.0;
+  stop.max_speed = 0.5;
+  vs.longitudinal_vel = 10.0;
+  goals.assign(1, stop);
+  ASSERT_FALSE(filter.isFeasible(vs, speedCommands({ 0.0, 0.0, 0.0 }), 1.0, goals)); // Can only slow to 2 m/s in 2 s
+  stop.time = 3.0;
+  goals.assign(1, stop);
+  ASSERT_TRUE(filter.isFeasible(vs, speedCommands({ 0.0, 0.0, 0.0 }), 1.0, goals));
+
+  FeasibilityGoal short_stop;
+  short_stop.time = 3.0;
+  short_stop.max_distance = 10.0; // At least 12.5 m is needed to stop
+  goals.assign(1, short_stop);
+  ASSERT_FALSE(filter.isFeasible(vs, speedCommands({ 0.0, 0.0, 0.0 }), 1.0, goals));
+
+  // Heading goals
+  FeasibilityGoal turn;
+  turn.time = 2.0;
+  turn.min_heading_change = 1.0;
+  goals.assign(1, turn);
+  vs.longitudinal_vel = 1.0;
+  std::vector<VehicleControlInput> gentle = speedCommands({ 1.0, 1.0 });
+  gentle[0].target_steering_angle = 0.1;
+  gentle[1].target_steering_angle = 0.1;
+  ASSERT_FALSE(filter.isFeasible(vs, gentle, 1.0, goals)); // 2 m at a curvature of tan(0.1) / 2.5
+  ASSERT_TRUE(FeasibilityFilter(buildParamServer(false)).isFeasible(vs, gentle, 1.0, goals));
+
+  // Goal times between steps use the bounds of the enclosing steps
+  FeasibilityGoal between;
+  between.time = 1.5;
+  between.min_distance = 1.4;
+  goals.assign(1, between);
+  ASSERT_TRUE(filter.isFeasible(vs, gentle, 1.0, goals));
+  between.min_distance = 2.1;
+  goals.assign(1, between);
+  ASSERT_FALSE(filter.isFeasible(vs, gentle, 1.0, goals));
+
+  // Negative speeds are never rejected
+  vs.longitudinal_vel = -1.0;
+  ASSERT_TRUE(filter.isFeasible(vs, gentle, 1.0, goals));
+  vs.longitudinal_vel = 1.0;
+
+  between.time = 2.5;
+  goals.assign(1, between);
+  ASSERT_THROW(filter.isFeasible(vs, gentle, 1.0, goals), std::invalid_argument);
+  between.time = -0.5;
+  goals.assign(1, between);
+  ASSERT_THROW(filter.isFeasible(vs, gentle, 1.0, goals), std::invalid_argument);
+}
+
+/**
+ * Tests that predictIfFeasible only integrates candidates which pass the filter
+ */
+TEST(FeasibilityFilter, predictIfFeasible)
+{
+  FeasibilityFilter filter(buildParamServer(true));
+  VehicleState vs;
+
+  FeasibilityGoal reach;
+  reach.time = 2.0;
+  reach.min_distance = 100.0;
+  std::vector<FeasibilityGoal> goals(1, reach);
+
+  // Rejected candidates never reach lib_vehicle_model::predict so no model needs to be loaded
+  std::vector<VehicleState> states;
+  ASSERT_FALSE(filter.predictIfFeasible(vs, speedCommands({ 5.0, 5.0 }), 1.0, goals, states));
+  ASSERT_TRUE(states.empty());
+
+  goals[0].min_distance = 1.0;
+  ASSERT_THROW(filter.predictIfFeasible(vs, speedCommands({ 5.0, 5.0 }), 1.0, goals, states), ModelAccessException);
+}
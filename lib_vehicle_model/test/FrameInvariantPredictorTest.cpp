@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <math.h>
+#include <memory>
+#include <gtest/gtest.h>
+#include "lib_vehicle_model/FrameInvariantPredictor.h"
+#include "TestVehicleModel.h"
+
+/**
+ * Unit tests for SE2Transform and FrameInvariantPredictor
+ */
+
+using namespace lib_vehicle_model;
+
+namespace {
+  /**
+   * Vehicle model which is not frame invariant
+   */
+  class GlobalFrameModel : public TestVehicleModel
+  {
+    public:
+      bool isFrameInvariant() const override {
+        return false;
+      }
+  };
+
+  std::vector<VehicleControlInput> buildControls(size_t count) {
+    std::vector<VehicleControlInput> controls(count);
+    for (size_t i = 0; i < count; i++) {
+      controls[i].target_velocity = 5.0 + i * 0.1;
+      controls[i].target_steering_angle = 0.02 * i;
+    }
+    return controls;
+  }
+}
+
+/**
+ * Tests that a transform from the canonical frame of a state places the origin at that state
+ */
+TEST(SE2Transform, apply)
+{
+  VehicleState vs;
+  vs.X_pos_global = 10.0;
+  vs.Y_pos_global = -3.0;
+  vs.orientation = M_PI / 2.0;
+
+  std::vector<VehicleState> states(2);
+  states[1].X_pos_global = 2.0;
+  states[1].Y_pos_global = 1.0;
+  states[1].orientation = 0.5;
+  states[1].longitudinal_vel = 4.0;
+
+  SE2Transform::fromState(vs).apply(states.data(), states.size());
+
+  ASSERT_NEAR(10.0, states[0].X_pos_global, 0.0000001);
+  ASSERT_NEAR(-3.0, states[0].Y_pos_global, 0.0000001);
+  ASSERT_NEAR(M_PI / 2.0, states[0].orientation, 0.0000001);
+
+  ASSERT_NEAR(9.0, states[1].X_pos_global, 0.0000001);
+  ASSERT_NEAR(-1.0, states[1].Y_pos_global, 0.0000001);
+  ASSERT_NEAR(M_PI / 2.0 + 0.5, states[1].orientation, 0.0000001);
+  ASSERT_NEAR(4.0, states[1].longitudinal_vel, 0.0000001); // Body frame fields are unchanged
+}
+
+/**
+ * Tests the constructor input checks
+ */
+TEST(FrameInvariantPredictor, constructor)
+{
+  ASSERT_THROW(FrameInvariantPredictor(nullptr, 10), std::invalid_argument);
+  ASSERT_THROW(FrameInvariantPredictor(std::make_shared<GlobalFrameModel>(), 10), std::invalid_argument);
+  ASSERT_NO_THROW(FrameInvariantPredictor(std::make_shared<TestVehicleModel>(), 10));
+  ASSERT_NO_THROW(FrameInvariantPredictor(std::make_shared<TestVehicleModel>(), 0));
+}
+
+/**
+ * Tests that predictions match the wrapped model and are shared between poses with the same body frame state
+ */
+TEST(FrameInvariantPredictor, predict)
+{
+  auto model = std::make_shared<TestVehicleModel>();
+  TestVehicleModel reference;
+  FrameInvariantPredictor predictor(model, 2);
+
+  std::vector<VehicleControlInput> controls = buildControls(20);
+
+  VehicleState vs_a;
+  vs_a.X_pos_global = 100.0;
+  vs_a.Y_pos_global = 50.0;
+  vs_a.orientation = 0.7;
+  vs_a.longitudinal_vel = 5.0;
+
+  VehicleState vs_b = vs_a;
+  vs_b.X_pos_global = -20.0;
+  vs_b.Y_pos_global = 3.0;
+  vs_b.orientation = -2.0;
+
+  std::vector<VehicleState> result_a = predictor.predict(vs_a, controls, 0.1);
+  ASSERT_EQ(1, predictor.getCacheMisses());
+  ASSERT_EQ(20, model->integrated_steps);
+
+  // A second vehicle with the same body frame state reuses the integration
+  std::vector<VehicleState> result_b = predictor.predict(vs_b, controls, 0.1);
+  ASSERT_EQ(1, predictor.getCacheHits());
+  ASSERT_EQ(20, model->integrated_steps);
+
+  std::vector<VehicleState> expected_a = reference.predict(vs_a, controls, 0.1);
+  std::vector<VehicleState> expected_b = reference.predict(vs_b, controls, 0.1);
+  ASSERT_EQ(expected_a.size(), result_a.size());
+  ASSERT_EQ(expected_b.size(), result_b.size());
+  for (size_t i = 0; i < expected_a.size(); i++) {
+    ASSERT_NEAR(expected_a[i].X_pos_global, result_a[i].X_pos_global, 0.0000001);
+    ASSERT_NEAR(expected_a[i].Y_pos_global, result_a[i].Y_pos_global, 0.0000001);
+    ASSERT_NEAR(expected_a[i].orientation, result_a[i].orientation, 0.0000001);
+    ASSERT_NEAR(expected_b[i].X_pos_global, result_b[i].X_pos_global, 0.0000001);
+    ASSERT_NEAR(expected_b[i].Y_pos_global, result_b[i].Y_pos_global, 0.0000001);
+    ASSERT_NEAR(expected_b[i].orientation, result_b[i].orientation, 0.0000001);
+    ASSERT_NEAR(expected_b[i].longitudinal_vel, result_b[i].longitudinal_vel, 0.0000001);
+  }
+
+  // Predictions without control inputs are cached separately
+  std::vector<VehicleState> no_control = predictor.predict(vs_a, 0.1, 1.0);
+  std::vector<VehicleState> expected_no_control = reference.predict(vs_a, 0.1, 1.0);
+  ASSERT_EQ(2, predictor.getCacheMisses());
+  ASSERT_EQ(expected_no_control.size(), no_control.size());
+  ASSERT_NEAR(expected_no_control.back().X_pos_global, no_control.back().X_pos_global, 0.0000001);
+  ASSERT_NEAR(expected_no_control.back().Y_pos_global, no_control.back().Y_pos_global, 0.0000001);
+
+  // A different body frame state evicts the least recently used entry
+  VehicleState vs_c = vs_a;
+  vs_c.longitudinal_vel = 6.0;
+  predictor.predict(vs_c, controls, 0.1);
+  ASSERT_EQ(3, predictor.getCacheMisses());
+  ASSERT_EQ(2, predictor.getCacheSize());
+
+  predictor.predict(vs_b, controls, 0.1);
+  ASSERT_EQ(4, predictor.getCacheMisses());
+
+  predictor.clearCache();
+  ASSERT_EQ(0, predictor.getCacheSize());
+  predictor.predict(vs_b, controls, 0.1);
+  ASSERT_EQ(5, predictor.getCacheMisses());
+}
+
+/**
+ * Tests that a cache capacity of 0 still integrates in the canonical frame without storing results
+ */
+TEST(FrameInvariantPredictor, no_cache)
+{
+  auto model = std::make_shared<TestVehicleModel>();
+  FrameInvariantPredictor predictor(model, 0);
+
+  VehicleState vs;
+  vs.X_pos_global = 5.0;
+  std::vector<VehicleControlInput> controls = buildControls(5);
+
+  predictor.predict(vs, controls, 0.1);
+  std::vector<VehicleState> result = predictor.predict(vs, controls, 0.1);
+
+  ASSERT_EQ(0, predictor.getCacheHits());
+  ASSERT_EQ(2, predictor.getCacheMisses());
+  ASSERT_EQ(0, predictor.getCacheSize());
+  ASSERT_EQ(10, model->integrated_steps);
+  ASSERT_NEAR(TestVehicleModel().predict(vs, controls, 0.1).back().X_pos_global, result.back().X_pos_global, 0.0000001);
+}
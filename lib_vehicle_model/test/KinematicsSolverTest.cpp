@@ -14,6 +14,9 @@
  * the License.
  */
 
+#include <cmath>
+#include <vector>
+#include <sstream>
 #include <gtest/gtest.h>
 #include "lib_vehicle_model/KinematicsSolver.h"
 #include "lib_vehicle_model/KinematicsProperty.h"
@@ -328,3 +331,197 @@ TEST(KinematicsSolver, solve_exceptions)
     std::domain_error);
   
 }
+
+/**
+ * Tests that the compile time form of the solve function matches the runtime form
+ */ 
+TEST(KinematicsSolver, solve_template)
+{
+  // Values 
+  const double d = 43.6;
+  const double a = 2.5;
+  const double t = 2.4;
+  const double v_i = 15.16666666;
+  const double v_f = 21.16666666;
+  const double error_bound = 0.0000001;
+
+  ASSERT_NEAR(v_i, (KinematicsSolver::solve<KinematicsProperty::INITIAL_VELOCITY, KinematicsProperty::FINAL_VELOCITY>(a,d,t)), error_bound);
+  ASSERT_NEAR(v_i, (KinematicsSolver::solve<KinematicsProperty::INITIAL_VELOCITY, KinematicsProperty::ACCELERATION>(v_f,d,t)), error_bound);
+  ASSERT_NEAR(v_i, (KinematicsSolver::solve<KinematicsProperty::INITIAL_VELOCITY, KinematicsProperty::DISTANCE>(v_f,a,t)), error_bound);
+  ASSERT_NEAR(v_i, (KinematicsSolver::solve<KinematicsProperty::INITIAL_VELOCITY, KinematicsProperty::TIME>(v_f,a,d)), error_bound);
+
+  ASSERT_NEAR(v_f, (KinematicsSolver::solve<KinematicsProperty::FINAL_VELOCITY, KinematicsProperty::INITIAL_VELOCITY>(a,d,t)), error_bound);
+  ASSERT_NEAR(v_f, (KinematicsSolver::solve<KinematicsProperty::FINAL_VELOCITY, KinematicsProperty::ACCELERATION>(v_i,d,t)), error_bound);
+  ASSERT_NEAR(v_f, (KinematicsSolver::solve<KinematicsProperty::FINAL_VELOCITY, KinematicsProperty::DISTANCE>(v_i,a,t)), error_bound);
+  ASSERT_NEAR(v_f, (KinematicsSolver::solve<KinematicsProperty::FINAL_VELOCITY, KinematicsProperty::TIME>(v_i,a,d)), error_bound);
+
+  ASSERT_NEAR(a, (KinematicsSolver::solve<KinematicsProperty::ACCELERATION, KinematicsProperty::INITIAL_VELOCITY>(v_f,d,t)), error_bound);
+  ASSERT_NEAR(a, (KinematicsSolver::solve<KinematicsProperty::ACCELERATION, KinematicsProperty::FINAL_VELOCITY>(v_i,d,t)), error_bound);
+  ASSERT_NEAR(a, (KinematicsSolver::solve<KinematicsProperty::ACCELERATION, KinematicsProperty::DISTANCE>(v_i,v_f,t)), error_bound);
+  ASSERT_NEAR(a, (KinematicsSolver::solve<KinematicsProperty::ACCELERATION, KinematicsProperty::TIME>(v_i,v_f,d)), error_bound);
+
+  ASSERT_NEAR(d, (KinematicsSolver::solve<KinematicsProperty::DISTANCE, KinematicsProperty::INITIAL_VELOCITY>(v_f,a,t)), error_bound);
+  ASSERT_NEAR(d, (KinematicsSolver::solve<KinematicsProperty::DISTANCE, KinematicsProperty::FINAL_VELOCITY>(v_i,a,t)), error_bound);
+  ASSERT_NEAR(d, (KinematicsSolver::solve<KinematicsProperty::DISTANCE, KinematicsProperty::ACCELERATION>(v_i,v_f,t)), error_bound);
+  ASSERT_NEAR(d, (KinematicsSolver::solve<KinematicsProperty::DISTANCE, KinematicsProperty::TIME>(v_i,v_f,a)), error_bound);
+
+  ASSERT_NEAR(t, (KinematicsSolver::solve<KinematicsProperty::TIME, KinematicsProperty::INITIAL_VELOCITY>(v_f,a,d)), error_bound);
+  ASSERT_NEAR(t, (KinematicsSolver::solve<KinematicsProperty::TIME, KinematicsProperty::FINAL_VELOCITY>(v_i,a,d)), error_bound);
+  ASSERT_NEAR(t, (KinematicsSolver::solve<KinematicsProperty::TIME, KinematicsProperty::ACCELERATION>(v_i,v_f,d)), error_bound);
+  ASSERT_NEAR(t, (KinematicsSolver::solve<KinematicsProperty::TIME, KinematicsProperty::DISTANCE>(v_i,v_f,a)), error_bound);
+
+  // Range checks are applied by default
+  const double bad_val = -4.0;
+  ASSERT_THROW((KinematicsSolver::solve<KinematicsProperty::DISTANCE, KinematicsProperty::FINAL_VELOCITY>(bad_val,a,t)), std::domain_error);
+  ASSERT_THROW((KinematicsSolver::solve<KinematicsProperty::TIME, KinematicsProperty::DISTANCE>(v_f,v_i,a)), std::domain_error);
+  ASSERT_THROW((KinematicsSolver::solve<KinematicsProperty::FINAL_VELOCITY, KinematicsProperty::TIME>(v_i,-a,1000.0)), std::domain_error);
+
+  // Disabled range checks evaluate the equation as is
+  ASSERT_NEAR(bad_val * t + 0.5 * a * t * t, (KinematicsSolver::solve<KinematicsProperty::DISTANCE, KinematicsProperty::FINAL_VELOCITY, false>(bad_val,a,t)), error_bound);
+  ASSERT_NEAR(-t, (KinematicsSolver::solve<KinematicsProperty::TIME, KinematicsProperty::DISTANCE, false>(v_f,v_i,a)), error_bound);
+  ASSERT_TRUE(std::isnan(KinematicsSolver::solve<KinematicsProperty::FINAL_VELOCITY, KinematicsProperty::TIME, false>(v_i,-a,1000.0)));
+}
+
+/**
+ * Tests the batched solve functions of the KinematicsSolver
+ */ 
+TEST(KinematicsSolver, solve_batch)
+{
+  const double error_bound = 0.0000001;
+
+  // Stopping distances for several speeds and decelerations. Find: d, Miss: t, Prop Order: v_i,v_f,a
+  std::vector<double> v_i = { 10.0, 20.0, 0.0, -5.0, 10.0, 10.0 };
+  std::vector<double> v_f = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+  std::vector<double> a = { -2.0, -4.0, 0.0, -2.0, 2.0, 0.0 };
+  std::vector<double> results;
+  std::vector<KinematicsError> errors;
+
+  ASSERT_EQ(3, KinematicsSolver::solve(KinematicsProperty::DISTANCE, KinematicsProperty::TIME, v_i, v_f, a, results, errors));
+  ASSERT_EQ(6, results.size());
+  ASSERT_EQ(6, errors.size());
+  ASSERT_NEAR(25.0, results[0], error_bound);
+  ASSERT_NEAR(50.0, results[1], error_bound);
+  ASSERT_EQ(KinematicsError::NONE, errors[0]);
+  ASSERT_EQ(KinematicsError::NONE, errors[1]);
+  ASSERT_EQ(KinematicsError::NONE, errors[2]);
+  ASSERT_EQ(KinematicsError::NEGATIVE_INPUT | KinematicsError::SIGN_MISMATCH, errors[3]);
+  ASSERT_TRUE(std::isnan(results[3]));
+  ASSERT_EQ(KinematicsError::SIGN_MISMATCH, errors[4]);
+  ASSERT_TRUE(std::isnan(results[4]));
+  ASSERT_EQ(KinematicsError::SIGN_MISMATCH, errors[5]);
+
+  // Each element matches the scalar form
+  for (size_t i = 0; i < 2; i++) {
+    ASSERT_NEAR(KinematicsSolver::solve(KinematicsProperty::DISTANCE, KinematicsProperty::TIME, v_i[i], v_f[i], a[i]), results[i], error_bound);
+  }
+
+  // Multiple errors on one element and the compile time form. Find: v_f, Miss: t, Prop Order: v_i,a,d
+  const double p1[] = { 3.0, -3.0, 3.0 };
+  const double p2[] = { 2.0, -10.0, -10.0 };
+  const double p3[] = { 4.0, -1.0, 1.0 };
+  double out[3];
+  KinematicsError out_errors[3];
+  KinematicsSolver::solve<KinematicsProperty::FINAL_VELOCITY, KinematicsProperty::TIME>(p1, p2, p3, 3, out, out_errors);
+  ASSERT_NEAR(5.0, out[0], error_bound);
+  ASSERT_EQ(KinematicsError::NONE, out_errors[0]);
+  ASSERT_EQ(KinematicsError::NEGATIVE_INPUT, out_errors[1]);
+  ASSERT_EQ(KinematicsError::DISCONTINUITY, out_errors[2]);
+  ASSERT_TRUE(std::isnan(out[2]));
+
+  // Solving in place
+  double in_place[] = { 3.0, 4.0 };
+  const double zeros[] = { 0.0, 0.0 };
+  const double times[] = { 2.0, 2.0 };
+  KinematicsSolver::solve(KinematicsProperty::DISTANCE, KinematicsProperty::ACCELERATION, in_place, zeros, times, 2, in_place, out_errors);
+  ASSERT_NEAR(3.0, in_place[0], error_bound);
+  ASSERT_NEAR(4.0, in_place[1], error_bound);
+
+  // Unsupported combinations are reported per element instead of asserting
+  KinematicsSolver::solve(KinematicsProperty::TIME, KinematicsProperty::TIME, p1, p2, p3, 3, out, out_errors);
+  for (size_t i = 0; i < 3; i++) {
+    ASSERT_EQ(KinematicsError::UNSUPPORTED_COMBINATION, out_errors[i]);
+    ASSERT_TRUE(std::isnan(out[i]));
+  }
+
+  std::ostringstream stream;
+  stream << (KinematicsError::NEGATIVE_INPUT | KinematicsError::DISCONTINUITY);
+  ASSERT_EQ("NEGATIVE_INPUT|DISCONTINUITY", stream.str());
+
+  v_f.pop_back();
+  ASSERT_THROW(KinematicsSolver::solve(KinematicsProperty::DISTANCE, KinematicsProperty::TIME, v_i, v_f, a, results, errors), std::invalid_argument);
+}
+
+/**
+ * Tests the non-throwing trySolve functions of the KinematicsSolver
+ */ 
+TEST(KinematicsSolver, try_solve)
+{
+  // Values 
+  const double d = 43.6;
+  const double a = 2.5;
+  const double t = 2.4;
+  const double v_i = 15.16666666;
+  const double v_f = 21.16666666;
+  const double error_bound = 0.0000001;
+
+  // Valid inputs match solve
+  KinematicsResult result = KinematicsSolver::trySolve(KinematicsProperty::TIME, KinematicsProperty::FINAL_VELOCITY, v_i,a,d);
+  ASSERT_TRUE(result.ok());
+  ASSERT_NEAR(t, result.value, error_bound);
+  result = KinematicsSolver::trySolve<KinematicsProperty::DISTANCE, KinematicsProperty::TIME>(v_i,v_f,a);
+  ASSERT_TRUE(result.ok());
+  ASSERT_NEAR(d, result.value, error_bound);
+
+  // Negative input
+  const double bad_val = -4.0;
+  result = KinematicsSolver::trySolve(KinematicsProperty::INITIAL_VELOCITY, KinematicsProperty::FINAL_VELOCITY, a,bad_val,t);
+  ASSERT_FALSE(result.ok());
+  ASSERT_EQ(KinematicsError::NEGATIVE_INPUT, result.error);
+  ASSERT_TRUE(std::isnan(result.value));
+
+  // Discontinuity
+  result = KinematicsSolver::trySolve(KinematicsProperty::TIME, KinematicsProperty::INITIAL_VELOCITY, 1.0,a,d);
+  ASSERT_EQ(KinematicsError::DISCONTINUITY, result.error);
+  ASSERT_TRUE(std::isnan(result.value));
+
+  // Sign mismatch
+  result = KinematicsSolver::trySolve(KinematicsProperty::TIME, KinematicsProperty::DISTANCE, v_f,v_i,a);
+  ASSERT_EQ(KinematicsError::SIGN_MISMATCH, result.error);
+  result = KinematicsSolver::trySolve<KinematicsProperty::DISTANCE, KinematicsProperty::TIME>(v_i,v_f,0.0);
+  ASSERT_EQ(KinematicsError::SIGN_MISMATCH, result.error);
+
+  // Unsupported combination
+  result = KinematicsSolver::trySolve(KinematicsProperty::DISTANCE, KinematicsProperty::DISTANCE, v_i,v_f,a);
+  ASSERT_EQ(KinematicsError::UNSUPPORTED_COMBINATION, result.error);
+  ASSERT_TRUE(std::isnan(result.value));
+
+  // Every case which throws from solve fails with trySolve
+  const KinematicsProperty props[] = { KinematicsProperty::INITIAL_VELOCITY, KinematicsProperty::FINAL_VELOCITY,
+    KinematicsProperty::ACCELERATION, KinematicsProperty::DISTANCE, KinematicsProperty::TIME };
+  const double values[] = { -3.0, 0.0, 1.5, 40.0 };
+  for (const KinematicsProperty& out : props) {
+    for (const KinematicsProperty& unavailable : props) {
+      if (out == unavailable) {
+        continue;
+      }
+      for (double p1 : values) {
+        for (double p2 : values) {
+          for (double p3 : values) {
+            result = KinematicsSolver::trySolve(out, unavailable, p1, p2, p3);
+            bool threw = false;
+            double value = 0.0;
+            try {
+              value = KinematicsSolver::solve(out, unavailable, p1, p2, p3);
+            } catch (const std::domain_error&) {
+              threw = true;
+            }
+            ASSERT_EQ(threw, !result.ok()) << out << " " << unavailable << " " << p1 << " " << p2 << " " << p3;
+            if (!threw && !std::isnan(value)) {
+              ASSERT_EQ(value, result.value);
+            }
+          }
+        }
+      }
+    }
+  }
+}
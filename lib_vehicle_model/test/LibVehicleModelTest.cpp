@@ -14,13 +14,23 @@
  * the License.
  */
 
+#include <new>
+#include <atomic>
+#include <cstdlib>
 #include <memory>
+#include <thread>
+#include <limits>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "lib_vehicle_model/LibVehicleModel.h"
 #include "lib_vehicle_model/VehicleState.h"
 #include "lib_vehicle_model/ParameterServer.h"
 #include "lib_vehicle_model/ModelAccessException.h"
+#include "lib_vehicle_model/MotionPrimitiveLibrary.h"
+#include "lib_vehicle_model/GoalPoseIndex.h"
 
 /**
  * This file unit tests the ConstraintChecker checker class
@@ -34,6 +44,39 @@ using ::testing::Invoke;
 using ::testing::Return;
 using ::testing::Unused;
 
+/**
+ * Replacements of the global allocation functions which count every allocation made by the test process.
+ * Used to check that the real-time prediction path does not allocate memory
+ */
+namespace {
+  std::atomic<uint64_t> allocation_count_(0);
+
+  // Returns the VmLck value of the process in kB or -1 if it could not be read
+  long lockedMemoryKb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+      if (line.compare(0, 6, "VmLck:") == 0) {
+        return std::strtol(line.c_str() + 6, nullptr, 10);
+      }
+    }
+    return -1;
+  }
+}
+
+void* operator new(std::size_t size) {
+  allocation_count_++;
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
 class MockParamServer : public ParameterServer {
   public:
     MOCK_METHOD2(getParam, bool(const std::string& param_key, std::string& output));
@@ -59,6 +102,21 @@ ACTION_P(set_string, val)
   arg1 = val;
 }
 
+ACTION_P(set_int, val)
+{
+  arg1 = val;
+}
+
+ACTION_P(set_int_vector, val)
+{
+  arg1 = val;
+}
+
+ACTION_P(set_bool, val)
+{
+  arg1 = val;
+}
+
 
 /**
  * Tests the init function of the lib_vehicle_model namespace
@@ -225,3 +283,1241 @@ TEST(lib_vehicle_model, predict_with_control)
   // Ref 1 - Test function scope
   ASSERT_EQ(1, mock_param_server.use_count());
 }
+
+
+/**
+ * Tests the predictReduced functions of the lib_vehicle_model namespace
+ */ 
+TEST(lib_vehicle_model, predict_reduced)
+{
+
+  // Setup param server
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  std::string path = std::string("test_libs/unittest_vehicle_model_shared_lib.so");
+
+  EXPECT_CALL(*mock_param_server, getParam("vehicle_model_lib_path", A<std::string&>()))
+    .WillRepeatedly(DoAll(set_string(path), Return(true))
+  ); 
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  // Param for model to be loaded
+  EXPECT_CALL(*mock_param_server, getParam("example_param", A<double&>())).WillOnce(DoAll(set_double(0.0), Return(true)));
+  
+  VehicleState vs; // All values default to 0
+  VehicleControlInput ci; // All values default to 0
+  std::vector<VehicleControlInput> inputs;
+  inputs.push_back(ci);
+  inputs.push_back(ci);
+
+  // Test predict functions exception before model load
+  ASSERT_THROW(lib_vehicle_model::predictReduced(vs, 0.1, 1.0), lib_vehicle_model::ModelAccessException);
+  ASSERT_THROW(lib_vehicle_model::predictReduced(vs, inputs, 0.1), lib_vehicle_model::ModelAccessException);
+
+  // Try loading a valid model
+  ASSERT_NO_THROW(lib_vehicle_model::init(mock_param_server));
+
+  // Test that the constraint checker is called
+  ASSERT_THROW(lib_vehicle_model::predictReduced(vs, 1.0, 0.1), std::invalid_argument);
+  vs.trailer_angle = -300.0;
+  ASSERT_THROW(lib_vehicle_model::predictReduced(vs, 0.1, 1.0), std::invalid_argument);
+  ASSERT_THROW(lib_vehicle_model::predictReduced(vs, inputs, 0.1), std::invalid_argument);
+  vs.trailer_angle = 0.0;
+
+  // Test valid calls. The mock model relies on the default conversion from the full predict functions
+  std::vector<ReducedVehicleState> result = lib_vehicle_model::predictReduced(vs, 0.1, 1.0);
+  ASSERT_EQ(1, result.size());
+  ASSERT_NEAR(5.0, result[0].X_pos_global, 0.0000001);
+
+  result = lib_vehicle_model::predictReduced(vs, inputs, 0.1);
+  ASSERT_EQ(1, result.size());
+  ASSERT_NEAR(5.0, result[0].X_pos_global, 0.0000001);
+  
+  // Unload the vehicle model so we can run more tests
+  unload();
+  ASSERT_EQ(1, mock_param_server.use_count());
+}
+
+/**
+ * Tests the output_stride predict functions of the lib_vehicle_model
+ */ 
+TEST(lib_vehicle_model, predict_output_stride)
+{
+
+  // Setup param server
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  std::string path = std::string("test_libs/unittest_vehicle_model_shared_lib.so");
+
+  EXPECT_CALL(*mock_param_server, getParam("vehicle_model_lib_path", A<std::string&>()))
+    .WillRepeatedly(DoAll(set_string(path), Return(true))
+  ); 
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  // Param for model to be loaded
+  EXPECT_CALL(*mock_param_server, getParam("example_param", A<double&>())).WillOnce(DoAll(set_double(0.0), Return(true)));
+  
+  VehicleState vs; // All values default to 0
+  VehicleControlInput ci; // All values default to 0
+  std::vector<VehicleControlInput> inputs;
+  inputs.push_back(ci);
+  inputs.push_back(ci);
+
+  // Test predict functions exception before model load
+  ASSERT_THROW(lib_vehicle_model::predict(vs, 0.1, 1.0, 2), lib_vehicle_model::ModelAccessException);
+  ASSERT_THROW(lib_vehicle_model::predict(vs, inputs, 0.1, 2), lib_vehicle_model::ModelAccessException);
+
+  // Try loading a valid model
+  ASSERT_NO_THROW(lib_vehicle_model::init(mock_param_server));
+
+  // A stride of 0 is rejected
+  ASSERT_THROW(lib_vehicle_model::predict(vs, 0.1, 1.0, 0), std::invalid_argument);
+  ASSERT_THROW(lib_vehicle_model::predict(vs, inputs, 0.1, 0), std::invalid_argument);
+
+  // Test that the constraint checker is called
+  ASSERT_THROW(lib_vehicle_model::predict(vs, 1.0, 0.1, 2), std::invalid_argument);
+  vs.trailer_angle = -300.0;
+  ASSERT_THROW(lib_vehicle_model::predict(vs, 0.1, 1.0, 2), std::invalid_argument);
+  ASSERT_THROW(lib_vehicle_model::predict(vs, inputs, 0.1, 2), std::invalid_argument);
+  vs.trailer_angle = 0.0;
+
+  // Test valid calls. The mock model relies on the default decimation of the full predict functions which always keeps the final state
+  std::vector<VehicleState> result = lib_vehicle_model::predict(vs, 0.1, 1.0, 2);
+  ASSERT_EQ(1, result.size());
+  ASSERT_NEAR(5.0, result[0].X_pos_global, 0.0000001);
+
+  result = lib_vehicle_model::predict(vs, inputs, 0.1, 2);
+  ASSERT_EQ(1, result.size());
+  ASSERT_NEAR(5.0, result[0].X_pos_global, 0.0000001);
+  
+  // Unload the vehicle model so we can run more tests
+  unload();
+  ASSERT_EQ(1, mock_param_server.use_count());
+}
+
+/**
+ * Tests the predictStep and predictLazy functions of the lib_vehicle_model
+ */ 
+TEST(lib_vehicle_model, predict_lazy)
+{
+
+  // Setup param server
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  std::string path = std::string("test_libs/unittest_vehicle_model_shared_lib.so");
+
+  EXPECT_CALL(*mock_param_server, getParam("vehicle_model_lib_path", A<std::string&>()))
+    .WillRepeatedly(DoAll(set_string(path), Return(true))
+  ); 
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  // Param for model to be loaded
+  EXPECT_CALL(*mock_param_server, getParam("example_param", A<double&>())).WillOnce(DoAll(set_double(0.0), Return(true)));
+  
+  VehicleState vs; // All values default to 0
+  VehicleControlInput ci; // All values default to 0
+  std::vector<VehicleControlInput> inputs;
+  inputs.push_back(ci);
+  inputs.push_back(ci);
+
+  // Test predict functions exception before model load
+  ASSERT_THROW(lib_vehicle_model::predictStep(vs, ci, 0.1), lib_vehicle_model::ModelAccessException);
+  ASSERT_THROW(lib_vehicle_model::predictLazy(vs, inputs, 0.1), lib_vehicle_model::ModelAccessException);
+
+  // Try loading a valid model
+  ASSERT_NO_THROW(lib_vehicle_model::init(mock_param_server));
+
+  // Test that the constraint checker is called
+  vs.trailer_angle = -300.0;
+  ASSERT_THROW(lib_vehicle_model::predictStep(vs, ci, 0.1), std::invalid_argument);
+  ASSERT_THROW(lib_vehicle_model::predictLazy(vs, inputs, 0.1), std::invalid_argument);
+  vs.trailer_angle = 0.0;
+
+  // Test valid calls. The mock model relies on the default single step adapter
+  VehicleState result = lib_vehicle_model::predictStep(vs, ci, 0.1);
+  ASSERT_NEAR(5.0, result.X_pos_global, 0.0000001);
+
+  TrajectoryRange range = lib_vehicle_model::predictLazy(vs, inputs, 0.1);
+  size_t count = 0;
+  for (const VehicleState& state : range) {
+    count++;
+    ASSERT_NEAR(5.0 * count, state.X_pos_global, 0.0000001); // Each step of the mock model advances x by 5
+  }
+  ASSERT_EQ(inputs.size(), count);
+
+  // Advancing a range after the model is unloaded is an error
+  auto it = range.begin();
+  unload();
+  ASSERT_THROW(++it, lib_vehicle_model::ModelAccessException);
+  ASSERT_EQ(1, mock_param_server.use_count());
+}
+
+/**
+ * Tests that the lib_vehicle_model uses a separate clone of the loaded model for each thread
+ */ 
+TEST(lib_vehicle_model, per_thread_models)
+{
+
+  // Setup param server
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  std::string path = std::string("test_libs/unittest_vehicle_model_shared_lib.so");
+
+  EXPECT_CALL(*mock_param_server, getParam("vehicle_model_lib_path", A<std::string&>()))
+    .WillRepeatedly(DoAll(set_string(path), Return(true))
+  ); 
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  // Param for model to be loaded
+  EXPECT_CALL(*mock_param_server, getParam("example_param", A<double&>())).WillOnce(DoAll(set_double(0.0), Return(true)));
+  
+  VehicleState vs; // All values default to 0
+  VehicleControlInput ci; // All values default to 0
+  std::vector<VehicleControlInput> inputs;
+  inputs.push_back(ci);
+  inputs.push_back(ci);
+
+  // Try loading a valid model
+  ASSERT_NO_THROW(lib_vehicle_model::init(mock_param_server));
+  const long loaded_use_count = mock_param_server.use_count();
+
+  // Each predicting thread gets its own clone of the mock model. Each clone holds a copy of the parameter server pointer
+  std::vector<std::thread> threads;
+  std::vector<double> results(3, 0.0);
+  std::atomic<size_t> ready(0);
+  std::atomic<bool> release(false);
+  for (size_t i = 0; i < results.size(); i++) {
+    threads.push_back(std::thread([&results, &vs, &inputs, &ready, &release, i]() {
+      for (int j = 0; j < 10; j++) {
+        results[i] = lib_vehicle_model::predict(vs, inputs, 0.1)[0].X_pos_global;
+      }
+      ready++;
+      while (!release.load()) {
+        std::this_thread::yield();
+      }
+    }));
+  }
+  while (ready.load() < threads.size()) {
+    std::this_thread::yield();
+  }
+  ASSERT_EQ(loaded_use_count + 3, mock_param_server.use_count());
+
+  release.store(true);
+  for (std::thread& t : threads) {
+    t.join();
+  }
+
+  for (double x : results) {
+    ASSERT_NEAR(5.0, x, 0.0000001);
+  }
+
+  // Clones are released when their thread exits
+  ASSERT_EQ(loaded_use_count, mock_param_server.use_count());
+
+  // Short lived threads do not accumulate clones
+  for (int i = 0; i < 20; i++) {
+    std::thread([&vs, &inputs]() {
+      lib_vehicle_model::predict(vs, inputs, 0.1);
+    }).join();
+  }
+  ASSERT_EQ(loaded_use_count, mock_param_server.use_count());
+
+  // Repeated calls from the same thread reuse its clone
+  ASSERT_NEAR(5.0, lib_vehicle_model::predict(vs, 0.1, 1.0)[0].X_pos_global, 0.0000001);
+  ASSERT_NEAR(5.0, lib_vehicle_model::predict(vs, 0.1, 1.0)[0].X_pos_global, 0.0000001);
+  ASSERT_EQ(loaded_use_count + 1, mock_param_server.use_count());
+  
+  // Unloading releases all clones
+  unload();
+  ASSERT_EQ(1, mock_param_server.use_count());
+}
+
+/**
+ * Tests the prediction statistics recorded by the lib_vehicle_model
+ */ 
+TEST(lib_vehicle_model, prediction_statistics)
+{
+
+  // Setup param server
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  std::string path = std::string("test_libs/unittest_vehicle_model_shared_lib.so");
+
+  EXPECT_CALL(*mock_param_server, getParam("vehicle_model_lib_path", A<std::string&>()))
+    .WillRepeatedly(DoAll(set_string(path), Return(true))
+  ); 
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  // Param for model to be loaded
+  EXPECT_CALL(*mock_param_server, getParam("example_param", A<double&>())).WillOnce(DoAll(set_double(0.0), Return(true)));
+  
+  VehicleState vs; // All values default to 0
+  VehicleControlInput ci; // All values default to 0
+  std::vector<VehicleControlInput> inputs;
+  inputs.push_back(ci);
+  inputs.push_back(ci);
+
+  // Calls before load are not recorded
+  resetPredictionStatistics();
+  ASSERT_THROW(lib_vehicle_model::predict(vs, 0.1, 1.0), lib_vehicle_model::ModelAccessException);
+  ASSERT_EQ(0, getPredictionStatistics().totalCalls());
+
+  ASSERT_NO_THROW(lib_vehicle_model::init(mock_param_server));
+
+  // Valid calls
+  lib_vehicle_model::predict(vs, 0.1, 1.0);
+  lib_vehicle_model::predict(vs, inputs, 0.1);
+  lib_vehicle_model::predict(vs, inputs, 0.1);
+  lib_vehicle_model::predictReduced(vs, inputs, 0.1);
+  lib_vehicle_model::predictStep(vs, ci, 0.1);
+
+  // Invalid calls
+  ASSERT_THROW(lib_vehicle_model::predict(vs, 1.0, 0.1), std::invalid_argument);
+  ASSERT_THROW(lib_vehicle_model::predict(vs, inputs, 0.1, 0), std::invalid_argument);
+
+  // Calls from another thread are included
+  std::thread worker([&vs, &inputs]() {
+    lib_vehicle_model::predict(vs, inputs, 0.1);
+  });
+  worker.join();
+
+  PredictionStatistics stats = getPredictionStatistics();
+  ASSERT_EQ(8, stats.totalCalls());
+  ASSERT_EQ(2, stats.callCount(PredictCallType::PREDICT_NO_CONTROL));
+  ASSERT_EQ(3, stats.callCount(PredictCallType::PREDICT_WITH_CONTROL));
+  ASSERT_EQ(1, stats.callCount(PredictCallType::PREDICT_WITH_CONTROL_STRIDE));
+  ASSERT_EQ(1, stats.callCount(PredictCallType::PREDICT_REDUCED_WITH_CONTROL));
+  ASSERT_EQ(1, stats.callCount(PredictCallType::PREDICT_STEP));
+  ASSERT_EQ(0, stats.callCount(PredictCallType::PREDICT_LAZY));
+  ASSERT_EQ(2, stats.validation_failures);
+  ASSERT_EQ(0, stats.in_flight);
+
+  // Every validated call is in the histogram under its horizon bucket
+  uint64_t histogram_total = 0;
+  uint64_t horizon_totals[PredictionStatistics::HORIZON_BUCKET_COUNT] = {};
+  for (size_t h = 0; h < PredictionStatistics::HORIZON_BUCKET_COUNT; h++) {
+    for (size_t l = 0; l < PredictionStatistics::LATENCY_BUCKET_COUNT; l++) {
+      histogram_total += stats.latency_histogram[h][l];
+      horizon_totals[h] += stats.latency_histogram[h][l];
+    }
+  }
+  ASSERT_EQ(6, histogram_total);
+  ASSERT_EQ(1, horizon_totals[0]); // predictStep
+  ASSERT_EQ(4, horizon_totals[1]); // 2 control inputs
+  ASSERT_EQ(1, horizon_totals[3]); // 10 steps without control inputs
+
+  // Reset clears the counts
+  resetPredictionStatistics();
+  stats = getPredictionStatistics();
+  ASSERT_EQ(0, stats.totalCalls());
+  ASSERT_EQ(0, stats.validation_failures);
+  lib_vehicle_model::predict(vs, inputs, 0.1);
+  ASSERT_EQ(1, getPredictionStatistics().callCount(PredictCallType::PREDICT_WITH_CONTROL));
+
+  // Bucket helpers
+  ASSERT_EQ(0, PredictionStatistics::horizonBucket(0));
+  ASSERT_EQ(0, PredictionStatistics::horizonBucket(1));
+  ASSERT_EQ(1, PredictionStatistics::horizonBucket(3));
+  ASSERT_EQ(6, PredictionStatistics::horizonBucket(100));
+  ASSERT_EQ(PredictionStatistics::HORIZON_BUCKET_COUNT - 1, PredictionStatistics::horizonBucket(1000000));
+  ASSERT_EQ(0, PredictionStatistics::latencyBucket(999));
+  ASSERT_EQ(1, PredictionStatistics::latencyBucket(1000));
+  ASSERT_EQ(11, PredictionStatistics::latencyBucket(1500000));
+  ASSERT_EQ(PredictionStatistics::LATENCY_BUCKET_COUNT - 1, PredictionStatistics::latencyBucket(UINT64_MAX));
+
+  unload();
+  ASSERT_EQ(1, mock_param_server.use_count());
+}
+
+/**
+ * Tests the optional warm-up run by the init function of the lib_vehicle_model
+ */ 
+TEST(lib_vehicle_model, warm_up)
+{
+
+  // Setup param server
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  std::string path = std::string("test_libs/unittest_vehicle_model_shared_lib.so");
+
+  EXPECT_CALL(*mock_param_server, getParam("vehicle_model_lib_path", A<std::string&>()))
+    .WillRepeatedly(DoAll(set_string(path), Return(true))
+  ); 
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  // Param for model to be loaded
+  EXPECT_CALL(*mock_param_server, getParam("example_param", A<double&>())).WillRepeatedly(DoAll(set_double(0.0), Return(true)));
+
+  // Warm-up params
+  std::vector<int> invalid_horizons = {10, 0};
+  std::vector<int> horizons = {10, 50};
+  EXPECT_CALL(*mock_param_server, getParam("warm_up_horizons", A<std::vector<int>&>()))
+    .WillOnce(DoAll(set_int_vector(invalid_horizons), Return(true)))
+    .WillOnce(DoAll(set_int_vector(horizons), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("warm_up_timestep", A<double&>())).WillRepeatedly(DoAll(set_double(0.1), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("warm_up_iterations", A<int&>())).WillRepeatedly(DoAll(set_int(2), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("real_time_max_horizon", A<int&>())).WillRepeatedly(Return(false));
+
+  // Invalid warm-up horizons are rejected
+  ASSERT_THROW(lib_vehicle_model::init(mock_param_server), std::invalid_argument);
+
+  resetPredictionStatistics();
+  ASSERT_NO_THROW(lib_vehicle_model::init(mock_param_server));
+
+  // The warm-up is timed and is not included in the prediction statistics
+  ASSERT_GT(getWarmUpDuration(), 0.0);
+  ASSERT_EQ(0, getPredictionStatistics().totalCalls());
+
+  // The model is usable after warm-up
+  VehicleState vs;
+  ASSERT_NEAR(5.0, lib_vehicle_model::predict(vs, 0.1, 1.0)[0].X_pos_global, 0.0000001);
+
+  unload();
+  ASSERT_EQ(1, mock_param_server.use_count());
+}
+
+/**
+ * Tests the real-time prediction mode of the lib_vehicle_model
+ */ 
+TEST(lib_vehicle_model, predict_real_time)
+{
+
+  // Setup param server
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  std::string path = std::string("test_libs/unittest_vehicle_model_shared_lib.so");
+
+  EXPECT_CALL(*mock_param_server, getParam("vehicle_model_lib_path", A<std::string&>()))
+    .WillRepeatedly(DoAll(set_string(path), Return(true))
+  ); 
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  // Param for model to be loaded
+  EXPECT_CALL(*mock_param_server, getParam("example_param", A<double&>())).WillRepeatedly(DoAll(set_double(0.0), Return(true)));
+
+  // Real-time params
+  EXPECT_CALL(*mock_param_server, getParam("real_time_max_horizon", A<int&>()))
+    .WillOnce(DoAll(set_int(0), Return(true)))
+    .WillRepeatedly(DoAll(set_int(20), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("real_time_lock_memory", A<bool&>())).WillRepeatedly(DoAll(set_bool(false), Return(true)));
+
+  VehicleState vs;
+  std::vector<VehicleControlInput> control_inputs(10);
+  std::vector<VehicleState> output(20);
+
+  // Try predicting before the model is loaded
+  ASSERT_EQ(PredictStatus::MODEL_NOT_LOADED, predictRealTime(vs, control_inputs.data(), control_inputs.size(), 0.1, output.data()));
+  ASSERT_THROW(prepareRealTimeThread(), ModelAccessException);
+
+  // An invalid max horizon is rejected
+  ASSERT_THROW(lib_vehicle_model::init(mock_param_server), std::invalid_argument);
+  ASSERT_NO_THROW(lib_vehicle_model::init(mock_param_server));
+
+  // The initializing thread is prepared by init
+  ASSERT_EQ(PredictStatus::SUCCESS, predictRealTime(vs, control_inputs.data(), control_inputs.size(), 0.1, output.data()));
+  ASSERT_NEAR(5.0, output[0].X_pos_global, 0.0000001);
+  ASSERT_NEAR(50.0, output[9].X_pos_global, 0.0000001);
+
+  // Invalid inputs are reported without throwing
+  std::vector<VehicleControlInput> long_control_inputs(21);
+  ASSERT_EQ(PredictStatus::HORIZON_TOO_LONG, predictRealTime(vs, long_control_inputs.data(), long_control_inputs.size(), 0.1, output.data()));
+  ASSERT_EQ(PredictStatus::INVALID_INPUT, predictRealTime(vs, control_inputs.data(), 0, 0.1, output.data()));
+
+  control_inputs[3].target_velocity = 11.0;
+  ASSERT_EQ(PredictStatus::INVALID_INPUT, predictRealTime(vs, control_inputs.data(), control_inputs.size(), 0.1, output.data()));
+  control_inputs[3].target_velocity = 0.0;
+
+  // Other threads must be prepared before making real-time predictions
+  PredictStatus unprepared_status = PredictStatus::SUCCESS;
+  PredictStatus prepared_status = PredictStatus::MODEL_FAILURE;
+  bool real_time_safe = false;
+  std::thread worker([&]() {
+    std::vector<VehicleState> worker_output(control_inputs.size());
+    unprepared_status = predictRealTime(vs, control_inputs.data(), control_inputs.size(), 0.1, worker_output.data());
+    real_time_safe = prepareRealTimeThread();
+    prepared_status = predictRealTime(vs, control_inputs.data(), control_inputs.size(), 0.1, worker_output.data());
+  });
+  worker.join();
+
+  ASSERT_EQ(PredictStatus::THREAD_NOT_PREPARED, unprepared_status);
+  ASSERT_EQ(PredictStatus::SUCCESS, prepared_status);
+  ASSERT_TRUE(real_time_safe);
+
+  // A prepared thread does not allocate any memory
+  const size_t iterations = 100;
+  PredictStatus statuses[iterations];
+  const uint64_t allocations = allocation_count_.load();
+  for (size_t i = 0; i < iterations; i++) {
+    statuses[i] = predictRealTime(vs, control_inputs.data(), control_inputs.size(), 0.1, output.data());
+  }
+  ASSERT_EQ(allocations, allocation_count_.load());
+
+  for (size_t i = 0; i < iterations; i++) {
+    ASSERT_EQ(PredictStatus::SUCCESS, statuses[i]);
+  }
+
+  // Real-time calls are included in the prediction statistics
+  ASSERT_LE(iterations, getPredictionStatistics().callCount(PredictCallType::PREDICT_REAL_TIME));
+
+  unload();
+  ASSERT_EQ(PredictStatus::MODEL_NOT_LOADED, predictRealTime(vs, control_inputs.data(), control_inputs.size(), 0.1, output.data()));
+  ASSERT_EQ(1, mock_param_server.use_count());
+}
+
+/**
+ * Tests that a failed init with real_time_lock_memory set does not leave the process memory locked
+ */
+TEST(lib_vehicle_model, lock_memory_failed_init)
+{
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  std::string path = std::string("test_libs/fake_file_path.so");
+
+  EXPECT_CALL(*mock_param_server, getParam("vehicle_model_lib_path", A<std::string&>()))
+    .WillRepeatedly(DoAll(set_string(path), Return(true))
+  ); 
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  // Real-time params
+  EXPECT_CALL(*mock_param_server, getParam("real_time_max_horizon", A<int&>())).WillRepeatedly(DoAll(set_int(20), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("real_time_lock_memory", A<bool&>())).WillRepeatedly(DoAll(set_bool(true), Return(true)));
+
+  const long locked_before = lockedMemoryKb();
+
+  // The model library does not exist so init fails before any memory is locked
+  ASSERT_THROW(lib_vehicle_model::init(mock_param_server), std::invalid_argument);
+  ASSERT_EQ(locked_before, lockedMemoryKb());
+  ASSERT_THROW(lib_vehicle_model::predict(VehicleState(), 0.1, 1.0), lib_vehicle_model::ModelAccessException);
+}
+
+/**
+ * Tests the predict functions of the lib_vehicle_model which allocate from a memory resource
+ */ 
+TEST(lib_vehicle_model, predict_memory_resource)
+{
+
+  // Setup param server
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  std::string path = std::string("test_libs/unittest_vehicle_model_shared_lib.so");
+
+  EXPECT_CALL(*mock_param_server, getParam("vehicle_model_lib_path", A<std::string&>()))
+    .WillRepeatedly(DoAll(set_string(path), Return(true))
+  ); 
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  // Param for model to be loaded
+  EXPECT_CALL(*mock_param_server, getParam("example_param", A<double&>())).WillRepeatedly(DoAll(set_double(0.0), Return(true)));
+
+  MonotonicBufferResource arena(1 << 16); // Large enough for every prediction of this test
+  VehicleState vs;
+  std::vector<VehicleControlInput> control_inputs(10);
+
+  // Try predicting before the model is loaded
+  ASSERT_THROW(lib_vehicle_model::predict(vs, control_inputs, 0.1, arena), lib_vehicle_model::ModelAccessException);
+
+  ASSERT_NO_THROW(lib_vehicle_model::init(mock_param_server));
+
+  // Inputs are validated as with the other predict functions
+  ASSERT_THROW(lib_vehicle_model::predict(vs, 0.5, 0.1, arena), std::invalid_argument);
+  control_inputs[3].target_velocity = 11.0;
+  ASSERT_THROW(lib_vehicle_model::predict(vs, control_inputs, 0.1, arena), std::invalid_argument);
+  control_inputs[3].target_velocity = 0.0;
+
+  // The trajectory is allocated from the provided resource
+  ResourceVector<VehicleState> result = lib_vehicle_model::predict(vs, control_inputs, 0.1, arena);
+  ASSERT_EQ(&arena, result.get_allocator().resource());
+  ASSERT_EQ(10, result.size());
+  ASSERT_NEAR(5.0, result[0].X_pos_global, 0.0000001);
+  ASSERT_NEAR(50.0, result[9].X_pos_global, 0.0000001);
+
+  // A prediction without control inputs integrates delta_t / timestep steps
+  ResourceVector<VehicleState> no_control_result = lib_vehicle_model::predict(vs, 0.1, 1.0, arena);
+  ASSERT_EQ(&arena, no_control_result.get_allocator().resource());
+  ASSERT_EQ(10, no_control_result.size());
+  ASSERT_NEAR(50.0, no_control_result[9].X_pos_global, 0.0000001);
+
+  // Repeated predictions in the same cycle do not touch the global heap once the model instance exists
+  const uint64_t allocations = allocation_count_.load();
+  for (int i = 0; i < 10; i++) {
+    lib_vehicle_model::predict(vs, control_inputs, 0.1, arena);
+  }
+  ASSERT_EQ(allocations, allocation_count_.load());
+
+  unload();
+  ASSERT_EQ(1, mock_param_server.use_count());
+}
+
+/**
+ * Tests the predict (with control change points) function of the lib_vehicle_model namespace
+ */ 
+TEST(lib_vehicle_model, predict_control_changes)
+{
+
+  // Setup param server
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  std::string path = std::string("test_libs/unittest_vehicle_model_shared_lib.so");
+
+  EXPECT_CALL(*mock_param_server, getParam("vehicle_model_lib_path", A<std::string&>()))
+    .WillRepeatedly(DoAll(set_string(path), Return(true))
+  ); 
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  // Param for model to be loaded
+  EXPECT_CALL(*mock_param_server, getParam("example_param", A<double&>())).WillRepeatedly(DoAll(set_double(0.0), Return(true)));
+
+  VehicleState vs; // All values default to 0
+  std::vector<TimedControlInput> changes(2);
+  changes[1].time = 4.0;
+  changes[1].control.target_velocity = 5.0;
+
+  ASSERT_THROW(lib_vehicle_model::predict(vs, changes, 0.1, 8.0), lib_vehicle_model::ModelAccessException);
+
+  ASSERT_NO_THROW(lib_vehicle_model::init(mock_param_server));
+  resetPredictionStatistics();
+
+  // Test that the constraint checker is called for the initial state and change points
+  vs.trailer_angle = -300.0;
+  ASSERT_THROW(lib_vehicle_model::predict(vs, changes, 0.1, 8.0), std::invalid_argument);
+  vs.trailer_angle = 0.0;
+
+  changes[1].time = -1.0;
+  ASSERT_THROW(lib_vehicle_model::predict(vs, changes, 0.1, 8.0), std::invalid_argument);
+  changes[1].time = 4.0;
+
+  ASSERT_THROW(lib_vehicle_model::predict(vs, changes, 1.0, 0.5), std::invalid_argument);
+
+  // The mock model uses the default implementation which expands the change points into one control input per step
+  std::vector<VehicleState> result;
+  ASSERT_NO_THROW(result = lib_vehicle_model::predict(vs, changes, 0.1, 8.0));
+  ASSERT_EQ(1, result.size());
+  ASSERT_NEAR(5.0, result[0].X_pos_global, 0.0000001);
+
+  // Test the output_stride overload
+  ASSERT_THROW(lib_vehicle_model::predict(vs, changes, 0.1, 8.0, 0), std::invalid_argument);
+  ASSERT_NO_THROW(result = lib_vehicle_model::predict(vs, changes, 0.1, 8.0, 10));
+  ASSERT_EQ(1, result.size());
+  ASSERT_NEAR(5.0, result[0].X_pos_global, 0.0000001);
+
+  PredictionStatistics stats = getPredictionStatistics();
+  ASSERT_EQ(4, stats.callCount(PredictCallType::PREDICT_CONTROL_CHANGES));
+  ASSERT_EQ(2, stats.callCount(PredictCallType::PREDICT_CONTROL_CHANGES_STRIDE));
+  ASSERT_EQ(4, stats.validation_failures);
+
+  unload();
+  ASSERT_EQ(1, mock_param_server.use_count());
+}
+
+/**
+ * Tests the checkControlInputs function of the lib_vehicle_model namespace
+ */ 
+TEST(lib_vehicle_model, check_control_inputs)
+{
+
+  // Setup param server
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  std::string path = std::string("test_libs/unittest_vehicle_model_shared_lib.so");
+
+  EXPECT_CALL(*mock_param_server, getParam("vehicle_model_lib_path", A<std::string&>()))
+    .WillRepeatedly(DoAll(set_string(path), Return(true))
+  ); 
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  // Param for model to be loaded
+  EXPECT_CALL(*mock_param_server, getParam("example_param", A<double&>())).WillRepeatedly(DoAll(set_double(0.0), Return(true)));
+
+  VehicleState vs; // All values default to 0
+  std::vector<VehicleControlInput> inputs(2);
+  ControlViolationReport report;
+
+  ASSERT_THROW(lib_vehicle_model::checkControlInputs(vs, inputs, 0.1, report), lib_vehicle_model::ModelAccessException);
+
+  ASSERT_NO_THROW(lib_vehicle_model::init(mock_param_server));
+
+  ASSERT_TRUE(lib_vehicle_model::checkControlInputs(vs, inputs, 0.1, report));
+  ASSERT_TRUE(report.violations.empty());
+
+  inputs[0].target_velocity = 11.0;
+  inputs[1].target_velocity = -11.0;
+  ASSERT_FALSE(lib_vehicle_model::checkControlInputs(vs, inputs, 0.1, report));
+  ASSERT_EQ(2, report.violation_count);
+  ASSERT_EQ(ControlViolation::VELOCITY_ABOVE_MAX, report.violations[0]);
+  ASSERT_EQ(ControlViolation::VELOCITY_BELOW_MIN, report.violations[1]);
+
+  ASSERT_FALSE(lib_vehicle_model::checkControlInputs(vs, std::vector<VehicleControlInput>(), 0.1, report));
+
+  unload();
+  ASSERT_EQ(1, mock_param_server.use_count());
+}
+
+/**
+ * Tests the sanitizeControlInputs function of the lib_vehicle_model namespace
+ */ 
+TEST(lib_vehicle_model, sanitize_control_inputs)
+{
+
+  // Setup param server
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  std::string path = std::string("test_libs/unittest_vehicle_model_shared_lib.so");
+
+  EXPECT_CALL(*mock_param_server, getParam("vehicle_model_lib_path", A<std::string&>()))
+    .WillRepeatedly(DoAll(set_string(path), Return(true))
+  ); 
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  // Param for model to be loaded
+  EXPECT_CALL(*mock_param_server, getParam("example_param", A<double&>())).WillRepeatedly(DoAll(set_double(0.0), Return(true)));
+
+  VehicleState vs; // All values default to 0
+  std::vector<VehicleControlInput> inputs(2);
+  inputs[0].target_velocity = 25.0;
+  inputs[1].target_steering_angle = 50.0;
+  ControlViolationReport report;
+
+  ASSERT_THROW(lib_vehicle_model::sanitizeControlInputs(vs, inputs, 0.1, report), lib_vehicle_model::ModelAccessException);
+
+  ASSERT_NO_THROW(lib_vehicle_model::init(mock_param_server));
+
+  ASSERT_THROW(lib_vehicle_model::predict(vs, inputs, 0.1), std::invalid_argument);
+
+  std::vector<VehicleControlInput> sanitized = lib_vehicle_model::sanitizeControlInputs(vs, inputs, 0.1, report);
+  ASSERT_EQ(2, sanitized.size());
+  ASSERT_EQ(2, report.violation_count);
+  ASSERT_EQ(ControlViolation::VELOCITY_ABOVE_MAX, report.violations[0]);
+  ASSERT_EQ(ControlViolation::STEERING_RATE_ABOVE_MAX, report.violations[1]);
+  ASSERT_NEAR(10.0, sanitized[0].target_velocity, 0.0000001);
+  ASSERT_NEAR(9.0, sanitized[1].target_steering_angle, 0.0000001);
+  ASSERT_NO_THROW(lib_vehicle_model::predict(vs, sanitized, 0.1));
+
+  // The sanitizer cannot repair the initial state or an empty sequence
+  ASSERT_THROW(lib_vehicle_model::sanitizeControlInputs(vs, std::vector<VehicleControlInput>(), 0.1, report), std::invalid_argument);
+  ASSERT_THROW(lib_vehicle_model::sanitizeControlInputs(vs, inputs, 0.0, report), std::invalid_argument);
+  vs.trailer_angle = 200.0;
+  ASSERT_THROW(lib_vehicle_model::sanitizeControlInputs(vs, inputs, 0.1, report), std::invalid_argument);
+
+  unload();
+  ASSERT_EQ(1, mock_param_server.use_count());
+}
+
+/**
+ * Tests the checkControlBatch function of the lib_vehicle_model namespace
+ */ 
+TEST(lib_vehicle_model, check_control_batch)
+{
+
+  // Setup param server
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  std::string path = std::string("test_libs/unittest_vehicle_model_shared_lib.so");
+
+  EXPECT_CALL(*mock_param_server, getParam("vehicle_model_lib_path", A<std::string&>()))
+    .WillRepeatedly(DoAll(set_string(path), Return(true))
+  ); 
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  // Param for model to be loaded
+  EXPECT_CALL(*mock_param_server, getParam("example_param", A<double&>())).WillRepeatedly(DoAll(set_double(0.0), Return(true)));
+
+  // Two sequences of three controls
+  std::vector<double> velocities = { 1.0, 2.0, 3.0, 1.0, 12.0, 3.0 };
+  std::vector<double> steering(6, 0.0);
+  std::vector<double> initial_steering(2, 0.0);
+  std::vector<ControlViolation> results(2);
+
+  ControlBatch batch;
+  batch.target_velocities = velocities.data();
+  batch.target_steering_angles = steering.data();
+  batch.initial_steering_angles = initial_steering.data();
+  batch.sequence_count = 2;
+  batch.horizon = 3;
+
+  ASSERT_THROW(lib_vehicle_model::checkControlBatch(batch, 0.1, results.data()), lib_vehicle_model::ModelAccessException);
+
+  ASSERT_NO_THROW(lib_vehicle_model::init(mock_param_server));
+
+  ASSERT_EQ(1, lib_vehicle_model::checkControlBatch(batch, 0.1, results.data()));
+  ASSERT_EQ(ControlViolation::NONE, results[0]);
+  ASSERT_EQ(ControlViolation::VELOCITY_ABOVE_MAX, results[1]);
+
+  ASSERT_THROW(lib_vehicle_model::checkControlBatch(batch, 0.1, nullptr), std::invalid_argument);
+
+  // Empty sequences are rejected in the same way as an empty control list passed to predict
+  batch.horizon = 0;
+  ASSERT_THROW(lib_vehicle_model::checkControlBatch(batch, 0.1, results.data()), std::invalid_argument);
+  ASSERT_THROW(lib_vehicle_model::predict(VehicleState(), std::vector<VehicleControlInput>(), 0.1), std::invalid_argument);
+  batch.horizon = 3;
+
+  batch.target_steering_angles = nullptr;
+  ASSERT_THROW(lib_vehicle_model::checkControlBatch(batch, 0.1, results.data()), std::invalid_argument);
+  batch.sequence_count = 0;
+  ASSERT_EQ(0, lib_vehicle_model::checkControlBatch(batch, 0.1, nullptr));
+
+  unload();
+  ASSERT_EQ(1, mock_param_server.use_count());
+}
+
+/**
+ * Tests the validateControls function and the predict (with validated controls) function of the lib_vehicle_model namespace
+ */ 
+TEST(lib_vehicle_model, predict_validated_controls)
+{
+
+  // Setup param server
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  std::string path = std::string("test_libs/unittest_vehicle_model_shared_lib.so");
+
+  EXPECT_CALL(*mock_param_server, getParam("vehicle_model_lib_path", A<std::string&>()))
+    .WillRepeatedly(DoAll(set_string(path), Return(true))
+  ); 
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  // Param for model to be loaded
+  EXPECT_CALL(*mock_param_server, getParam("example_param", A<double&>())).WillRepeatedly(DoAll(set_double(0.0), Return(true)));
+
+  std::vector<VehicleControlInput> inputs(2);
+  inputs[0].target_steering_angle = 20.0;
+  inputs[1].target_steering_angle = 25.0;
+  inputs[1].target_velocity = 4.0;
+
+  ASSERT_THROW(lib_vehicle_model::validateControls(inputs, 0.1), lib_vehicle_model::ModelAccessException);
+
+  ASSERT_NO_THROW(lib_vehicle_model::init(mock_param_server));
+  resetPredictionStatistics();
+
+  // Invalid sequences are rejected when the token is created
+  std::vector<VehicleControlInput> bad_inputs(inputs);
+  bad_inputs[1].target_velocity = 20.0;
+  ASSERT_THROW(lib_vehicle_model::validateControls(bad_inputs, 0.1), std::invalid_argument);
+  ASSERT_THROW(lib_vehicle_model::validateControls(std::vector<VehicleControlInput>(), 0.1), std::invalid_argument);
+
+  ValidatedControls controls = lib_vehicle_model::validateControls(inputs, 0.1);
+  ASSERT_FALSE(controls.empty());
+  ASSERT_EQ(2, controls.getControlInputs().size());
+  ASSERT_NEAR(0.1, controls.getTimestep(), 0.0000001);
+  ASSERT_EQ(lib_vehicle_model::getParameterGeneration(), controls.getParameterGeneration());
+
+  // The same token is predicted from several initial states. Only the first steering rate depends on the initial state
+  for (double x = 0.0; x < 3.0; x += 1.0) {
+    VehicleState vs;
+    vs.X_pos_global = x;
+    vs.steering_angle = 18.0;
+    std::vector<VehicleState> result = lib_vehicle_model::predict(vs, controls);
+    ASSERT_EQ(1, result.size());
+    ASSERT_NEAR(x + 5.0, result[0].X_pos_global, 0.0000001);
+    ASSERT_NEAR(25.0, result[0].Y_pos_global, 0.0000001);
+    ASSERT_NEAR(4.0, result[0].longitudinal_vel, 0.0000001);
+  }
+
+  VehicleState vs; // Steering angle of 0 is too far from the first control
+  ASSERT_THROW(lib_vehicle_model::predict(vs, controls), std::invalid_argument);
+  vs.steering_angle = 18.0;
+  vs.trailer_angle = 200.0;
+  ASSERT_THROW(lib_vehicle_model::predict(vs, controls), std::invalid_argument);
+  vs.trailer_angle = 0.0;
+
+  ASSERT_THROW(lib_vehicle_model::predict(vs, ValidatedControls()), std::invalid_argument);
+
+  PredictionStatistics stats = getPredictionStatistics();
+  ASSERT_EQ(6, stats.callCount(PredictCallType::PREDICT_VALIDATED_CONTROLS));
+  ASSERT_EQ(3, stats.validation_failures);
+
+  // Reloading the model makes the token stale
+  unload();
+  ASSERT_THROW(lib_vehicle_model::predict(vs, controls), lib_vehicle_model::ModelAccessException);
+  ASSERT_NO_THROW(lib_vehicle_model::init(mock_param_server));
+  ASSERT_THROW(lib_vehicle_model::predict(vs, controls), std::invalid_argument);
+  ASSERT_NO_THROW(lib_vehicle_model::predict(vs, lib_vehicle_model::validateControls(inputs, 0.1)));
+
+  unload();
+  ASSERT_EQ(1, mock_param_server.use_count());
+}
+
+/**
+ * Tests building, querying, saving and loading a MotionPrimitiveLibrary
+ */ 
+TEST(lib_vehicle_model, motion_primitive_library)
+{
+
+  // Setup param server
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  std::string path = std::string("test_libs/unittest_vehicle_model_shared_lib.so");
+
+  EXPECT_CALL(*mock_param_server, getParam("vehicle_model_lib_path", A<std::string&>()))
+    .WillRepeatedly(DoAll(set_string(path), Return(true))
+  ); 
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  // Param for model to be loaded
+  EXPECT_CALL(*mock_param_server, getParam("example_param", A<double&>())).WillRepeatedly(DoAll(set_double(0.0), Return(true)));
+
+  MotionPrimitiveGrid grid;
+  grid.initial_speeds = {0.0, 5.0};
+  grid.initial_steering_angles = {0.0};
+  grid.control_sequences = {std::vector<VehicleControlInput>(3), std::vector<VehicleControlInput>(5)};
+
+  ASSERT_EQ(1, MotionPrimitiveLibrary::nearestIndex(grid.initial_speeds, 3.0));
+  ASSERT_EQ(0, MotionPrimitiveLibrary::nearestIndex(grid.initial_speeds, 2.5)); // Ties keep the first value
+  ASSERT_EQ(0, MotionPrimitiveLibrary::nearestIndex(std::vector<double>(), 1.0));
+
+  MotionPrimitiveLibrary library;
+  ASSERT_THROW(library.build(grid), lib_vehicle_model::ModelAccessException);
+  ASSERT_FALSE(library.isBuilt());
+  ASSERT_THROW(library.query(VehicleState(), 0), std::invalid_argument);
+
+  ASSERT_NO_THROW(lib_vehicle_model::init(mock_param_server));
+
+  // Invalid grids are rejected
+  MotionPrimitiveGrid empty_grid;
+  ASSERT_THROW(library.build(empty_grid), std::invalid_argument);
+
+  ASSERT_NO_THROW(library.build(grid));
+  ASSERT_TRUE(library.isBuilt());
+  ASSERT_FALSE(library.isStale());
+
+  // Primitives are integrated at the origin and transformed to the queried pose
+  size_t count = 0;
+  const VehicleState* canonical = library.getCanonicalPrimitive(1, 0, 1, count);
+  ASSERT_EQ(1, count); // The mock model returns a single state
+  ASSERT_NEAR(5.0, canonical[0].X_pos_global, 0.0000001);
+
+  VehicleState pose;
+  pose.X_pos_global = 10.0;
+  pose.Y_pos_global = 2.0;
+  pose.orientation = M_PI / 2.0;
+  pose.longitudinal_vel = 4.0; // Nearest grid speed is 5.0
+  std::vector<VehicleState> result = library.query(pose, 1);
+  ASSERT_EQ(1, result.size());
+  ASSERT_NEAR(10.0, result[0].X_pos_global, 0.0000001);
+  ASSERT_NEAR(7.0, result[0].Y_pos_global, 0.0000001);
+  ASSERT_NEAR(M_PI / 2.0, result[0].orientation, 0.0000001);
+
+  // The mock model is frame invariant so a query at any heading matches a direct prediction from that pose
+  VehicleState rotated_pose(pose);
+  rotated_pose.orientation = 0.7;
+  std::vector<VehicleState> direct = lib_vehicle_model::predict(rotated_pose, grid.control_sequences[1], 0.1);
+  result = library.query(rotated_pose, 1);
+  ASSERT_EQ(direct.size(), result.size());
+  ASSERT_NEAR(direct.back().X_pos_global, result.back().X_pos_global, 0.0000001);
+  ASSERT_NEAR(direct.back().Y_pos_global, result.back().Y_pos_global, 0.0000001);
+  ASSERT_NEAR(direct.back().orientation, result.back().orientation, 0.0000001);
+
+  ASSERT_THROW(library.query(pose, 2), std::invalid_argument);
+  ASSERT_THROW(library.query(pose, 2, 0, 0), std::invalid_argument);
+
+  // Save and load the library
+  const std::string file_path = "motion_primitive_library_test.txt";
+  ASSERT_NO_THROW(library.save(file_path));
+
+  MotionPrimitiveLibrary loaded;
+  ASSERT_NO_THROW(loaded.load(file_path));
+  ASSERT_FALSE(loaded.isStale());
+  ASSERT_EQ(0, loaded.getRebuildCount()); // Matches the loaded model so no rebuild was needed
+  ASSERT_EQ(2, loaded.getGrid().control_sequences.size());
+  ASSERT_EQ(5, loaded.getGrid().control_sequences[1].size());
+  result = loaded.query(pose, 1, 0, 1);
+  ASSERT_NEAR(10.0, result[0].X_pos_global, 0.0000001);
+  ASSERT_NEAR(7.0, result[0].Y_pos_global, 0.0000001);
+
+  // A file generated with different parameters is rebuilt
+  std::ifstream in_file(file_path.c_str());
+  std::stringstream contents;
+  contents << in_file.rdbuf();
+  in_file.close();
+  std::string text = contents.str();
+  const size_t primitives_pos = text.find("\nprimitives ") + 1;
+  const size_t first_state_pos = text.find("\n", text.find("\n", primitives_pos) + 1) + 1;
+  text.replace(first_state_pos, 1, "6");
+  std::ofstream out_file(file_path.c_str(), std::ios::out | std::ios::trunc);
+  out_file << text;
+  out_file.close();
+
+  MotionPrimitiveLibrary tampered;
+  ASSERT_NO_THROW(tampered.load(file_path));
+  ASSERT_EQ(1, tampered.getRebuildCount());
+  ASSERT_NEAR(5.0, tampered.getCanonicalPrimitive(0, 0, 0, count)[0].X_pos_global, 0.0000001);
+
+  // Differences in the other checked primitives are also detected, such as the last one of the grid
+  ASSERT_NO_THROW(library.save(file_path));
+  in_file.open(file_path.c_str());
+  contents.str("");
+  contents << in_file.rdbuf();
+  in_file.close();
+  text = contents.str();
+  const size_t last_state_pos = text.rfind("\n", text.size() - 2) + 1;
+  text.replace(last_state_pos, 1, "6");
+  out_file.open(file_path.c_str(), std::ios::out | std::ios::trunc);
+  out_file << text;
+  out_file.close();
+
+  MotionPrimitiveLibrary tampered_last;
+  ASSERT_NO_THROW(tampered_last.load(file_path));
+  ASSERT_EQ(1, tampered_last.getRebuildCount());
+  const VehicleState* last_primitive = tampered_last.getCanonicalPrimitive(1, 0, 1, count);
+  ASSERT_NEAR(5.0, last_primitive[count - 1].X_pos_global, 0.0000001);
+
+  // A malformed sequence length is rejected and the previously loaded library is kept
+  const size_t sequences_pos = text.find("\ncontrol_sequences ") + 1;
+  text = text.substr(0, text.find("\n", sequences_pos) + 1) + "not_a_length\n";
+  out_file.open(file_path.c_str(), std::ios::out | std::ios::trunc);
+  out_file << text;
+  out_file.close();
+
+  ASSERT_THROW(loaded.load(file_path), std::invalid_argument);
+  ASSERT_TRUE(loaded.isBuilt());
+  ASSERT_EQ(2, loaded.getGrid().control_sequences.size());
+  ASSERT_EQ(0, loaded.getRebuildCount());
+  std::remove(file_path.c_str());
+
+  ASSERT_THROW(loaded.load("/nonexistent_directory/primitives.txt"), std::invalid_argument);
+  ASSERT_THROW(library.save("/nonexistent_directory/primitives.txt"), std::invalid_argument);
+
+  // Loading a new model triggers a rebuild on the next query
+  unload();
+  ASSERT_TRUE(library.isStale());
+  ASSERT_NO_THROW(lib_vehicle_model::init(mock_param_server));
+  ASSERT_TRUE(library.isStale());
+  result = library.query(pose, 1);
+  ASSERT_EQ(1, library.getRebuildCount());
+  ASSERT_FALSE(library.isStale());
+  ASSERT_NEAR(7.0, result[0].Y_pos_global, 0.0000001);
+
+  unload();
+  ASSERT_EQ(1, mock_param_server.use_count());
+}
+
+/**
+ * Tests that a GoalPoseIndex returns the same control sequences as a brute force search
+ */ 
+TEST(lib_vehicle_model, goal_pose_index)
+{
+
+  // Setup param server
+  auto mock_param_server = std::make_shared<MockParamServer>();
+
+  std::string path = std::string("test_libs/unittest_vehicle_model_shared_lib.so");
+
+  EXPECT_CALL(*mock_param_server, getParam("vehicle_model_lib_path", A<std::string&>()))
+    .WillRepeatedly(DoAll(set_string(path), Return(true))
+  ); 
+
+  EXPECT_CALL(*mock_param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_double(-10.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_double(90.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(180.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_double(-180.0), Return(true)));
+
+  // Param for model to be loaded
+  EXPECT_CALL(*mock_param_server, getParam("example_param", A<double&>())).WillRepeatedly(DoAll(set_double(0.0), Return(true)));
+
+  ASSERT_THROW(GoalPoseIndex(-1.0, 1.0), std::invalid_argument);
+
+  GoalPoseIndex index;
+  MotionPrimitiveLibrary library;
+  ASSERT_THROW(index.build(library), std::invalid_argument);
+  ASSERT_THROW(index.findControls(VehicleState(), VehicleState()), std::invalid_argument);
+
+  ASSERT_NO_THROW(lib_vehicle_model::init(mock_param_server));
+
+  // The mock model ends each primitive at (5, final steering command) with the final velocity command
+  MotionPrimitiveGrid grid;
+  grid.initial_speeds = {0.0};
+  grid.initial_steering_angles = {0.0};
+  for (size_t i = 0; i < 60; i++) {
+    VehicleControlInput control;
+    control.target_steering_angle = -3.0 + (i * 37 % 60) * 0.1;
+    control.target_velocity = (i * 11 % 60) * 0.13;
+    grid.control_sequences.push_back(std::vector<VehicleControlInput>(2, control));
+  }
+  ASSERT_NO_THROW(library.build(grid));
+  ASSERT_NO_THROW(index.build(library));
+  ASSERT_TRUE(index.isBuilt());
+  ASSERT_FALSE(index.isStale());
+
+  VehicleState initial_state;
+  initial_state.X_pos_global = 1.0;
+  initial_state.Y_pos_global = 2.0;
+
+  for (size_t q = 0; q < 25; q++) {
+    VehicleState goal;
+    goal.X_pos_global = initial_state.X_pos_global + 4.0 + (q % 3);
+    goal.Y_pos_global = initial_state.Y_pos_global - 3.2 + q * 0.27;
+    goal.longitudinal_vel = (q * 7 % 25) * 0.3;
+
+    // Brute force over every primitive
+    size_t expected_sequence = 0;
+    double expected_distance = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < grid.control_sequences.size(); i++) {
+      const double dx = 5.0 + initial_state.X_pos_global - goal.X_pos_global;
+      const double dy = grid.control_sequences[i].back().target_steering_angle + initial_state.Y_pos_global - goal.Y_pos_global;
+      const double dv = grid.control_sequences[i].back().target_velocity - goal.longitudinal_vel;
+      const double d = sqrt(dx * dx + dy * dy + dv * dv);
+      if (d < expected_distance) {
+        expected_distance = d;
+        expected_sequence = i;
+      }
+    }
+
+    GoalPoseMatch match = index.findControls(initial_state, goal);
+    ASSERT_NEAR(expected_distance, match.distance, 0.0000001);
+    ASSERT_EQ(expected_sequence, match.sequence_index);
+    ASSERT_NEAR(6.0, match.end_state.X_pos_global, 0.0000001);
+
+    // The k nearest are sorted and start with the nearest
+    std::vector<GoalPoseMatch> nearest = index.findNearest(initial_state, goal, 4);
+    ASSERT_EQ(4, nearest.size());
+    ASSERT_EQ(expected_sequence, nearest[0].sequence_index);
+    for (size_t i = 1; i < nearest.size(); i++) {
+      ASSERT_LE(nearest[i - 1].distance, nearest[i].distance);
+    }
+
+    // Refinement rolls out the candidates with the loaded model
+    GoalPoseMatch refined = index.findControls(initial_state, goal, 3);
+    ASSERT_EQ(expected_sequence, refined.sequence_index);
+    ASSERT_NEAR(expected_distance, refined.distance, 0.0000001);
+  }
+
+  // Goals predicted directly from a rotated initial state are matched exactly
+  VehicleState rotated_state(initial_state);
+  rotated_state.orientation = 1.1;
+  for (size_t k : {3, 42}) {
+    VehicleState goal = lib_vehicle_model::predict(rotated_state, grid.control_sequences[k], 0.1).back();
+    GoalPoseMatch match = index.findControls(rotated_state, goal);
+    ASSERT_EQ(k, match.sequence_index);
+    ASSERT_NEAR(0.0, match.distance, 0.0000001);
+  }
+
+  GoalPoseMatch match;
+  match.sequence_index = 7;
+  ASSERT_NEAR(grid.control_sequences[7].back().target_velocity, index.getControls(match).back().target_velocity, 0.0000001);
+  match.sequence_index = 60;
+  ASSERT_THROW(index.getControls(match), std::invalid_argument);
+
+  // Loading a new model makes the index stale and queries are rejected until it is rebuilt
+  unload();
+  ASSERT_TRUE(index.isStale());
+  ASSERT_NO_THROW(lib_vehicle_model::init(mock_param_server));
+  ASSERT_TRUE(index.isStale());
+  ASSERT_THROW(index.findNearest(initial_state, initial_state, 1), std::invalid_argument);
+  ASSERT_THROW(index.findControls(initial_state, initial_state), std::invalid_argument);
+
+  ASSERT_NO_THROW(library.build(grid));
+  ASSERT_NO_THROW(index.build(library));
+  ASSERT_FALSE(index.isStale());
+  ASSERT_NO_THROW(index.findControls(initial_state, initial_state));
+
+  unload();
+
+  ASSERT_EQ(1, mock_param_server.use_count());
+}
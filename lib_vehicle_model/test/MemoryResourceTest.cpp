@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <gtest/gtest.h>
+#include "lib_vehicle_model/MemoryResource.h"
+
+/**
+ * Unit tests for MemoryResource, MonotonicBufferResource and ResourceAllocator
+ */
+
+using namespace lib_vehicle_model;
+
+namespace {
+  /**
+   * Resource which counts the allocations forwarded to newDeleteResource()
+   */
+  class CountingResource : public MemoryResource
+  {
+    public:
+      size_t allocations = 0;
+      size_t deallocations = 0;
+      size_t largest_allocation = 0;
+
+    protected:
+      void* doAllocate(size_t bytes, size_t alignment) override {
+        allocations++;
+        largest_allocation = std::max(largest_allocation, bytes);
+        return newDeleteResource()->allocate(bytes, alignment);
+      }
+
+      void doDeallocate(void* ptr, size_t bytes, size_t alignment) override {
+        deallocations++;
+        newDeleteResource()->deallocate(ptr, bytes, alignment);
+      }
+
+      bool doIsEqual(const MemoryResource& other) const noexcept override {
+        return this == &other;
+      }
+  };
+}
+
+/**
+ * Tests allocation from a MonotonicBufferResource
+ */
+TEST(MemoryResource, monotonic_buffer)
+{
+  ASSERT_THROW(MonotonicBufferResource(64, nullptr), std::invalid_argument);
+
+  CountingResource upstream;
+  {
+    MonotonicBufferResource arena(256, &upstream);
+    ASSERT_EQ(&upstream, arena.upstreamResource());
+    ASSERT_EQ(0, upstream.allocations); // Nothing is allocated until needed
+
+    // Allocations are aligned and share a single upstream buffer
+    void* a = arena.allocate(3, 1);
+    void* b = arena.allocate(sizeof(double), alignof(double));
+    void* c = arena.allocate(32, 16);
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(b) % alignof(double));
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(c) % 16);
+    ASSERT_NE(a, b);
+    ASSERT_NE(b, c);
+    ASSERT_EQ(1, upstream.allocations);
+
+    // Deallocation is a no-op
+    arena.deallocate(c, 32, 16);
+    ASSERT_EQ(0, upstream.deallocations);
+
+    // Exhausting the buffer requests a larger one and large requests are always satisfied
+    arena.allocate(200);
+    arena.allocate(4096);
+    ASSERT_EQ(3, upstream.allocations);
+
+    // Release frees everything at once
+    arena.release();
+    ASSERT_EQ(3, upstream.deallocations);
+
+    arena.allocate(16);
+    ASSERT_EQ(4, upstream.allocations);
+  }
+  // Destruction releases the remaining buffers
+  ASSERT_EQ(4, upstream.deallocations);
+
+  // A caller provided buffer is used before upstream
+  alignas(std::max_align_t) char buffer[128];
+  MonotonicBufferResource buffered(buffer, sizeof(buffer), &upstream);
+  void* d = buffered.allocate(64);
+  ASSERT_GE(static_cast<char*>(d), buffer);
+  ASSERT_LT(static_cast<char*>(d), buffer + sizeof(buffer));
+  ASSERT_EQ(4, upstream.allocations);
+
+  buffered.allocate(128);
+  ASSERT_EQ(5, upstream.allocations);
+
+  // After a release the caller provided buffer is reused
+  buffered.release();
+  ASSERT_EQ(d, buffered.allocate(64));
+}
+
+/**
+ * Tests that a MonotonicBufferResource released at the end of every cycle does not request ever larger buffers
+ */
+TEST(MemoryResource, monotonic_buffer_cycles)
+{
+  CountingResource upstream;
+  MonotonicBufferResource arena(1024, &upstream);
+
+  for (int cycle = 0; cycle < 20; cycle++) {
+    arena.allocate(800);
+    arena.allocate(800); // Exhausts the first buffer so a second, larger one is requested
+    arena.release();
+  }
+
+  ASSERT_EQ(40, upstream.allocations);
+  ASSERT_EQ(40, upstream.deallocations);
+  ASSERT_LE(upstream.largest_allocation, 4096);
+
+  // A caller provided buffer restores its first upstream size in the same way
+  alignas(std::max_align_t) char buffer[128];
+  MonotonicBufferResource buffered(buffer, sizeof(buffer), &upstream);
+  upstream.largest_allocation = 0;
+  for (int cycle = 0; cycle < 20; cycle++) {
+    buffered.allocate(200);
+    buffered.allocate(200);
+    buffered.release();
+  }
+  ASSERT_LE(upstream.largest_allocation, 4096);
+}
+
+/**
+ * Tests containers using a ResourceAllocator
+ */
+TEST(MemoryResource, resource_allocator)
+{
+  CountingResource upstream;
+  MonotonicBufferResource arena(1024, &upstream);
+
+  ResourceVector<double> values{ResourceAllocator<double>(&arena)};
+  for (int i = 0; i < 100; i++) {
+    values.push_back(i);
+  }
+  ASSERT_EQ(100, values.size());
+  ASSERT_EQ(99.0, values.back());
+  ASSERT_EQ(&arena, values.get_allocator().resource());
+
+  // Allocators compare equal if they use the same resource
+  ASSERT_TRUE(ResourceAllocator<int>(&arena) == ResourceAllocator<double>(&arena));
+  ASSERT_TRUE(ResourceAllocator<int>(&arena) != ResourceAllocator<int>());
+  ASSERT_TRUE(ResourceAllocator<int>() == ResourceAllocator<int>(newDeleteResource()));
+
+  // Moving keeps the resource while copies use the default resource
+  ResourceVector<double> moved(std::move(values));
+  ASSERT_EQ(&arena, moved.get_allocator().resource());
+  ResourceVector<double> copied(moved);
+  ASSERT_EQ(newDeleteResource(), copied.get_allocator().resource());
+  ASSERT_EQ(100, copied.size());
+
+  // Alignments above alignof(std::max_align_t) are not supported by the default resource
+  ASSERT_THROW(newDeleteResource()->allocate(8, 2 * alignof(std::max_align_t)), std::bad_alloc);
+}
@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <memory>
+#include <thread>
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "lib_vehicle_model/ModelEnsemble.h"
+#include "lib_vehicle_model/ParameterServer.h"
+#include "TestVehicleModel.h"
+
+/**
+ * Unit tests for ModelEnsemble
+ */
+
+using namespace lib_vehicle_model;
+using ::testing::A;
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Return;
+
+namespace {
+  class EnsembleParamServer : public ParameterServer {
+    public:
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, std::string& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, double& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, float& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, int& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, bool& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, std::vector<std::string>& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, std::vector<double>& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, std::vector<float>& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, std::vector<int>& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, std::vector<bool>& output));
+      ~EnsembleParamServer() {};
+  };
+
+  ACTION_P(set_value, val)
+  {
+    arg1 = val;
+  }
+
+  /**
+   * Vehicle model which predicts the same motion as TestVehicleModel shifted 1 m along the global y-axis
+   */
+  class ShiftedVehicleModel : public TestVehicleModel
+  {
+    public:
+      using TestVehicleModel::predict;
+
+      std::vector<VehicleState> predict(const VehicleState& initial_state,
+        const std::vector<VehicleControlInput>& control_inputs, double timestep) override {
+
+        std::vector<VehicleState> states = TestVehicleModel::predict(initial_state, control_inputs, timestep);
+        for (VehicleState& state : states) {
+          state.Y_pos_global += 1.0;
+        }
+        return states;
+      }
+  };
+
+  /**
+   * Vehicle model which always fails
+   */
+  class FailingVehicleModel : public TestVehicleModel
+  {
+    public:
+      using TestVehicleModel::predict;
+
+      std::vector<VehicleState> predict(const VehicleState& initial_state,
+        const std::vector<VehicleControlInput>& control_inputs, double timestep) override {
+        throw std::runtime_error("Model failure");
+      }
+  };
+
+  /**
+   * Vehicle model which records the thread of each prediction
+   */
+  class ThreadRecordingVehicleModel : public TestVehicleModel
+  {
+    public:
+      using TestVehicleModel::predict;
+
+      std::vector<std::thread::id> threads;
+
+      std::vector<VehicleState> predict(const VehicleState& initial_state,
+        const std::vector<VehicleControlInput>& control_inputs, double timestep) override {
+
+        threads.push_back(std::this_thread::get_id());
+        return TestVehicleModel::predict(initial_state, control_inputs, timestep);
+      }
+  };
+
+  std::shared_ptr<EnsembleParamServer> buildParamServer() {
+    auto param_server = std::make_shared<EnsembleParamServer>();
+    EXPECT_CALL(*param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_value(10.0), Return(true)));
+    EXPECT_CALL(*param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_value(-10.0), Return(true)));
+    EXPECT_CALL(*param_server, getParam("max_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_value(180.0), Return(true)));
+    EXPECT_CALL(*param_server, getParam("min_steering_angle", A<double&>())).WillRepeatedly(DoAll(set_value(-180.0), Return(true)));
+    EXPECT_CALL(*param_server, getParam("max_steering_angle_rate", A<double&>())).WillRepeatedly(DoAll(set_value(90.0), Return(true)));
+    EXPECT_CALL(*param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_value(180.0), Return(true)));
+    EXPECT_CALL(*param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_value(-180.0), Return(true)));
+    EXPECT_CALL(*param_server, getParam("example_param", A<double&>())).WillRepeatedly(DoAll(set_value(0.0), Return(true)));
+    return param_server;
+  }
+}
+
+/**
+ * Tests the constructor input checks and the loading of model plugins
+ */
+TEST(ModelEnsemble, constructor)
+{
+  auto param_server = buildParamServer();
+
+  ASSERT_THROW(ModelEnsemble(param_server, std::vector<std::shared_ptr<VehicleMotionModel>>()), std::invalid_argument);
+  ASSERT_THROW(ModelEnsemble(param_server, {std::make_shared<TestVehicleModel>(), nullptr}), std::invalid_argument);
+  ASSERT_NO_THROW(ModelEnsemble(param_server, {std::make_shared<TestVehicleModel>()}));
+  ASSERT_THROW(ModelEnsemble(nullptr, {std::make_shared<TestVehicleModel>()}), std::invalid_argument);
+  ASSERT_THROW(ModelEnsemble ensemble(nullptr), std::invalid_argument);
+
+  EXPECT_CALL(*param_server, getParam("ensemble_model_lib_paths", A<std::vector<std::string>&>())).WillOnce(Return(false));
+  ASSERT_THROW(ModelEnsemble ensemble(param_server), std::invalid_argument);
+
+  std::vector<std::string> bad_paths = {"test_libs/fake_file_path.so"};
+  EXPECT_CALL(*param_server, getParam("ensemble_model_lib_paths", A<std::vector<std::string>&>())).WillOnce(DoAll(set_value(bad_paths), Return(true)));
+  ASSERT_THROW(ModelEnsemble ensemble(param_server), std::invalid_argument);
+
+  // The same plugin can be loaded more than once
+  std::vector<std::string> paths = {"test_libs/unittest_vehicle_model_shared_lib.so", "test_libs/unittest_vehicle_model_shared_lib.so"};
+  EXPECT_CALL(*param_server, getParam("ensemble_model_lib_paths", A<std::vector<std::string>&>())).WillOnce(DoAll(set_value(paths), Return(true)));
+  std::unique_ptr<ModelEnsemble> ensemble;
+  ASSERT_NO_THROW(ensemble.reset(new ModelEnsemble(param_server)));
+  ASSERT_EQ(2, ensemble->size());
+
+  EnsemblePrediction prediction = ensemble->predict(VehicleState(), std::vector<VehicleControlInput>(3), 0.1);
+  ASSERT_EQ(2, prediction.trajectories.size());
+  ASSERT_NEAR(5.0, prediction.mean[0].X_pos_global, 0.0000001);
+  ASSERT_NEAR(0.0, prediction.max_position_deviation[0], 0.0000001);
+}
+
+/**
+ * Tests that each model receives the request and the spread between them is reported
+ */
+TEST(ModelEnsemble, predict)
+{
+  auto param_server = buildParamServer();
+  auto base_model = std::make_shared<TestVehicleModel>();
+  auto shifted_model = std::make_shared<ShiftedVehicleModel>();
+  ModelEnsemble ensemble(param_server, {base_model, shifted_model});
+
+  VehicleState vs;
+  vs.longitudinal_vel = 5.0;
+  std::vector<VehicleControlInput> controls(10);
+  for (VehicleControlInput& control : controls) {
+    control.target_velocity = 5.0;
+  }
+
+  EnsemblePrediction prediction = ensemble.predict(vs, controls, 0.1);
+  ASSERT_EQ(2, prediction.trajectories.size());
+  ASSERT_EQ(10, prediction.mean.size());
+  ASSERT_EQ(10, prediction.std_dev.size());
+  ASSERT_EQ(10, prediction.max_position_deviation.size());
+  ASSERT_EQ(10, base_model->integrated_steps);
+  ASSERT_EQ(10, shifted_model->integrated_steps);
+
+  for (size_t i = 0; i < 10; i++) {
+    ASSERT_NEAR(prediction.trajectories[0][i].X_pos_global, prediction.mean[i].X_pos_global, 0.0000001);
+    ASSERT_NEAR(prediction.trajectories[0][i].Y_pos_global + 0.5, prediction.mean[i].Y_pos_global, 0.0000001);
+    ASSERT_NEAR(0.0, prediction.std_dev[i].X_pos_global, 0.0000001);
+    ASSERT_NEAR(0.5, prediction.std_dev[i].Y_pos_global, 0.0000001);
+    ASSERT_NEAR(0.5, prediction.max_position_deviation[i], 0.0000001);
+  }
+
+  // Predictions without control inputs use the previous commands
+  vs.prev_vel_cmd = 5.0;
+  prediction = ensemble.predict(vs, 0.1, 1.0);
+  ASSERT_EQ(10, prediction.mean.size());
+  ASSERT_NEAR(0.5, prediction.std_dev[9].Y_pos_global, 0.0000001);
+
+  // Requests are validated once before reaching the models
+  vs.trailer_angle = -300.0;
+  ASSERT_THROW(ensemble.predict(vs, controls, 0.1), std::invalid_argument);
+  vs.trailer_angle = 0.0;
+
+  controls[3].target_velocity = 11.0;
+  ASSERT_THROW(ensemble.predict(vs, controls, 0.1), std::invalid_argument);
+  controls[3].target_velocity = 5.0;
+
+  ASSERT_THROW(ensemble.predict(vs, 1.0, 0.5), std::invalid_argument);
+  ASSERT_EQ(20, base_model->integrated_steps); // Rejected requests never reach the models
+
+  // Model failures are reported after every model has finished
+  ModelEnsemble failing_ensemble(param_server, {base_model, std::make_shared<FailingVehicleModel>()});
+  ASSERT_THROW(failing_ensemble.predict(vs, controls, 0.1), std::runtime_error);
+}
+
+/**
+ * Tests that the models after the first run on worker threads which are reused by every request
+ */
+TEST(ModelEnsemble, workerThreads)
+{
+  auto param_server = buildParamServer();
+  auto first_model = std::make_shared<ThreadRecordingVehicleModel>();
+  auto second_model = std::make_shared<ThreadRecordingVehicleModel>();
+  auto third_model = std::make_shared<ThreadRecordingVehicleModel>();
+  ModelEnsemble ensemble(param_server, {first_model, second_model, third_model});
+
+  for (int i = 0; i < 5; i++) {
+    EnsemblePrediction prediction = ensemble.predict(VehicleState(), std::vector<VehicleControlInput>(3), 0.1);
+    ASSERT_EQ(3, prediction.trajectories.size());
+    ASSERT_EQ(3, prediction.mean.size());
+  }
+
+  ASSERT_EQ(5, first_model->threads.size());
+  ASSERT_EQ(5, second_model->threads.size());
+  ASSERT_EQ(5, third_model->threads.size());
+  for (size_t i = 0; i < 5; i++) {
+    ASSERT_EQ(std::this_thread::get_id(), first_model->threads[i]);
+    ASSERT_EQ(second_model->threads[0], second_model->threads[i]);
+    ASSERT_EQ(third_model->threads[0], third_model->threads[i]);
+  }
+  ASSERT_NE(std::this_thread::get_id(), second_model->threads[0]);
+  ASSERT_NE(std::this_thread::get_id(), third_model->threads[0]);
+  ASSERT_NE(second_model->threads[0], third_model->threads[0]);
+}
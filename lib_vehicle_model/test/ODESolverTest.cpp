@@ -91,3 +91,50 @@ TEST(ODESOlver, rk4)
   }
 
 }
+
+/**
+ * Tests the output_stride option of the rk4 solver function of the ODESolver
+ */ 
+TEST(ODESOlver, rk4_output_stride)
+{
+  
+  std::vector<double> control_inputs(5, 0);
+
+  ODESolver::State initial_state;
+  initial_state.push_back(0);
+  initial_state.push_back(1);
+
+  std::vector<std::tuple<double, ODESolver::State>> ode_outputs;
+  double timestep = 0.1;
+
+  // Same ODE as the rk4 test with every second state kept
+  int tracker = 0;
+  ODESolver::rk4<double,int>(
+    [this](const ODESolver::State& state, const double& control, int tracker, ODESolver::StateDot& state_dot, const double t) -> void {
+      state_dot[0] = 4 * exp(0.8*t) - 0.5*state[0];
+      state_dot[1] = 4 * exp(0.8*t) - 3*state[1];
+    },
+    control_inputs.size(),
+    timestep,
+    initial_state,
+    control_inputs,
+    ode_outputs,
+    [this](const ODESolver::State& current, const double& control, int tracker, const double t, const ODESolver::State& initial_state, ODESolver::State& output) -> void {
+      output = current;
+    },
+    tracker,
+    2
+  );
+
+  // Steps 2 and 4 are kept by the stride and step 5 is kept as the final state
+  ASSERT_EQ(3, ode_outputs.size());
+  ASSERT_NEAR(0.2, std::get<0>(ode_outputs[0]), 0.000001);
+  ASSERT_NEAR(0.82669, std::get<1>(ode_outputs[0])[0], 0.00001);
+  ASSERT_NEAR(1.20639, std::get<1>(ode_outputs[0])[1], 0.00001);
+  ASSERT_NEAR(0.4, std::get<0>(ode_outputs[1]), 0.000001);
+  ASSERT_NEAR(1.71814, std::get<1>(ode_outputs[1])[0], 0.00001);
+  ASSERT_NEAR(1.43376, std::get<1>(ode_outputs[1])[1], 0.00001);
+  ASSERT_NEAR(0.5, std::get<0>(ode_outputs[2]), 0.000001);
+  ASSERT_NEAR(2.19392, std::get<1>(ode_outputs[2])[0], 0.00001);
+  ASSERT_NEAR(1.55860, std::get<1>(ode_outputs[2])[1], 0.00001);
+}
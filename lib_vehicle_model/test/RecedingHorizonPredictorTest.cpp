@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <memory>
+#include <gtest/gtest.h>
+#include "lib_vehicle_model/RecedingHorizonPredictor.h"
+#include "TestVehicleModel.h"
+
+/**
+ * Unit tests for RecedingHorizonPredictor
+ */
+
+using namespace lib_vehicle_model;
+
+namespace {
+  std::vector<VehicleControlInput> buildControls(size_t count, double start_velocity) {
+    std::vector<VehicleControlInput> controls;
+    for (size_t i = 0; i < count; i++) {
+      VehicleControlInput ci;
+      ci.target_velocity = start_velocity + i * 0.1;
+      ci.target_steering_angle = 0.01 * i;
+      controls.push_back(ci);
+    }
+    return controls;
+  }
+}
+
+/**
+ * Tests the constructor input checks
+ */
+TEST(RecedingHorizonPredictor, constructor)
+{
+  ASSERT_THROW(RecedingHorizonPredictor(nullptr, 0.1), std::invalid_argument);
+  ASSERT_THROW(RecedingHorizonPredictor(std::make_shared<TestVehicleModel>(), -0.1), std::invalid_argument);
+  ASSERT_NO_THROW(RecedingHorizonPredictor(std::make_shared<TestVehicleModel>(), 0.1));
+}
+
+/**
+ * Tests that a shifted horizon reuses the stored suffix and matches a full prediction
+ */
+TEST(RecedingHorizonPredictor, predict)
+{
+  auto model = std::make_shared<TestVehicleModel>();
+  RecedingHorizonPredictor predictor(model, 0.001);
+
+  VehicleState vs;
+  std::vector<VehicleControlInput> controls = buildControls(20, 5.0);
+  const double timestep = 0.1;
+
+  // Initial call must integrate the full horizon
+  std::vector<VehicleState> first = predictor.predict(vs, controls, timestep);
+  ASSERT_EQ(20, first.size());
+  ASSERT_EQ(0, predictor.getReusedStepCount());
+  ASSERT_EQ(20, model->integrated_steps);
+
+  // Shift the horizon by one control period and add one new control to the end
+  std::vector<VehicleControlInput> shifted(controls.begin() + 1, controls.end());
+  VehicleControlInput new_control;
+  new_control.target_velocity = 3.0;
+  shifted.push_back(new_control);
+
+  model->integrated_steps = 0;
+  std::vector<VehicleState> second = predictor.predict(first[0], shifted, timestep);
+  ASSERT_EQ(20, second.size());
+  ASSERT_EQ(19, predictor.getReusedStepCount());
+  ASSERT_EQ(1, model->integrated_steps); // Only the new tail was integrated
+
+  // Result must match a prediction made from scratch
+  TestVehicleModel reference_model;
+  std::vector<VehicleState> expected = reference_model.predict(first[0], shifted, timestep);
+  for (size_t i = 0; i < expected.size(); i++) {
+    ASSERT_NEAR(expected[i].X_pos_global, second[i].X_pos_global, 0.000001);
+    ASSERT_NEAR(expected[i].Y_pos_global, second[i].Y_pos_global, 0.000001);
+    ASSERT_NEAR(expected[i].orientation, second[i].orientation, 0.000001);
+    ASSERT_NEAR(expected[i].longitudinal_vel, second[i].longitudinal_vel, 0.000001);
+  }
+
+  // Diverging controls only reuse the matching prefix
+  std::vector<VehicleControlInput> diverged(shifted.begin() + 1, shifted.end());
+  diverged[5].target_velocity = 1.0;
+  model->integrated_steps = 0;
+  predictor.predict(second[0], diverged, timestep);
+  ASSERT_EQ(5, predictor.getReusedStepCount());
+  ASSERT_EQ(diverged.size() - 5, model->integrated_steps);
+
+  // A state outside the tolerance requires a full prediction
+  VehicleState far_state = second[0];
+  far_state.X_pos_global += 1.0;
+  model->integrated_steps = 0;
+  predictor.predict(far_state, diverged, timestep);
+  ASSERT_EQ(0, predictor.getReusedStepCount());
+  ASSERT_EQ(diverged.size(), model->integrated_steps);
+
+  // A different timestep cannot reuse stored data
+  predictor.predict(far_state, diverged, timestep);
+  model->integrated_steps = 0;
+  predictor.predict(far_state, diverged, timestep * 2);
+  ASSERT_EQ(0, predictor.getReusedStepCount());
+
+  // Reset clears the stored trajectory
+  predictor.reset();
+  model->integrated_steps = 0;
+  predictor.predict(far_state, diverged, timestep * 2);
+  ASSERT_EQ(0, predictor.getReusedStepCount());
+  ASSERT_EQ(diverged.size(), model->integrated_steps);
+}
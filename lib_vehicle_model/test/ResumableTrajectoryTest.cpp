@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <memory>
+#include <gtest/gtest.h>
+#include "lib_vehicle_model/ResumableTrajectory.h"
+#include "TestVehicleModel.h"
+
+/**
+ * Unit tests for ResumableTrajectory
+ */
+
+using namespace lib_vehicle_model;
+
+/**
+ * Tests that appending segments only integrates the new segment and matches a single full prediction
+ */
+TEST(ResumableTrajectory, append)
+{
+  auto model = std::make_shared<TestVehicleModel>();
+  VehicleState vs;
+  vs.longitudinal_vel = 2.0;
+  const double timestep = 0.1;
+
+  ASSERT_THROW(ResumableTrajectory(nullptr, vs, timestep), std::invalid_argument);
+  ASSERT_THROW(ResumableTrajectory(model, vs, 0.0), std::invalid_argument);
+
+  ResumableTrajectory trajectory(model, vs, timestep);
+  ASSERT_EQ(0, trajectory.getStates().size());
+  ASSERT_NEAR(vs.longitudinal_vel, trajectory.getFinalState().longitudinal_vel, 0.000001);
+  ASSERT_NEAR(0.0, trajectory.getElapsedTime(), 0.000001);
+
+  std::vector<VehicleControlInput> all_controls;
+  for (size_t segment = 0; segment < 5; segment++) {
+    std::vector<VehicleControlInput> controls(4);
+    for (size_t i = 0; i < controls.size(); i++) {
+      controls[i].target_velocity = 3.0 + segment;
+      controls[i].target_steering_angle = 0.02 * i;
+    }
+    all_controls.insert(all_controls.end(), controls.begin(), controls.end());
+
+    model->integrated_steps = 0;
+    std::vector<VehicleState> new_states = trajectory.append(controls);
+    ASSERT_EQ(controls.size(), new_states.size());
+    ASSERT_EQ(controls.size(), model->integrated_steps); // Only the new segment was integrated
+  }
+
+  ASSERT_EQ(20, trajectory.getStates().size());
+  ASSERT_EQ(20, trajectory.getControlInputs().size());
+  ASSERT_NEAR(2.0, trajectory.getElapsedTime(), 0.000001);
+
+  // Appending nothing is a no-op
+  ASSERT_EQ(0, trajectory.append(std::vector<VehicleControlInput>()).size());
+  ASSERT_EQ(20, trajectory.getStates().size());
+
+  // Compare against a single prediction over the concatenated controls
+  TestVehicleModel reference_model;
+  std::vector<VehicleState> expected = reference_model.predict(vs, all_controls, timestep);
+  ASSERT_EQ(expected.size(), trajectory.getStates().size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    ASSERT_NEAR(expected[i].X_pos_global, trajectory.getStates()[i].X_pos_global, 0.000001);
+    ASSERT_NEAR(expected[i].Y_pos_global, trajectory.getStates()[i].Y_pos_global, 0.000001);
+    ASSERT_NEAR(expected[i].orientation, trajectory.getStates()[i].orientation, 0.000001);
+  }
+  ASSERT_NEAR(expected.back().X_pos_global, trajectory.getFinalState().X_pos_global, 0.000001);
+}
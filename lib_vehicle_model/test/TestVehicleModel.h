@@ -0,0 +1,76 @@
+#pragma once
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <math.h>
+#include <vector>
+#include <memory>
+#include "lib_vehicle_model/VehicleState.h"
+#include "lib_vehicle_model/VehicleControlInput.h"
+#include "lib_vehicle_model/VehicleMotionModel.h"
+
+/**
+ * Simple in process vehicle model used by unit tests which need a real VehicleMotionModel instance.
+ *
+ * Velocity and steering are set instantly to the commanded values and the pose is advanced with a unicycle model.
+ * The number of integrated steps is counted so tests can verify how much work was done.
+ */
+class TestVehicleModel : public lib_vehicle_model::VehicleMotionModel
+{
+  public:
+    size_t integrated_steps = 0;
+    size_t predict_calls = 0;
+
+    std::vector<lib_vehicle_model::VehicleState> predict(const lib_vehicle_model::VehicleState& initial_state,
+      double timestep, double delta_t) override {
+
+      lib_vehicle_model::VehicleControlInput control;
+      control.target_steering_angle = initial_state.prev_steering_cmd;
+      control.target_velocity = initial_state.prev_vel_cmd;
+
+      size_t num_steps = delta_t <= timestep ? 1 : delta_t / timestep;
+      return predict(initial_state, std::vector<lib_vehicle_model::VehicleControlInput>(num_steps, control), timestep);
+    }
+
+    std::vector<lib_vehicle_model::VehicleState> predict(const lib_vehicle_model::VehicleState& initial_state,
+      const std::vector<lib_vehicle_model::VehicleControlInput>& control_inputs, double timestep) override {
+
+      predict_calls++;
+      std::vector<lib_vehicle_model::VehicleState> states;
+      lib_vehicle_model::VehicleState state = initial_state;
+
+      for (const lib_vehicle_model::VehicleControlInput& control : control_inputs) {
+        state.longitudinal_vel = control.target_velocity;
+        state.steering_angle = control.target_steering_angle;
+        state.yaw_rate = state.longitudinal_vel * tan(state.steering_angle) / 2.0;
+        state.X_pos_global += state.longitudinal_vel * cos(state.orientation) * timestep;
+        state.Y_pos_global += state.longitudinal_vel * sin(state.orientation) * timestep;
+        state.orientation += state.yaw_rate * timestep;
+        state.prev_steering_cmd = control.target_steering_angle;
+        state.prev_vel_cmd = control.target_velocity;
+        states.push_back(state);
+        integrated_steps++;
+      }
+
+      return states;
+    }
+
+    bool isFrameInvariant() const override {
+      return true;
+    }
+
+    void setParameterServer(std::shared_ptr<lib_vehicle_model::ParameterServer> parameter_server) override {}
+};
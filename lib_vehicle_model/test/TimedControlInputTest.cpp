@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <memory>
+#include <gtest/gtest.h>
+#include "lib_vehicle_model/TimedControlInput.h"
+#include "TestVehicleModel.h"
+
+/**
+ * Unit tests for TimedControlInput and ControlChangeCursor
+ */
+
+using namespace lib_vehicle_model;
+
+/**
+ * Tests that change points are applied from the first step starting at or after their time
+ */
+TEST(ControlChangeCursor, controlForStep)
+{
+  ASSERT_EQ(0, ControlChangeCursor::firstStep(-1.0, 0.1));
+  ASSERT_EQ(0, ControlChangeCursor::firstStep(0.0, 0.1));
+  ASSERT_EQ(3, ControlChangeCursor::firstStep(0.3, 0.1)); // On a step boundary despite floating point error
+  ASSERT_EQ(4, ControlChangeCursor::firstStep(0.35, 0.1));
+
+  VehicleControlInput initial;
+  initial.target_velocity = 1.0;
+
+  std::vector<TimedControlInput> changes(3);
+  changes[0].time = 0.2;
+  changes[0].control.target_velocity = 2.0;
+  changes[1].time = 0.5;
+  changes[1].control.target_velocity = 3.0;
+  changes[2].time = 0.5; // Replaces the previous change point
+  changes[2].control.target_velocity = 4.0;
+
+  ControlChangeCursor cursor(changes, initial, 0.1);
+  const double expected[] = {1.0, 1.0, 2.0, 2.0, 2.0, 4.0, 4.0};
+  for (size_t i = 0; i < 7; i++) {
+    ASSERT_NEAR(expected[i], cursor.controlForStep(i).target_velocity, 0.0000001);
+  }
+
+  // Skipped steps apply every change point passed over
+  ControlChangeCursor skipping_cursor(changes, initial, 0.1);
+  ASSERT_NEAR(4.0, skipping_cursor.controlForStep(10).target_velocity, 0.0000001);
+}
+
+/**
+ * Tests that the default VehicleMotionModel implementation matches a prediction with one control input per step
+ */
+TEST(ControlChangeCursor, defaultPredict)
+{
+  TestVehicleModel model;
+  VehicleMotionModel& base = model;
+
+  VehicleState vs;
+  vs.prev_vel_cmd = 1.0;
+
+  std::vector<TimedControlInput> changes(2);
+  changes[0].time = 0.3;
+  changes[0].control.target_velocity = 5.0;
+  changes[0].control.target_steering_angle = 0.1;
+  changes[1].time = 0.6;
+  changes[1].control.target_velocity = 3.0;
+
+  std::vector<VehicleControlInput> expanded(10);
+  for (size_t i = 0; i < expanded.size(); i++) {
+    if (i < 3) {
+      expanded[i].target_velocity = 1.0;
+    } else if (i < 6) {
+      expanded[i] = changes[0].control;
+    } else {
+      expanded[i] = changes[1].control;
+    }
+  }
+
+  std::vector<VehicleState> timed = base.predict(vs, changes, 0.1, 1.0);
+  std::vector<VehicleState> full = model.predict(vs, expanded, 0.1);
+
+  ASSERT_EQ(full.size(), timed.size());
+  for (size_t i = 0; i < full.size(); i++) {
+    ASSERT_NEAR(full[i].X_pos_global, timed[i].X_pos_global, 0.0000001);
+    ASSERT_NEAR(full[i].Y_pos_global, timed[i].Y_pos_global, 0.0000001);
+    ASSERT_NEAR(full[i].orientation, timed[i].orientation, 0.0000001);
+    ASSERT_NEAR(full[i].prev_vel_cmd, timed[i].prev_vel_cmd, 0.0000001);
+  }
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <gtest/gtest.h>
+#include "lib_vehicle_model/Tracing.h"
+
+/**
+ * Unit tests for the lib_vehicle_model::tracing namespace
+ */
+
+using namespace lib_vehicle_model;
+
+namespace {
+  size_t countOccurrences(const std::string& str, const std::string& pattern) {
+    size_t count = 0;
+    for (size_t pos = str.find(pattern); pos != std::string::npos; pos = str.find(pattern, pos + 1)) {
+      count++;
+    }
+    return count;
+  }
+}
+
+/**
+ * Tests recording spans and writing them as a Chrome trace
+ */
+TEST(tracing, record)
+{
+  ASSERT_THROW(tracing::enable(0), std::invalid_argument);
+
+  // Spans are not recorded while disabled
+  tracing::disable();
+  tracing::clear();
+  {
+    tracing::ScopedSpan span("disabled_span", "test");
+  }
+  std::ostringstream empty;
+  ASSERT_EQ(0, tracing::writeChromeTrace(empty));
+  ASSERT_NE(std::string::npos, empty.str().find("\"traceEvents\":["));
+
+  tracing::enable(16);
+  tracing::clear();
+  ASSERT_TRUE(tracing::isEnabled());
+  {
+    tracing::ScopedSpan outer("outer", "test");
+    {
+      tracing::ScopedSpan inner("inner \"quoted\"", "test");
+    }
+  }
+
+  std::ostringstream trace;
+  ASSERT_EQ(2, tracing::writeChromeTrace(trace));
+  const std::string json = trace.str();
+  ASSERT_NE(std::string::npos, json.find("\"name\":\"outer\""));
+  ASSERT_NE(std::string::npos, json.find("\"name\":\"inner \\\"quoted\\\"\""));
+  ASSERT_EQ(2, countOccurrences(json, "\"ph\":\"X\""));
+  ASSERT_EQ(2, countOccurrences(json, "\"cat\":\"test\""));
+
+  // Only the most recent spans are kept once the buffer is full
+  tracing::clear();
+  for (int i = 0; i < 40; i++) {
+    tracing::ScopedSpan span("wrapped", "test");
+  }
+  std::ostringstream wrapped;
+  ASSERT_EQ(16, tracing::writeChromeTrace(wrapped));
+
+  // Spans may be recorded from many threads at once
+  tracing::enable(1024);
+  tracing::clear();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.push_back(std::thread([]() {
+      for (int i = 0; i < 1000; i++) {
+        tracing::ScopedSpan span("threaded", "test");
+      }
+    }));
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  std::ostringstream threaded;
+  ASSERT_EQ(1024, tracing::writeChromeTrace(threaded));
+
+  // Flush to file
+  const std::string path = "tracing_test_output.json";
+  ASSERT_EQ(1024, tracing::flush(path));
+  std::ifstream file(path.c_str());
+  std::stringstream contents;
+  contents << file.rdbuf();
+  ASSERT_EQ(threaded.str(), contents.str());
+  std::remove(path.c_str());
+
+  ASSERT_THROW(tracing::flush("/nonexistent_directory/trace.json"), std::invalid_argument);
+
+  tracing::disable();
+  tracing::clear();
+  ASSERT_FALSE(tracing::isEnabled());
+}
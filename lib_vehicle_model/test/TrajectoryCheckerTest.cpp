@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "lib_vehicle_model/TrajectoryChecker.h"
+#include "lib_vehicle_model/ParameterServer.h"
+
+/**
+ * Unit tests for TrajectoryChecker
+ */
+
+using namespace lib_vehicle_model;
+using ::testing::A;
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Return;
+
+namespace {
+  class TrajectoryParamServer : public ParameterServer {
+    public:
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, std::string& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, double& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, float& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, int& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, bool& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, std::vector<std::string>& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, std::vector<double>& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, std::vector<float>& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, std::vector<int>& output));
+      MOCK_METHOD2(getParam, bool(const std::string& param_key, std::vector<bool>& output));
+      ~TrajectoryParamServer() {};
+  };
+
+  ACTION_P(set_value, val)
+  {
+    arg1 = val;
+  }
+
+  std::shared_ptr<TrajectoryParamServer> buildParamServer(bool optional_limits) {
+    auto param_server = std::make_shared<TrajectoryParamServer>();
+
+    EXPECT_CALL(*param_server, getParam("max_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_value(10.0), Return(true)));
+    EXPECT_CALL(*param_server, getParam("min_forward_speed", A<double&>())).WillRepeatedly(DoAll(set_value(-2.0), Return(true)));
+    EXPECT_CALL(*param_server, getParam("max_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_value(0.5), Return(true)));
+    EXPECT_CALL(*param_server, getParam("min_trailer_angle", A<double&>())).WillRepeatedly(DoAll(set_value(-0.5), Return(true)));
+
+    if (optional_limits) {
+      EXPECT_CALL(*param_server, getParam("max_lateral_acceleration", A<double&>())).WillRepeatedly(DoAll(set_value(3.0), Return(true)));
+      EXPECT_CALL(*param_server, getParam("max_yaw_rate", A<double&>())).WillRepeatedly(DoAll(set_value(0.5), Return(true)));
+    } else {
+      EXPECT_CALL(*param_server, getParam("max_lateral_acceleration", A<double&>())).WillRepeatedly(Return(false));
+      EXPECT_CALL(*param_server, getParam("max_yaw_rate", A<double&>())).WillRepeatedly(Return(false));
+    }
+
+    return param_server;
+  }
+}
+
+/**
+ * Tests the constructor of the TrajectoryChecker
+ */
+TEST(TrajectoryChecker, constructor)
+{
+  TrajectoryChecker with_limits(buildParamServer(true));
+  ASSERT_TRUE(with_limits.checksLateralAcceleration());
+  ASSERT_TRUE(with_limits.checksYawRate());
+
+  TrajectoryChecker without_limits(buildParamServer(false));
+  ASSERT_FALSE(without_limits.checksLateralAcceleration());
+  ASSERT_FALSE(without_limits.checksYawRate());
+
+  auto missing = std::make_shared<TrajectoryParamServer>();
+  EXPECT_CALL(*missing, getParam(_, A<double&>())).WillRepeatedly(Return(false));
+  ASSERT_THROW(TrajectoryChecker checker(missing), std::invalid_argument);
+}
+
+/**
+ * Tests checking single trajectories
+ */
+TEST(TrajectoryChecker, checkTrajectory)
+{
+  TrajectoryChecker checker(buildParamServer(true));
+
+  // Cover several blocks so early exit within and across blocks is exercised
+  std::vector<VehicleState> states(3 * TrajectoryChecker::BLOCK_SIZE + 3);
+  for (VehicleState& state : states) {
+    state.longitudinal_vel = 5.0;
+    state.yaw_rate = 0.1;
+  }
+
+  size_t first_violation = 0;
+  ASSERT_EQ(TrajectoryViolation::NONE, checker.checkTrajectory(states.data(), states.size(), &first_violation));
+  ASSERT_EQ(states.size(), first_violation);
+  ASSERT_EQ(TrajectoryViolation::NONE, checker.checkTrajectory(states));
+
+  // Only the first infeasible state is reported
+  states[13].yaw_rate = 0.8; // Lateral acceleration of 4 and yaw rate above 0.5
+  states[20].longitudinal_vel = 11.0;
+  ASSERT_EQ(TrajectoryViolation::LATERAL_ACCELERATION_ABOVE_MAX | TrajectoryViolation::YAW_RATE_ABOVE_MAX,
+    checker.checkTrajectory(states.data(), states.size(), &first_violation));
+  ASSERT_EQ(13, first_violation);
+
+  states[13].yaw_rate = 0.1;
+  ASSERT_EQ(TrajectoryViolation::SPEED_ABOVE_MAX, checker.checkTrajectory(states.data(), states.size(), &first_violation));
+  ASSERT_EQ(20, first_violation);
+
+  states[20].longitudinal_vel = -3.0;
+  states[20].trailer_angle = -0.6;
+  ASSERT_EQ(TrajectoryViolation::SPEED_BELOW_MIN | TrajectoryViolation::TRAILER_ANGLE_BELOW_MIN, checker.checkTrajectory(states));
+
+  states[20].longitudinal_vel = 5.0;
+  states[20].trailer_angle = 0.0;
+  states.back().trailer_angle = 0.6;
+  ASSERT_EQ(TrajectoryViolation::TRAILER_ANGLE_ABOVE_MAX, checker.checkTrajectory(states.data(), states.size(), &first_violation));
+  ASSERT_EQ(states.size() - 1, first_violation);
+
+  // Lateral acceleration is checked independently of the yaw rate
+  states.back().trailer_angle = 0.0;
+  states[2].longitudinal_vel = 9.0;
+  states[2].yaw_rate = -0.4;
+  ASSERT_EQ(TrajectoryViolation::LATERAL_ACCELERATION_ABOVE_MAX, checker.checkTrajectory(states));
+
+  // Optional limits are ignored if not set
+  TrajectoryChecker without_limits(buildParamServer(false));
+  states[2].yaw_rate = -5.0;
+  ASSERT_EQ(TrajectoryViolation::NONE, without_limits.checkTrajectory(states));
+
+  ASSERT_EQ(TrajectoryViolation::NONE, checker.checkTrajectory(nullptr, 0, &first_violation));
+  ASSERT_EQ(0, first_violation);
+
+  std::ostringstream os;
+  os << (TrajectoryViolation::SPEED_ABOVE_MAX | TrajectoryViolation::YAW_RATE_ABOVE_MAX) << " " << TrajectoryViolation::NONE;
+  ASSERT_EQ("SPEED_ABOVE_MAX|YAW_RATE_ABOVE_MAX NONE", os.str());
+}
+
+/**
+ * Tests checking batches of trajectories
+ */
+TEST(TrajectoryChecker, checkTrajectories)
+{
+  TrajectoryChecker checker(buildParamServer(true));
+
+  const size_t trajectory_count = 4;
+  const size_t horizon = 11;
+  std::vector<VehicleState> states(trajectory_count * horizon);
+  states[1 * horizon + 10].longitudinal_vel = 12.0;
+  states[3 * horizon].trailer_angle = 1.0;
+
+  std::vector<TrajectoryViolation> results(trajectory_count);
+  ASSERT_EQ(2, checker.checkTrajectories(states.data(), trajectory_count, horizon, results.data()));
+  ASSERT_EQ(TrajectoryViolation::NONE, results[0]);
+  ASSERT_EQ(TrajectoryViolation::SPEED_ABOVE_MAX, results[1]);
+  ASSERT_EQ(TrajectoryViolation::NONE, results[2]);
+  ASSERT_EQ(TrajectoryViolation::TRAILER_ANGLE_ABOVE_MAX, results[3]);
+
+  std::vector<std::vector<VehicleState>> trajectories;
+  for (size_t i = 0; i < trajectory_count; i++) {
+    trajectories.push_back(std::vector<VehicleState>(states.begin() + i * horizon, states.begin() + (i + 1) * horizon));
+  }
+  trajectories[2].resize(3); // Trajectories of the vector overload may differ in length
+
+  std::vector<TrajectoryViolation> vector_results;
+  ASSERT_EQ(2, checker.checkTrajectories(trajectories, vector_results));
+  ASSERT_EQ(results, vector_results);
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2018-2021 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <memory>
+#include <gtest/gtest.h>
+#include "lib_vehicle_model/TrajectoryRange.h"
+#include "TestVehicleModel.h"
+
+/**
+ * Unit tests for TrajectoryRange
+ */
+
+using namespace lib_vehicle_model;
+
+/**
+ * Tests the constructor input checks
+ */
+TEST(TrajectoryRange, constructor)
+{
+  VehicleState vs;
+  std::vector<VehicleControlInput> controls(3);
+
+  ASSERT_THROW(TrajectoryRange(std::shared_ptr<VehicleMotionModel>(), vs, controls, 0.1), std::invalid_argument);
+  ASSERT_THROW(TrajectoryRange(TrajectoryRange::StepFunction(), vs, controls, 0.1), std::invalid_argument);
+  ASSERT_NO_THROW(TrajectoryRange(std::make_shared<TestVehicleModel>(), vs, controls, 0.1));
+}
+
+/**
+ * Tests that states are only computed as the range is iterated and match a full prediction
+ */
+TEST(TrajectoryRange, iterate)
+{
+  auto model = std::make_shared<TestVehicleModel>();
+  VehicleState vs;
+  const double timestep = 0.1;
+
+  std::vector<VehicleControlInput> controls(10);
+  for (size_t i = 0; i < controls.size(); i++) {
+    controls[i].target_velocity = 2.0 + 0.1 * i;
+    controls[i].target_steering_angle = 0.02 * i;
+  }
+
+  // Constructing the range does no work
+  TrajectoryRange range(model, vs, controls, timestep);
+  ASSERT_EQ(10, range.size());
+  ASSERT_EQ(0, model->integrated_steps);
+
+  // Full iteration matches a single prediction
+  TestVehicleModel reference_model;
+  std::vector<VehicleState> expected = reference_model.predict(vs, controls, timestep);
+
+  size_t i = 0;
+  for (const VehicleState& state : range) {
+    ASSERT_NEAR(expected[i].X_pos_global, state.X_pos_global, 0.000001);
+    ASSERT_NEAR(expected[i].Y_pos_global, state.Y_pos_global, 0.000001);
+    ASSERT_NEAR(expected[i].orientation, state.orientation, 0.000001);
+    ASSERT_NEAR(expected[i].longitudinal_vel, state.longitudinal_vel, 0.000001);
+    i++;
+  }
+  ASSERT_EQ(expected.size(), i);
+  ASSERT_EQ(10, model->integrated_steps);
+
+  // Stopping early only integrates the visited states
+  model->integrated_steps = 0;
+  for (auto it = range.begin(); it != range.end(); ++it) {
+    if (it->X_pos_global > expected[2].X_pos_global - 0.000001) {
+      break;
+    }
+  }
+  ASSERT_EQ(3, model->integrated_steps);
+
+  // Post increment returns the previous state
+  auto it = range.begin();
+  auto previous = it++;
+  ASSERT_NEAR(expected[0].X_pos_global, previous->X_pos_global, 0.000001);
+  ASSERT_NEAR(expected[1].X_pos_global, it->X_pos_global, 0.000001);
+
+  // An empty range does no work
+  model->integrated_steps = 0;
+  TrajectoryRange empty(model, vs, std::vector<VehicleControlInput>(), timestep);
+  ASSERT_TRUE(empty.begin() == empty.end());
+  ASSERT_EQ(0, model->integrated_steps);
+}
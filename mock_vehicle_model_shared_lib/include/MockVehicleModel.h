@@ -27,6 +27,9 @@
  * @class MockVehicleModel
  * @brief Example class which implements a mock version of VehicleMotionModel interface to demonstrate library linking 
  * 
+ * Each prediction moves the vehicle 5 m forward, and left by the final steering command, in the body frame of the
+ * initial state. As the displacement rotates with the initial pose the mock is frame invariant.
+ * 
  * NOTE: This class should not be used in real world execution on a vehicle
  */
 class MockVehicleModel: public lib_vehicle_model::VehicleMotionModel
@@ -61,4 +64,13 @@ class MockVehicleModel: public lib_vehicle_model::VehicleMotionModel
 
     std::vector<lib_vehicle_model::VehicleState> predict(const lib_vehicle_model::VehicleState& initial_state,
       const std::vector<lib_vehicle_model::VehicleControlInput>& control_inputs, double timestep) override;
+
+    bool predictInto(const lib_vehicle_model::VehicleState& initial_state,
+      const lib_vehicle_model::VehicleControlInput* control_inputs, size_t count, double timestep, lib_vehicle_model::VehicleState* output) noexcept override;
+
+    bool isRealTimeSafe() const override;
+
+    bool isFrameInvariant() const override;
+
+    std::shared_ptr<lib_vehicle_model::VehicleMotionModel> clone() const override;
 };
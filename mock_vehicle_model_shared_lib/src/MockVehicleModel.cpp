@@ -14,6 +14,7 @@
  * the License.
  */
 
+#include <math.h>
 #include "MockVehicleModel.h"
 
 
@@ -23,6 +24,20 @@ using namespace lib_vehicle_model;
  * Cpp containing the implementation of MockVehicleModel
  */
 
+namespace {
+  // Helper function which moves forward and left in the body frame of the initial state so the mock is frame invariant
+  VehicleState displaced(const VehicleState& initial_state, double forward, double left) {
+    const double cos_theta = cos(initial_state.orientation);
+    const double sin_theta = sin(initial_state.orientation);
+
+    VehicleState vs;
+    vs.X_pos_global = initial_state.X_pos_global + forward * cos_theta - left * sin_theta;
+    vs.Y_pos_global = initial_state.Y_pos_global + forward * sin_theta + left * cos_theta;
+    vs.orientation = initial_state.orientation;
+    return vs;
+  }
+}
+
 MockVehicleModel::MockVehicleModel() {};
 
 MockVehicleModel::~MockVehicleModel() {};
@@ -34,8 +49,7 @@ void MockVehicleModel::setParameterServer(std::shared_ptr<ParameterServer> param
 
 std::vector<VehicleState> MockVehicleModel::predict(const VehicleState& initial_state,
   double timestep, double delta_t) {
-    VehicleState vs;
-    vs.X_pos_global = initial_state.X_pos_global + 5;// Update x pos to confirm data was processed
+    VehicleState vs = displaced(initial_state, 5, 0);// Move 5 m forward to confirm data was processed
     std::vector<VehicleState> states;
     states.push_back(vs);
     return states;
@@ -44,9 +58,35 @@ std::vector<VehicleState> MockVehicleModel::predict(const VehicleState& initial_
 std::vector<VehicleState> MockVehicleModel::predict(const VehicleState& initial_state,
   const std::vector<VehicleControlInput>& control_inputs, double timestep) {
 
-    VehicleState vs;
-    vs.X_pos_global = initial_state.X_pos_global + 5;// Update x pos to confirm data was processed
+    // Move 5 m forward to confirm data was processed
+    // Let the final control input shape the end state so different control sequences can be told apart
+    const double left = control_inputs.empty() ? 0 : control_inputs.back().target_steering_angle;
+    VehicleState vs = displaced(initial_state, 5, left);
+    if (!control_inputs.empty()) {
+      vs.longitudinal_vel = control_inputs.back().target_velocity;
+    }
     std::vector<VehicleState> states;
     states.push_back(vs);
     return states;
   }
+
+bool MockVehicleModel::predictInto(const VehicleState& initial_state,
+  const VehicleControlInput* control_inputs, size_t count, double timestep, VehicleState* output) noexcept {
+
+    for (size_t i = 0; i < count; i++) {
+      output[i] = displaced(initial_state, 5 * (i + 1), 0);// Move 5 m forward each step to confirm data was processed
+    }
+    return true;
+  }
+
+bool MockVehicleModel::isRealTimeSafe() const {
+  return true;
+}
+
+bool MockVehicleModel::isFrameInvariant() const {
+  return true;
+}
+
+std::shared_ptr<VehicleMotionModel> MockVehicleModel::clone() const {
+  return std::make_shared<MockVehicleModel>(*this);
+}
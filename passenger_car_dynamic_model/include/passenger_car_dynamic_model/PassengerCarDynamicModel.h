@@ -21,8 +21,10 @@
 #include <stdexcept>
 #include <lib_vehicle_model/ODESolver.h>
 #include <lib_vehicle_model/VehicleState.h>
+#include <lib_vehicle_model/ReducedVehicleState.h>
 #include <lib_vehicle_model/VehicleMotionModel.h>
 #include <lib_vehicle_model/VehicleControlInput.h>
+#include <lib_vehicle_model/TimedControlInput.h>
 #include <lib_vehicle_model/ParameterServer.h>
  
 /**
@@ -40,11 +42,19 @@ class PassengerCarDynamicModel: public lib_vehicle_model::VehicleMotionModel
 
     const size_t ODE_STATE_SIZE = 9; // Number of elements of VehicleState that are accounted for in this model
     const size_t FULL_STATE_SIZE = 12; // Total number of elements in a CARMA VehicleState 
+    const size_t REDUCED_STATE_SIZE = 4; // Number of leading elements of VehicleState stored in a ReducedVehicleState
 
     // Handles to callback functions
     lib_vehicle_model::ODESolver::ODEFunction<lib_vehicle_model::VehicleControlInput, double> ode_func_;
     lib_vehicle_model::ODESolver::PostStepFunction<lib_vehicle_model::VehicleControlInput, double> post_step_func_;
+    lib_vehicle_model::ODESolver::PostStepFunction<lib_vehicle_model::VehicleControlInput, double> reduced_post_step_func_;
     
+    // Buffers used by predictInto so real-time predictions do not allocate memory. Sized by reserveRealTime
+    lib_vehicle_model::ODESolver::State rt_state_;
+    lib_vehicle_model::ODESolver::State rt_prev_output_;
+    lib_vehicle_model::ODESolver::State rt_output_;
+    lib_vehicle_model::ODESolver::RK4Workspace rt_workspace_;
+
     // Parameter server used to load vehicle parameters
     std::shared_ptr<lib_vehicle_model::ParameterServer> param_server_;
     
@@ -84,6 +94,20 @@ class PassengerCarDynamicModel: public lib_vehicle_model::VehicleMotionModel
       lib_vehicle_model::ODESolver::State& output
     ) const;
 
+    /*
+     * @brief Post step function used when only a ReducedVehicleState is requested
+     * 
+     * This function matches the ODESolver::PostStepFunction definition.
+     * Only the elements needed for a ReducedVehicleState are copied to the output
+     */ 
+    void ReducedODEPostStep(const lib_vehicle_model::ODESolver::State& current,
+      const lib_vehicle_model::VehicleControlInput& control,
+      double& prev_time,
+      double t,
+      const lib_vehicle_model::ODESolver::State& initial_state,
+      lib_vehicle_model::ODESolver::State& output
+    ) const;
+
     /**
      * @brief Helper function defines the transfer function which converts new velocity commands into front wheel rotation rate rates of change
      * 
@@ -111,6 +135,21 @@ class PassengerCarDynamicModel: public lib_vehicle_model::VehicleMotionModel
     double funcD_f(const double d_f, const double d_fc) const;
     
 
+    /**
+     * @brief Integrates count steps writing the traversed states into output using the preallocated real-time buffers
+     * 
+     * No memory is allocated if reserveRealTime has been called.
+     * Only every output_stride-th state and the final state are converted into output, which must hold
+     * ceil(count / output_stride) states.
+     * 
+     * @tparam ControlSequence Callable taking a step index and returning the control input applied during that step.
+     *                         It is called once per step with increasing indices
+     */
+    template<typename ControlSequence>
+    void integrateInto(const lib_vehicle_model::VehicleState& initial_state,
+      ControlSequence control_for_step, size_t count, double timestep, lib_vehicle_model::VehicleState* output,
+      size_t output_stride = 1);
+
   public:
 
     /**
@@ -119,6 +158,14 @@ class PassengerCarDynamicModel: public lib_vehicle_model::VehicleMotionModel
      */ 
     PassengerCarDynamicModel();
 
+    /**
+     * @brief Copy constructor
+     * 
+     * Copies the loaded parameters and binds the callback functions to the new instance
+     * 
+     */ 
+    PassengerCarDynamicModel(const PassengerCarDynamicModel& other);
+
     /**
      * @brief Destructor as required by interface
      * 
@@ -139,4 +186,43 @@ class PassengerCarDynamicModel: public lib_vehicle_model::VehicleMotionModel
 
     std::vector<lib_vehicle_model::VehicleState> predict(const lib_vehicle_model::VehicleState& initial_state,
       const std::vector<lib_vehicle_model::VehicleControlInput>& control_inputs, double timestep) override;
+
+    std::vector<lib_vehicle_model::VehicleState> predict(const lib_vehicle_model::VehicleState& initial_state,
+      double timestep, double delta_t, size_t output_stride) override;
+
+    std::vector<lib_vehicle_model::VehicleState> predict(const lib_vehicle_model::VehicleState& initial_state,
+      const std::vector<lib_vehicle_model::VehicleControlInput>& control_inputs, double timestep, size_t output_stride) override;
+
+    std::vector<lib_vehicle_model::VehicleState> predict(const lib_vehicle_model::VehicleState& initial_state,
+      const std::vector<lib_vehicle_model::TimedControlInput>& control_changes, double timestep, double delta_t) override;
+
+    std::vector<lib_vehicle_model::VehicleState> predict(const lib_vehicle_model::VehicleState& initial_state,
+      const std::vector<lib_vehicle_model::TimedControlInput>& control_changes, double timestep, double delta_t, size_t output_stride) override;
+
+    std::vector<lib_vehicle_model::ReducedVehicleState> predictReduced(const lib_vehicle_model::VehicleState& initial_state,
+      double timestep, double delta_t) override;
+
+    std::vector<lib_vehicle_model::ReducedVehicleState> predictReduced(const lib_vehicle_model::VehicleState& initial_state,
+      const std::vector<lib_vehicle_model::VehicleControlInput>& control_inputs, double timestep) override;
+
+    /**
+     * Integrates using buffers sized by reserveRealTime so no memory is allocated.
+     * If reserveRealTime has not been called the buffers are sized by the first call
+     */
+    bool predictInto(const lib_vehicle_model::VehicleState& initial_state,
+      const lib_vehicle_model::VehicleControlInput* control_inputs, size_t count, double timestep, lib_vehicle_model::VehicleState* output) noexcept override;
+
+    /**
+     * Integrates a single RK4 step using the same buffers as predictInto so no result vectors are created
+     */
+    lib_vehicle_model::VehicleState predictStep(const lib_vehicle_model::VehicleState& initial_state,
+      const lib_vehicle_model::VehicleControlInput& control_input, double timestep) override;
+
+    void reserveRealTime(size_t max_horizon) override;
+
+    bool isRealTimeSafe() const override;
+
+    bool isFrameInvariant() const override;
+
+    std::shared_ptr<lib_vehicle_model::VehicleMotionModel> clone() const override;
 };
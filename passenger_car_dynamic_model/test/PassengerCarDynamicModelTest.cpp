@@ -14,6 +14,9 @@
  * the License.
  */
 
+#include <new>
+#include <atomic>
+#include <cstdlib>
 #include <memory>
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -25,6 +28,9 @@
 #include "lib_vehicle_model/ParameterServer.h"
 #include "lib_vehicle_model/LibVehicleModel.h"
 #include "lib_vehicle_model/ODESolver.h"
+#include "lib_vehicle_model/Tracing.h"
+#include "lib_vehicle_model/FrameInvariantPredictor.h"
+#include "lib_vehicle_model/ResumableTrajectory.h"
 #include "passenger_car_dynamic_model/PassengerCarDynamicModel.h"
 
 
@@ -39,6 +45,27 @@ using ::testing::Invoke;
 using ::testing::Return;
 using ::testing::Unused;
 
+/**
+ * Replacements of the global allocation functions which count every allocation made by the test process.
+ * Used to check that real-time predictions do not allocate memory
+ */
+namespace {
+  std::atomic<uint64_t> allocation_count_(0);
+}
+
+void* operator new(std::size_t size) {
+  allocation_count_++;
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
 class MockParamServer : public lib_vehicle_model::ParameterServer {
   public:
     MOCK_METHOD2(getParam, bool(const std::string& param_key, std::string& output));
@@ -245,3 +272,483 @@ TEST(lib_vehicle_model, predict_with_control)
 {
 
 }
+
+/**
+ * Helper function which loads a valid set of parameters into the provided model
+ */ 
+void loadValidParameters(PassengerCarDynamicModel& pcm, std::shared_ptr<MockParamServer> mock_param_server)
+{
+  EXPECT_CALL(*mock_param_server, getParam("length_to_f", A<double&>())).WillRepeatedly(DoAll(set_double(2.4384), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("length_to_r", A<double&>())).WillRepeatedly(DoAll(set_double(2.4384), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("effective_wheel_radius_f", A<double&>())).WillRepeatedly(DoAll(set_double(0.3048), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("effective_wheel_radius_r", A<double&>())).WillRepeatedly(DoAll(set_double(0.3048), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("tire_longitudinal_stiffness", A<double&>())).WillRepeatedly(DoAll(set_double(14166.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("tire_cornering_stiffness", A<double&>())).WillRepeatedly(DoAll(set_double(51560.0), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("moment_of_inertia", A<double&>())).WillRepeatedly(DoAll(set_double(2943.35411328), Return(true)));
+  EXPECT_CALL(*mock_param_server, getParam("vehicle_mass", A<double&>())).WillRepeatedly(DoAll(set_double(1302), Return(true)));
+
+  ASSERT_NO_THROW(pcm.setParameterServer(mock_param_server));
+}
+
+/**
+ * Tests that the predictReduced functions of the PassengerCarDynamicModel match the full predict functions
+ */ 
+TEST(PassengerCarDynamicModel, predictReduced)
+{
+  auto mock_param_server = std::make_shared<MockParamServer>();
+  PassengerCarDynamicModel pcm;
+  loadValidParameters(pcm, mock_param_server);
+
+  lib_vehicle_model::VehicleState vs;
+  vs.longitudinal_vel = 5;
+  vs.front_wheel_rotation_rate = 6 / 0.3048;
+  vs.rear_wheel_rotation_rate = vs.front_wheel_rotation_rate;
+  vs.steering_angle = 0.05;
+  vs.prev_vel_cmd = 6;
+
+  std::vector<lib_vehicle_model::VehicleControlInput> controls(10);
+  for (size_t i = 0; i < controls.size(); i++) {
+    controls[i].target_velocity = 6;
+    controls[i].target_steering_angle = 0.05;
+  }
+
+  std::vector<lib_vehicle_model::VehicleState> full = pcm.predict(vs, controls, 0.1);
+  std::vector<lib_vehicle_model::ReducedVehicleState> reduced = pcm.predictReduced(vs, controls, 0.1);
+
+  ASSERT_EQ(full.size(), reduced.size());
+  for (size_t i = 0; i < full.size(); i++) {
+    ASSERT_NEAR(full[i].X_pos_global, reduced[i].X_pos_global, 0.0000001);
+    ASSERT_NEAR(full[i].Y_pos_global, reduced[i].Y_pos_global, 0.0000001);
+    ASSERT_NEAR(full[i].orientation, reduced[i].orientation, 0.0000001);
+    ASSERT_NEAR(full[i].longitudinal_vel, reduced[i].longitudinal_vel, 0.0000001);
+  }
+
+  full = pcm.predict(vs, 0.1, 0.5);
+  reduced = pcm.predictReduced(vs, 0.1, 0.5);
+
+  ASSERT_EQ(5, reduced.size());
+  for (size_t i = 0; i < full.size(); i++) {
+    ASSERT_NEAR(full[i].X_pos_global, reduced[i].X_pos_global, 0.0000001);
+    ASSERT_NEAR(full[i].longitudinal_vel, reduced[i].longitudinal_vel, 0.0000001);
+  }
+}
+
+/**
+ * Tests that the output_stride predict functions of the PassengerCarDynamicModel return the matching subset of the full prediction
+ */ 
+TEST(PassengerCarDynamicModel, predictOutputStride)
+{
+  auto mock_param_server = std::make_shared<MockParamServer>();
+  PassengerCarDynamicModel pcm;
+  loadValidParameters(pcm, mock_param_server);
+
+  lib_vehicle_model::VehicleState vs;
+  vs.longitudinal_vel = 5;
+  vs.front_wheel_rotation_rate = 6 / 0.3048;
+  vs.rear_wheel_rotation_rate = vs.front_wheel_rotation_rate;
+  vs.steering_angle = 0.05;
+  vs.prev_vel_cmd = 6;
+
+  std::vector<lib_vehicle_model::VehicleControlInput> controls(10);
+  for (size_t i = 0; i < controls.size(); i++) {
+    controls[i].target_velocity = 6;
+    controls[i].target_steering_angle = 0.05 + 0.01 * i;
+  }
+
+  std::vector<lib_vehicle_model::VehicleState> full = pcm.predict(vs, controls, 0.1);
+  std::vector<lib_vehicle_model::VehicleState> strided = pcm.predict(vs, controls, 0.1, 3);
+
+  // Steps 3, 6 and 9 are kept by the stride and step 10 is kept as the final state
+  std::vector<size_t> expected_indices = {2, 5, 8, 9};
+  ASSERT_EQ(expected_indices.size(), strided.size());
+  for (size_t i = 0; i < expected_indices.size(); i++) {
+    const lib_vehicle_model::VehicleState& expected = full[expected_indices[i]];
+    ASSERT_NEAR(expected.X_pos_global, strided[i].X_pos_global, 0.0000001);
+    ASSERT_NEAR(expected.Y_pos_global, strided[i].Y_pos_global, 0.0000001);
+    ASSERT_NEAR(expected.orientation, strided[i].orientation, 0.0000001);
+    ASSERT_NEAR(expected.longitudinal_vel, strided[i].longitudinal_vel, 0.0000001);
+    ASSERT_NEAR(expected.steering_angle, strided[i].steering_angle, 0.0000001);
+    ASSERT_NEAR(expected.prev_steering_cmd, strided[i].prev_steering_cmd, 0.0000001);
+  }
+
+  // A stride of 1 returns the full prediction
+  ASSERT_EQ(full.size(), pcm.predict(vs, controls, 0.1, 1).size());
+
+  // No control version
+  full = pcm.predict(vs, 0.1, 1.0);
+  strided = pcm.predict(vs, 0.1, 1.0, 5);
+  ASSERT_EQ(2, strided.size());
+  ASSERT_NEAR(full[4].X_pos_global, strided[0].X_pos_global, 0.0000001);
+  ASSERT_NEAR(full.back().X_pos_global, strided[1].X_pos_global, 0.0000001);
+}
+
+/**
+ * Tests that chaining the predictStep function of the PassengerCarDynamicModel reproduces the full prediction
+ */ 
+TEST(PassengerCarDynamicModel, predictStep)
+{
+  auto mock_param_server = std::make_shared<MockParamServer>();
+  PassengerCarDynamicModel pcm;
+  loadValidParameters(pcm, mock_param_server);
+
+  lib_vehicle_model::VehicleState vs;
+  vs.longitudinal_vel = 5;
+  vs.front_wheel_rotation_rate = 6 / 0.3048;
+  vs.rear_wheel_rotation_rate = vs.front_wheel_rotation_rate;
+  vs.steering_angle = 0.05;
+  vs.prev_vel_cmd = 6;
+
+  std::vector<lib_vehicle_model::VehicleControlInput> controls(10);
+  for (size_t i = 0; i < controls.size(); i++) {
+    controls[i].target_velocity = 6;
+    controls[i].target_steering_angle = 0.05 + 0.01 * i;
+  }
+
+  std::vector<lib_vehicle_model::VehicleState> full = pcm.predict(vs, controls, 0.1);
+
+  lib_vehicle_model::VehicleState state = vs;
+  for (size_t i = 0; i < controls.size(); i++) {
+    state = pcm.predictStep(state, controls[i], 0.1);
+    ASSERT_NEAR(full[i].X_pos_global, state.X_pos_global, 0.0000001);
+    ASSERT_NEAR(full[i].Y_pos_global, state.Y_pos_global, 0.0000001);
+    ASSERT_NEAR(full[i].orientation, state.orientation, 0.0000001);
+    ASSERT_NEAR(full[i].longitudinal_vel, state.longitudinal_vel, 0.0000001);
+    ASSERT_NEAR(full[i].steering_angle, state.steering_angle, 0.0000001);
+  }
+
+  // Steps reuse the integration buffers so no memory is allocated once they are sized
+  const uint64_t allocations = allocation_count_.load();
+  for (size_t i = 0; i < controls.size(); i++) {
+    state = pcm.predictStep(state, controls[i], 0.1);
+  }
+  ASSERT_EQ(allocations, allocation_count_.load());
+}
+
+/**
+ * Tests that a clone of the PassengerCarDynamicModel is independent of the original and produces identical predictions
+ */ 
+TEST(PassengerCarDynamicModel, clone)
+{
+  auto mock_param_server = std::make_shared<MockParamServer>();
+  std::unique_ptr<PassengerCarDynamicModel> pcm(new PassengerCarDynamicModel());
+  loadValidParameters(*pcm, mock_param_server);
+
+  lib_vehicle_model::VehicleState vs;
+  vs.longitudinal_vel = 5;
+  vs.front_wheel_rotation_rate = 6 / 0.3048;
+  vs.rear_wheel_rotation_rate = vs.front_wheel_rotation_rate;
+  vs.steering_angle = 0.05;
+  vs.prev_vel_cmd = 6;
+
+  std::vector<lib_vehicle_model::VehicleControlInput> controls(10);
+  for (size_t i = 0; i < controls.size(); i++) {
+    controls[i].target_velocity = 6;
+    controls[i].target_steering_angle = 0.05 + 0.01 * i;
+  }
+
+  std::vector<lib_vehicle_model::VehicleState> expected = pcm->predict(vs, controls, 0.1);
+
+  std::shared_ptr<lib_vehicle_model::VehicleMotionModel> clone = pcm->clone();
+  ASSERT_TRUE(clone != nullptr);
+  ASSERT_FALSE(clone->isStateless());
+
+  // The clone must not depend on the original instance
+  pcm.reset();
+
+  std::vector<lib_vehicle_model::VehicleState> result = clone->predict(vs, controls, 0.1);
+  ASSERT_EQ(expected.size(), result.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    ASSERT_NEAR(expected[i].X_pos_global, result[i].X_pos_global, 0.0000001);
+    ASSERT_NEAR(expected[i].Y_pos_global, result[i].Y_pos_global, 0.0000001);
+    ASSERT_NEAR(expected[i].orientation, result[i].orientation, 0.0000001);
+    ASSERT_NEAR(expected[i].longitudinal_vel, result[i].longitudinal_vel, 0.0000001);
+    ASSERT_NEAR(expected[i].yaw_rate, result[i].yaw_rate, 0.0000001);
+  }
+}
+
+/**
+ * Tests that the PassengerCarDynamicModel records integration and conversion spans when tracing is enabled
+ */ 
+TEST(PassengerCarDynamicModel, tracing)
+{
+  auto mock_param_server = std::make_shared<MockParamServer>();
+  PassengerCarDynamicModel pcm;
+  loadValidParameters(pcm, mock_param_server);
+
+  lib_vehicle_model::VehicleState vs;
+  vs.longitudinal_vel = 5;
+  vs.front_wheel_rotation_rate = 5 / 0.3048;
+  vs.rear_wheel_rotation_rate = vs.front_wheel_rotation_rate;
+  vs.prev_vel_cmd = 5;
+
+  lib_vehicle_model::tracing::enable(64);
+  lib_vehicle_model::tracing::clear();
+  pcm.predict(vs, 0.1, 1.0);
+  pcm.predictReduced(vs, 0.1, 1.0);
+  lib_vehicle_model::tracing::disable();
+
+  std::ostringstream trace;
+  ASSERT_EQ(4, lib_vehicle_model::tracing::writeChromeTrace(trace));
+  ASSERT_NE(std::string::npos, trace.str().find("\"name\":\"integrate\",\"cat\":\"passenger_car_dynamic_model\""));
+  ASSERT_NE(std::string::npos, trace.str().find("\"name\":\"convert\",\"cat\":\"passenger_car_dynamic_model\""));
+  lib_vehicle_model::tracing::clear();
+}
+
+/**
+ * Tests that predictInto of the PassengerCarDynamicModel matches predict and does not allocate memory once reserved
+ */ 
+TEST(PassengerCarDynamicModel, predictInto)
+{
+  auto mock_param_server = std::make_shared<MockParamServer>();
+  PassengerCarDynamicModel pcm;
+  loadValidParameters(pcm, mock_param_server);
+
+  ASSERT_TRUE(pcm.isRealTimeSafe());
+
+  lib_vehicle_model::VehicleState vs;
+  vs.longitudinal_vel = 5;
+  vs.front_wheel_rotation_rate = 6 / 0.3048;
+  vs.rear_wheel_rotation_rate = vs.front_wheel_rotation_rate;
+  vs.steering_angle = 0.05;
+  vs.prev_vel_cmd = 6;
+
+  std::vector<lib_vehicle_model::VehicleControlInput> controls(50);
+  for (size_t i = 0; i < controls.size(); i++) {
+    controls[i].target_velocity = 6;
+    controls[i].target_steering_angle = 0.05 + 0.001 * i;
+  }
+
+  std::vector<lib_vehicle_model::VehicleState> full = pcm.predict(vs, controls, 0.1);
+  std::vector<lib_vehicle_model::VehicleState> output(controls.size());
+
+  pcm.reserveRealTime(controls.size());
+
+  // No memory is allocated by a reserved model
+  const uint64_t allocations = allocation_count_.load();
+  bool success = true;
+  for (size_t i = 0; i < 10; i++) {
+    success = pcm.predictInto(vs, controls.data(), controls.size(), 0.1, output.data()) && success;
+  }
+  ASSERT_EQ(allocations, allocation_count_.load());
+  ASSERT_TRUE(success);
+
+  // The results match the list based prediction
+  for (size_t i = 0; i < controls.size(); i++) {
+    ASSERT_NEAR(full[i].X_pos_global, output[i].X_pos_global, 0.0000001);
+    ASSERT_NEAR(full[i].Y_pos_global, output[i].Y_pos_global, 0.0000001);
+    ASSERT_NEAR(full[i].orientation, output[i].orientation, 0.0000001);
+    ASSERT_NEAR(full[i].longitudinal_vel, output[i].longitudinal_vel, 0.0000001);
+    ASSERT_NEAR(full[i].lateral_vel, output[i].lateral_vel, 0.0000001);
+    ASSERT_NEAR(full[i].yaw_rate, output[i].yaw_rate, 0.0000001);
+    ASSERT_NEAR(full[i].front_wheel_rotation_rate, output[i].front_wheel_rotation_rate, 0.0000001);
+    ASSERT_NEAR(full[i].rear_wheel_rotation_rate, output[i].rear_wheel_rotation_rate, 0.0000001);
+    ASSERT_NEAR(full[i].steering_angle, output[i].steering_angle, 0.0000001);
+    ASSERT_NEAR(full[i].prev_steering_cmd, output[i].prev_steering_cmd, 0.0000001);
+    ASSERT_NEAR(full[i].prev_vel_cmd, output[i].prev_vel_cmd, 0.0000001);
+  }
+
+  // Invalid arguments are reported without throwing
+  ASSERT_FALSE(pcm.predictInto(vs, controls.data(), 0, 0.1, output.data()));
+  ASSERT_FALSE(pcm.predictInto(vs, controls.data(), controls.size(), 0.1, nullptr));
+}
+
+/**
+ * Tests that a prediction from control change points matches the prediction with one control input per step
+ */
+TEST(PassengerCarDynamicModel, predictControlChanges)
+{
+  auto mock_param_server = std::make_shared<MockParamServer>();
+  PassengerCarDynamicModel pcm;
+  loadValidParameters(pcm, mock_param_server);
+
+  lib_vehicle_model::VehicleState vs;
+  vs.longitudinal_vel = 5;
+  vs.front_wheel_rotation_rate = 5 / 0.3048;
+  vs.rear_wheel_rotation_rate = vs.front_wheel_rotation_rate;
+  vs.prev_vel_cmd = 5;
+
+  // 3 distinct commands over 8 s
+  std::vector<lib_vehicle_model::TimedControlInput> changes(3);
+  changes[0].time = 0.0;
+  changes[0].control.target_velocity = 6;
+  changes[1].time = 2.0;
+  changes[1].control.target_velocity = 6;
+  changes[1].control.target_steering_angle = 0.05;
+  changes[2].time = 5.05; // Between steps so applies from the step starting at 5.1 s
+  changes[2].control.target_velocity = 4;
+
+  std::vector<lib_vehicle_model::VehicleControlInput> controls(80);
+  for (size_t i = 0; i < controls.size(); i++) {
+    controls[i] = i < 20 ? changes[0].control : (i < 51 ? changes[1].control : changes[2].control);
+  }
+
+  std::vector<lib_vehicle_model::VehicleState> full = pcm.predict(vs, controls, 0.1);
+  std::vector<lib_vehicle_model::VehicleState> timed = pcm.predict(vs, changes, 0.1, 8.0);
+
+  ASSERT_EQ(full.size(), timed.size());
+  for (size_t i = 0; i < full.size(); i++) {
+    ASSERT_NEAR(full[i].X_pos_global, timed[i].X_pos_global, 0.0000001);
+    ASSERT_NEAR(full[i].Y_pos_global, timed[i].Y_pos_global, 0.0000001);
+    ASSERT_NEAR(full[i].orientation, timed[i].orientation, 0.0000001);
+    ASSERT_NEAR(full[i].longitudinal_vel, timed[i].longitudinal_vel, 0.0000001);
+    ASSERT_NEAR(full[i].steering_angle, timed[i].steering_angle, 0.0000001);
+    ASSERT_NEAR(full[i].prev_steering_cmd, timed[i].prev_steering_cmd, 0.0000001);
+    ASSERT_NEAR(full[i].prev_vel_cmd, timed[i].prev_vel_cmd, 0.0000001);
+  }
+
+  // Steps before the first change point use the previous commands of the initial state
+  changes[0].time = 1.0;
+  for (size_t i = 0; i < 10; i++) {
+    controls[i].target_velocity = 5;
+  }
+  full = pcm.predict(vs, controls, 0.1);
+  timed = pcm.predict(vs, changes, 0.1, 8.0);
+  ASSERT_NEAR(full.back().X_pos_global, timed.back().X_pos_global, 0.0000001);
+  ASSERT_NEAR(full.back().Y_pos_global, timed.back().Y_pos_global, 0.0000001);
+}
+
+/**
+ * Tests that the output_stride change point predict function of the PassengerCarDynamicModel returns the matching subset of the full prediction
+ */
+TEST(PassengerCarDynamicModel, predictControlChangesStride)
+{
+  auto mock_param_server = std::make_shared<MockParamServer>();
+  PassengerCarDynamicModel pcm;
+  loadValidParameters(pcm, mock_param_server);
+
+  lib_vehicle_model::VehicleState vs;
+  vs.longitudinal_vel = 5;
+  vs.front_wheel_rotation_rate = 5 / 0.3048;
+  vs.rear_wheel_rotation_rate = vs.front_wheel_rotation_rate;
+  vs.prev_vel_cmd = 5;
+
+  // 5 distinct commands over 8 s
+  std::vector<lib_vehicle_model::TimedControlInput> changes(5);
+  for (size_t i = 0; i < changes.size(); i++) {
+    changes[i].time = 1.6 * i;
+    changes[i].control.target_velocity = 4 + (i % 2) * 2;
+    changes[i].control.target_steering_angle = 0.02 * i;
+  }
+
+  std::vector<lib_vehicle_model::VehicleState> full = pcm.predict(vs, changes, 0.1, 8.0);
+  ASSERT_EQ(80, full.size());
+
+  // One state per second rather than one per timestep
+  std::vector<lib_vehicle_model::VehicleState> strided = pcm.predict(vs, changes, 0.1, 8.0, 10);
+  ASSERT_EQ(8, strided.size());
+  for (size_t i = 0; i < strided.size(); i++) {
+    const lib_vehicle_model::VehicleState& expected = full[(i + 1) * 10 - 1];
+    ASSERT_NEAR(expected.X_pos_global, strided[i].X_pos_global, 0.0000001);
+    ASSERT_NEAR(expected.Y_pos_global, strided[i].Y_pos_global, 0.0000001);
+    ASSERT_NEAR(expected.orientation, strided[i].orientation, 0.0000001);
+    ASSERT_NEAR(expected.longitudinal_vel, strided[i].longitudinal_vel, 0.0000001);
+    ASSERT_NEAR(expected.prev_steering_cmd, strided[i].prev_steering_cmd, 0.0000001);
+    ASSERT_NEAR(expected.prev_vel_cmd, strided[i].prev_vel_cmd, 0.0000001);
+  }
+
+  // A stride which does not divide the horizon still returns the final state
+  strided = pcm.predict(vs, changes, 0.1, 8.0, 3);
+  ASSERT_EQ(27, strided.size());
+  for (size_t i = 0; i + 1 < strided.size(); i++) {
+    ASSERT_NEAR(full[(i + 1) * 3 - 1].X_pos_global, strided[i].X_pos_global, 0.0000001);
+    ASSERT_NEAR(full[(i + 1) * 3 - 1].Y_pos_global, strided[i].Y_pos_global, 0.0000001);
+  }
+  ASSERT_NEAR(full.back().X_pos_global, strided.back().X_pos_global, 0.0000001);
+  ASSERT_NEAR(full.back().Y_pos_global, strided.back().Y_pos_global, 0.0000001);
+
+  // A stride of 0 is treated as 1
+  ASSERT_EQ(full.size(), pcm.predict(vs, changes, 0.1, 8.0, 0).size());
+}
+
+/**
+ * Tests that integrating in the canonical frame and transforming the output matches a prediction in the global frame
+ */
+TEST(PassengerCarDynamicModel, frameInvariantPredict)
+{
+  auto mock_param_server = std::make_shared<MockParamServer>();
+  std::shared_ptr<PassengerCarDynamicModel> pcm = std::make_shared<PassengerCarDynamicModel>();
+  loadValidParameters(*pcm, mock_param_server);
+
+  ASSERT_TRUE(pcm->isFrameInvariant());
+
+  lib_vehicle_model::VehicleState vs;
+  vs.X_pos_global = 250.0;
+  vs.Y_pos_global = -75.0;
+  vs.orientation = 2.5;
+  vs.longitudinal_vel = 5;
+  vs.front_wheel_rotation_rate = 6 / 0.3048;
+  vs.rear_wheel_rotation_rate = vs.front_wheel_rotation_rate;
+  vs.steering_angle = 0.05;
+  vs.prev_vel_cmd = 6;
+
+  std::vector<lib_vehicle_model::VehicleControlInput> controls(30);
+  for (size_t i = 0; i < controls.size(); i++) {
+    controls[i].target_velocity = 6;
+    controls[i].target_steering_angle = 0.05 + 0.005 * i;
+  }
+
+  std::vector<lib_vehicle_model::VehicleState> expected = pcm->predict(vs, controls, 0.1);
+
+  lib_vehicle_model::FrameInvariantPredictor predictor(pcm, 4);
+  std::vector<lib_vehicle_model::VehicleState> result = predictor.predict(vs, controls, 0.1);
+
+  ASSERT_EQ(expected.size(), result.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    ASSERT_NEAR(expected[i].X_pos_global, result[i].X_pos_global, 0.000001);
+    ASSERT_NEAR(expected[i].Y_pos_global, result[i].Y_pos_global, 0.000001);
+    ASSERT_NEAR(expected[i].orientation, result[i].orientation, 0.000001);
+    ASSERT_NEAR(expected[i].longitudinal_vel, result[i].longitudinal_vel, 0.000001);
+    ASSERT_NEAR(expected[i].lateral_vel, result[i].lateral_vel, 0.000001);
+    ASSERT_NEAR(expected[i].yaw_rate, result[i].yaw_rate, 0.000001);
+  }
+}
+
+/**
+ * Tests that a ResumableTrajectory built from appended segments matches a single prediction over all control inputs
+ */ 
+TEST(PassengerCarDynamicModel, resumableTrajectory)
+{
+  auto mock_param_server = std::make_shared<MockParamServer>();
+  std::shared_ptr<PassengerCarDynamicModel> pcm = std::make_shared<PassengerCarDynamicModel>();
+  loadValidParameters(*pcm, mock_param_server);
+
+  lib_vehicle_model::VehicleState vs;
+  vs.longitudinal_vel = 5;
+  vs.front_wheel_rotation_rate = 5 / 0.3048;
+  vs.rear_wheel_rotation_rate = vs.front_wheel_rotation_rate;
+  vs.steering_angle = 0.02;
+  vs.prev_vel_cmd = 5;
+
+  std::vector<lib_vehicle_model::VehicleControlInput> controls(40);
+  for (size_t i = 0; i < controls.size(); i++) {
+    controls[i].target_velocity = i < 20 ? 7 : 4;
+    controls[i].target_steering_angle = 0.02 + 0.002 * i;
+  }
+
+  std::vector<lib_vehicle_model::VehicleState> full = pcm->predict(vs, controls, 0.1);
+
+  // Segments of uneven length
+  lib_vehicle_model::ResumableTrajectory trajectory(pcm, vs, 0.1);
+  const size_t segment_ends[] = { 7, 20, 21, 40 };
+  size_t start = 0;
+  for (size_t end : segment_ends) {
+    trajectory.append(std::vector<lib_vehicle_model::VehicleControlInput>(controls.begin() + start, controls.begin() + end));
+    start = end;
+  }
+
+  const std::vector<lib_vehicle_model::VehicleState>& resumed = trajectory.getStates();
+  ASSERT_EQ(full.size(), resumed.size());
+  for (size_t i = 0; i < full.size(); i++) {
+    ASSERT_NEAR(full[i].X_pos_global, resumed[i].X_pos_global, 0.0000001);
+    ASSERT_NEAR(full[i].Y_pos_global, resumed[i].Y_pos_global, 0.0000001);
+    ASSERT_NEAR(full[i].orientation, resumed[i].orientation, 0.0000001);
+    ASSERT_NEAR(full[i].longitudinal_vel, resumed[i].longitudinal_vel, 0.0000001);
+    ASSERT_NEAR(full[i].lateral_vel, resumed[i].lateral_vel, 0.0000001);
+    ASSERT_NEAR(full[i].yaw_rate, resumed[i].yaw_rate, 0.0000001);
+    ASSERT_NEAR(full[i].front_wheel_rotation_rate, resumed[i].front_wheel_rotation_rate, 0.0000001);
+    ASSERT_NEAR(full[i].rear_wheel_rotation_rate, resumed[i].rear_wheel_rotation_rate, 0.0000001);
+    ASSERT_NEAR(full[i].steering_angle, resumed[i].steering_angle, 0.0000001);
+    ASSERT_NEAR(full[i].prev_steering_cmd, resumed[i].prev_steering_cmd, 0.0000001);
+    ASSERT_NEAR(full[i].prev_vel_cmd, resumed[i].prev_vel_cmd, 0.0000001);
+  }
+}
@@ -18,6 +18,7 @@
 #include <math.h>
 #include <sstream>
 #include <functional>
+#include <lib_vehicle_model/Tracing.h>
 #include "passenger_car_kinematic_model/PassengerCarKinematicModel.h"
 
 /**
@@ -30,10 +31,36 @@ PassengerCarKinematicModel::PassengerCarKinematicModel() {
   // Bind the callback functions
   ode_func_ = std::bind(&PassengerCarKinematicModel::KinematicCarODE, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4, std::placeholders::_5);
   post_step_func_ = std::bind(&PassengerCarKinematicModel::ODEPostStep, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4, std::placeholders::_5, std::placeholders::_6);
+  reduced_post_step_func_ = std::bind(&PassengerCarKinematicModel::ReducedODEPostStep, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4, std::placeholders::_5, std::placeholders::_6);
+};
+
+PassengerCarKinematicModel::PassengerCarKinematicModel(const PassengerCarKinematicModel& other) :
+  param_server_(other.param_server_),
+  l_f_(other.l_f_),
+  l_r_(other.l_r_),
+  wheel_base_(other.wheel_base_),
+  ulR_f_(other.ulR_f_),
+  ulR_r_(other.ulR_r_),
+  lR_f_(other.lR_f_),
+  lR_r_(other.lR_r_),
+  R_ef_(other.R_ef_),
+  R_er_(other.R_er_),
+  speed_kP_(other.speed_kP_),
+  acceleration_limit_(other.acceleration_limit_),
+  deceleration_limit_(other.deceleration_limit_),
+  hard_braking_threshold_(other.hard_braking_threshold_) {
+  // Bind the callback functions to this instance rather than the copied one
+  ode_func_ = std::bind(&PassengerCarKinematicModel::KinematicCarODE, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4, std::placeholders::_5);
+  post_step_func_ = std::bind(&PassengerCarKinematicModel::ODEPostStep, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4, std::placeholders::_5, std::placeholders::_6);
+  reduced_post_step_func_ = std::bind(&PassengerCarKinematicModel::ReducedODEPostStep, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4, std::placeholders::_5, std::placeholders::_6);
 };
 
 PassengerCarKinematicModel::~PassengerCarKinematicModel() {};
 
+std::shared_ptr<VehicleMotionModel> PassengerCarKinematicModel::clone() const {
+  return std::make_shared<PassengerCarKinematicModel>(*this);
+}
+
 void PassengerCarKinematicModel::setParameterServer(std::shared_ptr<ParameterServer> parameter_server) {
   param_server_ = parameter_server;
   
@@ -103,15 +130,46 @@ std::vector<VehicleState> PassengerCarKinematicModel::predict(const VehicleState
 
 std::vector<VehicleState> PassengerCarKinematicModel::predict(const VehicleState& initial_state,
   const std::vector<VehicleControlInput>& controls, double timestep) {
+    // Return every integrated state
+    return predict(initial_state, controls, timestep, 1);
+  }
+
+std::vector<VehicleState> PassengerCarKinematicModel::predict(const VehicleState& initial_state,
+  double timestep, double delta_t, size_t output_stride) {
+
+    // Populate control inputs
+    // This predict function takes in no new control inputs so extract the old ones from the state vector
+    VehicleControlInput control_input;
+    control_input.target_steering_angle = initial_state.prev_steering_cmd;
+    control_input.target_velocity = initial_state.prev_vel_cmd;
+
+    // Ensure we run at least 1 step
+    size_t num_steps;
+    if (delta_t <= timestep) {
+      num_steps = 1;
+    } else {
+      num_steps = delta_t / timestep;
+    }
+
+    std::vector<VehicleControlInput> control_inputs(num_steps, control_input);
+
+    // Call default predict method
+    return predict(initial_state, control_inputs, timestep, output_stride);
+  }
+
+std::vector<VehicleState> PassengerCarKinematicModel::predict(const VehicleState& initial_state,
+  const std::vector<VehicleControlInput>& controls, double timestep, size_t output_stride) {
     // Copy control inputs vector to modifieable vector
     std::vector<VehicleControlInput> control_inputs = controls;
+    // Only every output_stride state and the final state are stored
+    const size_t num_outputs = output_stride <= 1 ? control_inputs.size() : control_inputs.size() / output_stride + 1;
     // Construct output vector
     std::vector<VehicleState> resulting_states;
-    resulting_states.reserve(control_inputs.size());
+    resulting_states.reserve(num_outputs);
 
     // Construct ode output vector
     std::vector<std::tuple<double, ODESolver::State>> ode_outputs;
-    ode_outputs.reserve(control_inputs.size());
+    ode_outputs.reserve(num_outputs);
 
     // Populate initial condition
     ODESolver::State state(ODE_STATE_SIZE, 0);
@@ -126,20 +184,25 @@ std::vector<VehicleState> PassengerCarKinematicModel::predict(const VehicleState
     // x,y, theta, v
 
     // Integrate ODE
-    ODESolver::rk4<VehicleControlInput, double>(
-      ode_func_,
-      control_inputs.size(),
-      timestep,
-      state,
-      control_inputs,
-      ode_outputs,
-      post_step_func_,
-      prev_time
-    );
+    {
+      tracing::ScopedSpan span("integrate", "passenger_car_kinematic_model");
+      ODESolver::rk4<VehicleControlInput, double>(
+        ode_func_,
+        control_inputs.size(),
+        timestep,
+        state,
+        control_inputs,
+        ode_outputs,
+        post_step_func_,
+        prev_time,
+        output_stride
+      );
+    }
 
     // Convert result to target output
+    tracing::ScopedSpan convert_span("convert", "passenger_car_kinematic_model");
     for (size_t j = 0; j < ode_outputs.size(); j++) {
-      const ODESolver::State new_state = std::get<1>(ode_outputs[j]);
+      const ODESolver::State& new_state = std::get<1>(ode_outputs[j]);
 
       if (new_state.size() != FULL_STATE_SIZE) {
         throw std::invalid_argument("Too small");
@@ -165,6 +228,217 @@ std::vector<VehicleState> PassengerCarKinematicModel::predict(const VehicleState
     return resulting_states;
   }
 
+std::vector<ReducedVehicleState> PassengerCarKinematicModel::predictReduced(const VehicleState& initial_state,
+  double timestep, double delta_t) {
+
+    // Populate control inputs
+    // This predict function takes in no new control inputs so extract the old ones from the state vector
+    VehicleControlInput control_input;
+    control_input.target_steering_angle = initial_state.prev_steering_cmd;
+    control_input.target_velocity = initial_state.prev_vel_cmd;
+
+    // Ensure we run at least 1 step
+    size_t num_steps;
+    if (delta_t <= timestep) {
+      num_steps = 1;
+    } else {
+      num_steps = delta_t / timestep;
+    }
+
+    std::vector<VehicleControlInput> control_inputs(num_steps, control_input);
+
+    // Call default predictReduced method
+    return predictReduced(initial_state, control_inputs, timestep);
+  }
+
+std::vector<ReducedVehicleState> PassengerCarKinematicModel::predictReduced(const VehicleState& initial_state,
+  const std::vector<VehicleControlInput>& controls, double timestep) {
+    // Copy control inputs vector to modifieable vector
+    std::vector<VehicleControlInput> control_inputs = controls;
+    // Construct output vector
+    std::vector<ReducedVehicleState> resulting_states;
+    resulting_states.reserve(control_inputs.size());
+
+    // Construct ode output vector
+    std::vector<std::tuple<double, ODESolver::State>> ode_outputs;
+    ode_outputs.reserve(control_inputs.size());
+
+    // Populate initial condition
+    ODESolver::State state(ODE_STATE_SIZE, 0);
+    state[0]  = initial_state.X_pos_global;
+    state[1]  = initial_state.Y_pos_global;
+    state[2]  = initial_state.orientation;
+    state[3]  = initial_state.longitudinal_vel;
+
+    double prev_time = 0.0;
+
+    // Integrate ODE
+    // The reduced post step skips computing the fields which are not part of a ReducedVehicleState
+    {
+      tracing::ScopedSpan span("integrate", "passenger_car_kinematic_model");
+      ODESolver::rk4<VehicleControlInput, double>(
+        ode_func_,
+        control_inputs.size(),
+        timestep,
+        state,
+        control_inputs,
+        ode_outputs,
+        reduced_post_step_func_,
+        prev_time
+      );
+    }
+
+    // Convert result to target output
+    tracing::ScopedSpan convert_span("convert", "passenger_car_kinematic_model");
+    for (size_t j = 0; j < ode_outputs.size(); j++) {
+      const ODESolver::State& new_state = std::get<1>(ode_outputs[j]);
+
+      ReducedVehicleState result;
+      result.X_pos_global     = new_state[0];
+      result.Y_pos_global     = new_state[1];
+      result.orientation      = new_state[2];
+      result.longitudinal_vel = new_state[3];
+
+      resulting_states.push_back(result);
+    }
+
+    return resulting_states;
+  }
+
+void PassengerCarKinematicModel::reserveRealTime(size_t max_horizon) {
+  // Outputs are written directly to the caller's buffer so only fixed size integration buffers are needed
+  rt_state_.assign(ODE_STATE_SIZE, 0);
+  rt_workspace_.resize(ODE_STATE_SIZE);
+  rt_prev_output_.reserve(FULL_STATE_SIZE);
+  rt_output_.reserve(FULL_STATE_SIZE);
+}
+
+bool PassengerCarKinematicModel::isRealTimeSafe() const {
+  return true;
+}
+
+bool PassengerCarKinematicModel::isFrameInvariant() const {
+  // The global pose only enters the ODE through the integration of position and orientation
+  return true;
+}
+
+template<typename ControlSequence>
+void PassengerCarKinematicModel::integrateInto(const VehicleState& initial_state,
+  ControlSequence control_for_step, size_t count, double timestep, VehicleState* output, size_t output_stride) {
+
+    if (rt_state_.size() != ODE_STATE_SIZE) {
+      reserveRealTime(count);
+    }
+
+    tracing::ScopedSpan span("integrate", "passenger_car_kinematic_model");
+
+    // Populate initial condition
+    rt_state_[0] = initial_state.X_pos_global;
+    rt_state_[1] = initial_state.Y_pos_global;
+    rt_state_[2] = initial_state.orientation;
+    rt_state_[3] = initial_state.longitudinal_vel;
+
+    // The first post step compares against the initial condition as in ODESolver::rk4
+    rt_prev_output_.assign(rt_state_.begin(), rt_state_.end());
+    double prev_time = 0.0;
+
+    for (size_t i = 0; i < count; i++) {
+      const VehicleControlInput& control = control_for_step(i);
+
+      ODESolver::rk4Step<VehicleControlInput, double>(ode_func_, control, prev_time, rt_state_, i * timestep, timestep, rt_workspace_);
+      ODEPostStep(rt_state_, control, prev_time, (i + 1) * timestep, rt_prev_output_, rt_output_);
+      rt_prev_output_.swap(rt_output_);
+
+      // Only every output_stride step and the final step are converted
+      const size_t step = i + 1;
+      if (output_stride > 1 && step % output_stride != 0 && step != count) {
+        continue;
+      }
+
+      // Save result
+      const ODESolver::State& new_state = rt_prev_output_;
+      VehicleState& result = output[output_stride > 1 ? (step - 1) / output_stride : i];
+      result.X_pos_global              = new_state[0];
+      result.Y_pos_global              = new_state[1];
+      result.orientation               = new_state[2];
+      result.longitudinal_vel          = new_state[3];
+      result.lateral_vel               = new_state[4];
+      result.yaw_rate                  = new_state[5];
+      result.front_wheel_rotation_rate = new_state[6];
+      result.rear_wheel_rotation_rate  = new_state[7];
+      result.steering_angle            = new_state[8];
+      result.trailer_angle             = initial_state.trailer_angle;
+      result.prev_steering_cmd         = new_state[10];
+      result.prev_vel_cmd              = new_state[11];
+    }
+  }
+
+bool PassengerCarKinematicModel::predictInto(const VehicleState& initial_state,
+  const VehicleControlInput* control_inputs, size_t count, double timestep, VehicleState* output) noexcept {
+
+    if (count == 0 || !control_inputs || !output) {
+      return false;
+    }
+
+    // Size the buffers here if reserveRealTime was not called so only this call allocates
+    if (rt_state_.size() != ODE_STATE_SIZE) {
+      try {
+        reserveRealTime(count);
+      } catch (const std::bad_alloc&) {
+        return false;
+      }
+    }
+
+    integrateInto(initial_state, [control_inputs](size_t i) -> const VehicleControlInput& { return control_inputs[i]; }, count, timestep, output);
+
+    return true;
+  }
+
+VehicleState PassengerCarKinematicModel::predictStep(const VehicleState& initial_state,
+  const VehicleControlInput& control_input, double timestep) {
+
+    VehicleState result;
+    integrateInto(initial_state, [&control_input](size_t) -> const VehicleControlInput& { return control_input; }, 1, timestep, &result);
+
+    return result;
+  }
+
+std::vector<VehicleState> PassengerCarKinematicModel::predict(const VehicleState& initial_state,
+  const std::vector<TimedControlInput>& control_changes, double timestep, double delta_t) {
+    // Return every integrated state
+    return predict(initial_state, control_changes, timestep, delta_t, 1);
+  }
+
+std::vector<VehicleState> PassengerCarKinematicModel::predict(const VehicleState& initial_state,
+  const std::vector<TimedControlInput>& control_changes, double timestep, double delta_t, size_t output_stride) {
+
+    // Steps before the first change point use the old commands from the state vector
+    VehicleControlInput initial_control;
+    initial_control.target_steering_angle = initial_state.prev_steering_cmd;
+    initial_control.target_velocity = initial_state.prev_vel_cmd;
+
+    // Ensure we run at least 1 step
+    size_t num_steps;
+    if (delta_t <= timestep) {
+      num_steps = 1;
+    } else {
+      num_steps = delta_t / timestep;
+    }
+
+    // Only every output_stride state and the final state are stored
+    if (output_stride == 0) {
+      output_stride = 1;
+    }
+    std::vector<VehicleState> resulting_states((num_steps + output_stride - 1) / output_stride);
+
+    // Controls are read directly from the change points so they are never expanded into a per step list
+    ControlChangeCursor cursor(control_changes, initial_control, timestep);
+    integrateInto(initial_state, [&cursor](size_t i) -> const VehicleControlInput& { return cursor.controlForStep(i); }, num_steps, timestep,
+      resulting_states.data(), output_stride);
+
+    return resulting_states;
+  }
+
 void PassengerCarKinematicModel::KinematicCarODE(const lib_vehicle_model::ODESolver::State& state,
     const lib_vehicle_model::VehicleControlInput& control,
     double& prev_time,
@@ -236,6 +510,18 @@ void PassengerCarKinematicModel::ODEPostStep(const lib_vehicle_model::ODESolver:
   prev_time = t;
 }
 
+void PassengerCarKinematicModel::ReducedODEPostStep(const ODESolver::State& current,
+    const VehicleControlInput& control,
+    double& prev_time,
+    double t,
+    const ODESolver::State& prev_state,
+    ODESolver::State& output
+  ) const
+{
+  // Copy only the elements stored in a ReducedVehicleState
+  output.assign(current.begin(), current.begin() + REDUCED_STATE_SIZE);
+}
+
 /**
  * Math based on figure 3.35 in R. N. Jazar, "Vehicle dynamics: theory and application" Springer, 2008.
  */ 